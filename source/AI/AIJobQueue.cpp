@@ -0,0 +1,75 @@
+// AIJobQueue.cpp
+#include "AIJobQueue.h"
+#include "../Core/PerfMonitor.h"
+#include <UnigineLog.h>
+#include <algorithm>
+
+bool AIJob::isReady() const {
+    return result.valid() && result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+AIJobQueue::AIJobQueue(JobSystem* job_system)
+    : jobs(job_system)
+    , system_id(job_system->getSystemId("AI"))
+{
+    Unigine::Log::message("AIJobQueue::AIJobQueue() - Planning on %d job workers\n", jobs->getWorkerCount());
+}
+
+AIJobQueue::~AIJobQueue() {
+    cancelAll();
+
+    // Tasks capture this queue: every one must have finished before it goes away
+    std::vector<AIJobPtr> remaining;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining = outstanding;
+    }
+    for (size_t i = 0; i < remaining.size(); i++) {
+        remaining[i]->result.wait();
+    }
+}
+
+AIJobPtr AIJobQueue::submitEnemyPlan(const std::shared_ptr<const CombatSnapshot>& snapshot, int actor) {
+    AIJobPtr job = std::make_shared<AIJob>();
+    job->snapshot = snapshot;
+    job->actor = actor;
+    job->state_version = snapshot->state_version;
+    job->result = job->promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        outstanding.push_back(job);
+    }
+    jobs->submit(system_id, [this, job]() { run(job); });
+    return job;
+}
+
+void AIJobQueue::cancelAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < outstanding.size(); i++) {
+        outstanding[i]->cancel();
+    }
+}
+
+int AIJobQueue::getOutstandingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int)outstanding.size();
+}
+
+void AIJobQueue::run(const AIJobPtr& job) {
+    // Worker time has its own system: the AI budget covers only the main thread's updateJobs
+    PerfScope perf(PerfSystem::AI_WORKERS);
+
+    // Cancelled jobs still resolve their future (with an invalid plan)
+    EnemyPlan plan;
+    if (!job->isCancelled()) {
+        EnemyPlanner::planTurn(*job->snapshot, job->actor, job->cancelled, plan);
+    }
+
+    // Leave the outstanding list before resolving, so the destructor never waits on a finished job's entry
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        outstanding.erase(std::find(outstanding.begin(), outstanding.end(), job));
+    }
+    job->promise.set_value(plan);
+}
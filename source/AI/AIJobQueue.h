@@ -0,0 +1,59 @@
+// AIJobQueue.h
+// AI planning jobs on the shared JobSystem (timed under the "AI" system)
+// Jobs run on CombatSnapshot copies; GameManager polls the futures each frame and
+// applies finished plans on the main thread
+
+#pragma once
+
+#include "EnemyPlanner.h"
+#include "../Core/JobSystem.h"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// A submitted planning job
+struct AIJob {
+    std::shared_ptr<const CombatSnapshot> snapshot;
+    int actor;                          // Combatant index being planned
+    unsigned int state_version;         // Combat state the plan was computed against
+    std::atomic<bool> cancelled;
+    std::promise<EnemyPlan> promise;
+    std::future<EnemyPlan> result;
+
+    AIJob() : actor(-1), state_version(0), cancelled(false) {}
+
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+    bool isReady() const;
+};
+
+typedef std::shared_ptr<AIJob> AIJobPtr;
+
+class AIJobQueue {
+public:
+    explicit AIJobQueue(JobSystem* job_system);
+    ~AIJobQueue();                      // Cancels outstanding jobs and waits for them
+
+    // Queue planning for snapshot->combatants[actor]. The snapshot is shared read-only.
+    AIJobPtr submitEnemyPlan(const std::shared_ptr<const CombatSnapshot>& snapshot, int actor);
+
+    // Cancel every queued and running job (running jobs stop at their next check)
+    void cancelAll();
+
+    int getWorkerCount() const { return jobs->getWorkerCount(); }
+    int getOutstandingCount() const;
+
+private:
+    JobSystem* jobs;
+    int system_id;
+    std::vector<AIJobPtr> outstanding;  // Submitted and not finished yet
+    mutable std::mutex mutex;
+
+    void run(const AIJobPtr& job);
+
+    // Prevent copying
+    AIJobQueue(const AIJobQueue&) = delete;
+    AIJobQueue& operator=(const AIJobQueue&) = delete;
+};
@@ -0,0 +1,138 @@
+// CombatSnapshot.cpp
+#include "CombatSnapshot.h"
+#include "../Grid/GridSystem.h"
+#include "../Grid/FogOfWar.h"
+#include "../Core/TurnManager.h"
+#include "../Components/UnitComponent.h"
+#include "../Core/CombatantTable.h"
+#include <UnigineHashMap.h>
+
+namespace {
+    // Combat state comes from the dense CombatantTable row and its shared stat block - no property reads
+    CombatantSnapshot makeCombatant(const Unigine::NodePtr& node, UnitComponent* unit, bool is_player_unit) {
+        CombatantSnapshot combatant;
+        combatant.node_id = node ? node->getID() : 0;
+        combatant.is_player_unit = is_player_unit;
+        if (unit && unit->table_row >= 0) {
+            const CombatantTable* table = CombatantTable::get();
+            const int row = unit->table_row;
+            const StatBlock& stats = table->getStats(row);
+            combatant.position = table->position[row];
+            combatant.current_hp = table->current_hp[row];
+            combatant.initiative = table->initiative[row];
+            combatant.max_hp = stats.max_hp;
+            combatant.armor_class = stats.armor_class;
+            combatant.attack_bonus = stats.attack_bonus;
+            combatant.speed = stats.speed;
+            combatant.perception = stats.perception;
+            combatant.damage = stats.damage;
+        }
+        return combatant;
+    }
+}
+
+void CombatSnapshot::capture(GridSystem* grid, const TurnManager* turn_manager, unsigned int version,
+                             const FogOfWar* fog) {
+    state_version = version;
+
+    // Combatants in initiative order
+    combatants.clear();
+    for (int i = 0; i < turn_manager->getInitiativeCount(); i++) {
+        const InitiativeEntry& entry = turn_manager->getInitiativeEntry(i);
+        CombatantSnapshot combatant = makeCombatant(entry.unit_node, entry.unit_component, entry.is_player_unit);
+        combatant.initiative = entry.initiative_value;
+        combatants.append(combatant);
+    }
+
+    current_index = turn_manager->getCurrentTurnIndex();
+    actions_remaining = turn_manager->getActionsRemaining();
+    current_map = turn_manager->getCurrentMAP();
+
+    captureGrid(grid);
+
+    // The AI plans with what its side can see
+    visible.clear();
+    if (fog && current_index >= 0 && current_index < combatants.size()) {
+        const Faction side = combatants[current_index].is_player_unit ? Faction::PLAYER : Faction::ENEMY;
+        fog->copyVisible((int)side, visible);
+    }
+}
+
+void CombatSnapshot::captureEncounter(GridSystem* grid,
+                                      const Unigine::Vector<Unigine::NodePtr>& player_units,
+                                      const Unigine::Vector<Unigine::NodePtr>& enemy_units)
+{
+    state_version = 0;
+
+    combatants.clear();
+    for (int i = 0; i < player_units.size(); i++) {
+        UnitComponent* unit = Unigine::ComponentSystem::get()->getComponent<UnitComponent>(player_units[i]);
+        if (unit) combatants.append(makeCombatant(player_units[i], unit, true));
+    }
+    for (int i = 0; i < enemy_units.size(); i++) {
+        UnitComponent* unit = Unigine::ComponentSystem::get()->getComponent<UnitComponent>(enemy_units[i]);
+        if (unit) combatants.append(makeCombatant(enemy_units[i], unit, false));
+    }
+
+    current_index = -1;
+    actions_remaining = 3;
+    current_map = 0;
+
+    captureGrid(grid);
+}
+
+void CombatSnapshot::captureGrid(GridSystem* grid) {
+    Unigine::HashMap<int, int> index_by_node;
+    for (int i = 0; i < combatants.size(); i++) {
+        index_by_node.append(combatants[i].node_id, i);
+    }
+
+    // Grid cells (flat arrays, same indexing as GridSystem)
+    width = grid->getWidth();
+    height = grid->getHeight();
+    const int num_cells = width * height;
+    blocked.resize(num_cells);
+    elevation.resize(num_cells);
+    occupant.resize(num_cells);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const GridCell* cell = grid->getCell(x, y);
+            const int index = getIndex(x, y);
+
+            blocked[index] = cell->blocked ? 1 : 0;
+            elevation[index] = cell->elevation;
+            occupant[index] = -1;
+
+            if (cell->isOccupied()) {
+                Unigine::HashMap<int, int>::Iterator it = index_by_node.find(cell->occupant->getID());
+                if (it != index_by_node.end()) {
+                    occupant[index] = it->data;
+                } else {
+                    blocked[index] = 1; // Not in combat (props, neutral units): treat as terrain
+                    occupant[index] = OUTSIDER;
+                }
+            }
+        }
+    }
+}
+
+void CombatSnapshot::buildStrideMask(int mover, Unigine::Vector<unsigned char>& out_mask) const {
+    const int num_cells = width * height;
+    out_mask.resize(num_cells);
+
+    for (int i = 0; i < num_cells; i++) {
+        const int other = occupant[i];
+        const bool occupied = other >= 0 && other != mover && combatants[other].isAlive();
+        out_mask[i] = (blocked[i] || occupied) ? 1 : 0;
+    }
+}
+
+GridView CombatSnapshot::getView(const Unigine::Vector<unsigned char>& mask) const {
+    GridView view;
+    view.width = width;
+    view.height = height;
+    view.blocked = mask.get();
+    view.elevation = elevation.get();
+    return view;
+}
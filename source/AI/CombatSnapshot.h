@@ -0,0 +1,93 @@
+// CombatSnapshot.h
+// Plain-data copy of the combat state, captured on the main thread for AI jobs
+// Worker threads read only this - never GridSystem, TurnManager or Unigine nodes
+
+#pragma once
+
+#include "../Grid/GridCell.h"
+#include "../Grid/Pathfinding.h"
+#include "../Core/Dice.h"
+#include <UnigineVector.h>
+#include <UnigineNode.h>
+
+class GridSystem;
+class TurnManager;
+class FogOfWar;
+
+// One unit in the initiative order
+struct CombatantSnapshot {
+    int node_id;                // Scene node ID (stable handle back to the unit)
+    GridPosition position;
+    int current_hp;
+    int max_hp;
+    int armor_class;
+    int attack_bonus;
+    int speed;                  // Feet
+    int perception;             // Initiative modifier
+    int initiative;             // Rolled initiative (0 before combat starts)
+    DiceExpr damage;            // Parsed weapon damage
+    bool is_player_unit;
+
+    CombatantSnapshot()
+        : node_id(0)
+        , current_hp(0)
+        , max_hp(0)
+        , armor_class(10)
+        , attack_bonus(0)
+        , speed(25)
+        , perception(0)
+        , initiative(0)
+        , is_player_unit(false)
+    {}
+
+    bool isAlive() const { return current_hp > 0; }
+};
+
+struct CombatSnapshot {
+    static const int OUTSIDER = -2;             // Unit not in combat: blocks like terrain, covers like a creature
+
+    int width;
+    int height;
+    Unigine::Vector<unsigned char> blocked;     // Terrain only (1 = impassable)
+    Unigine::Vector<int> elevation;
+    Unigine::Vector<int> occupant;              // Combatant index per cell (-1 = empty, OUTSIDER)
+    Unigine::Vector<unsigned char> visible;     // Cells the acting unit's side sees (empty = no fog)
+
+    Unigine::Vector<CombatantSnapshot> combatants;  // Same order as the initiative order
+    int current_index;          // Acting combatant
+    int actions_remaining;
+    int current_map;
+    unsigned int state_version; // GameManager state version at capture time
+
+    CombatSnapshot()
+        : width(0)
+        , height(0)
+        , current_index(-1)
+        , actions_remaining(0)
+        , current_map(0)
+        , state_version(0)
+    {}
+
+    // Copy grid and initiative state (main thread only), and with a fog the acting side's view
+    void capture(GridSystem* grid, const TurnManager* turn_manager, unsigned int version,
+                 const FogOfWar* fog = nullptr);
+
+    // Copy grid and an encounter's units before initiative is rolled (players first, then
+    // enemies - the order TurnManager::rollInitiative consumes rolls in)
+    void captureEncounter(GridSystem* grid,
+                          const Unigine::Vector<Unigine::NodePtr>& player_units,
+                          const Unigine::Vector<Unigine::NodePtr>& enemy_units);
+
+    // Stride mask for a mover: terrain plus every occupied cell except the mover's own
+    void buildStrideMask(int mover, Unigine::Vector<unsigned char>& out_mask) const;
+
+    // View for Pathfinding over the given mask and this snapshot's elevation
+    GridView getView(const Unigine::Vector<unsigned char>& mask) const;
+
+    int getIndex(int x, int y) const { return y * width + x; }
+    int getIndex(GridPosition pos) const { return getIndex(pos.x, pos.y); }
+    bool isVisible(GridPosition pos) const { return visible.size() == 0 || visible[getIndex(pos)]; }
+
+private:
+    void captureGrid(GridSystem* grid);
+};
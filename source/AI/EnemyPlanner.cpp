@@ -0,0 +1,52 @@
+// EnemyPlanner.cpp
+#include "EnemyPlanner.h"
+#include "UtilityScoring.h"
+
+bool EnemyPlanner::planTurn(const CombatSnapshot& snapshot, int actor, const std::atomic<bool>& cancelled,
+                            EnemyPlan& out_plan)
+{
+    out_plan = EnemyPlan();
+    if (actor < 0 || actor >= snapshot.combatants.size()) return false;
+
+    const CombatantSnapshot& self = snapshot.combatants[actor];
+    out_plan.actor = actor;
+    out_plan.actor_node_id = self.node_id;
+
+    const int actions = snapshot.actions_remaining;
+    if (actions <= 0 || !self.isAlive()) return false;
+
+    // Working buffers belong to the worker thread: their capacity carries over from plan to
+    // plan, so steady-state enemy turns do not touch the general heap
+    static thread_local Unigine::Vector<unsigned char> mask;
+    static thread_local Unigine::Vector<ReachableCell> reachable;
+    static thread_local CandidateBuffer candidates;
+    static thread_local Unigine::Vector<int> best;
+
+    // Everything reachable with all remaining actions spent on Strides
+    snapshot.buildStrideMask(actor, mask);
+    GridView view = snapshot.getView(mask);
+
+    Pathfinding::computeReachable(view, self.position, self.speed * actions, reachable);
+
+    if (cancelled.load(std::memory_order_relaxed)) return false;
+
+    // Every (cell x target x action) candidate, scored in one batch
+    if (!UtilityScoring::gatherCandidates(snapshot, actor, reachable, &cancelled, candidates)) return false;
+    if (candidates.size() == 0) return false;
+
+    UtilityScoring::scoreCandidates(candidates, UtilityWeights::getDefault());
+
+    UtilityScoring::selectTopK(candidates, 1, best);
+    const int choice = best[0];
+
+    const int strikes = getStrikeCount((AIAction)candidates.action[choice]);
+    out_plan.stride_actions = candidates.strides[choice];
+    if (out_plan.stride_actions > 0) {
+        Pathfinding::buildPath(view, reachable, candidates.cell[choice], out_plan.path);
+    }
+    out_plan.target = strikes > 0 ? candidates.target[choice] : -1;
+    out_plan.target_node_id = out_plan.target >= 0 ? snapshot.combatants[out_plan.target].node_id : 0;
+    out_plan.strikes = strikes;
+    out_plan.valid = !cancelled.load(std::memory_order_relaxed);
+    return out_plan.valid;
+}
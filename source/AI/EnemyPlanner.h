@@ -0,0 +1,38 @@
+// EnemyPlanner.h
+// Plans an enemy turn (Stride + Strikes) from a CombatSnapshot using utility scoring
+// Pure function of the snapshot: safe to run on AI worker threads
+
+#pragma once
+
+#include "CombatSnapshot.h"
+#include <UnigineVector.h>
+#include <atomic>
+
+// Result of planning one enemy turn
+struct EnemyPlan {
+    bool valid;                             // False if cancelled or no legal plan
+    int actor;                              // Combatant index in the snapshot
+    int actor_node_id;
+    Unigine::Vector<GridPosition> path;     // Stride path including the start cell (empty = stay)
+    int stride_actions;                     // Actions spent on Strides
+    int target;                             // Combatant index to Strike (-1 = none)
+    int target_node_id;
+    int strikes;                            // Strikes against target after moving
+
+    EnemyPlan()
+        : valid(false)
+        , actor(-1)
+        , actor_node_id(0)
+        , stride_actions(0)
+        , target(-1)
+        , target_node_id(0)
+        , strikes(0)
+    {}
+};
+
+namespace EnemyPlanner {
+    // Plan the acting combatant's turn. Checks 'cancelled' periodically and
+    // returns false (plan invalid) as soon as it is set.
+    bool planTurn(const CombatSnapshot& snapshot, int actor, const std::atomic<bool>& cancelled,
+                  EnemyPlan& out_plan);
+}
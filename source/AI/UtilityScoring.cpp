@@ -0,0 +1,242 @@
+// UtilityScoring.cpp
+#include "UtilityScoring.h"
+#include "../Core/Arena.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    const int CANCEL_CHECK_INTERVAL = 64; // Cells between cancellation checks
+
+    // Apply one consideration over a whole feature column: score[i] += weight * curve(x[i]).
+    // The curve type is resolved once, outside the loop, so each loop body is branch-free.
+    void accumulate(const float* x, float* score, int n, const Consideration& consideration) {
+        if (consideration.weight == 0.0f) return;
+
+        const ResponseCurve& c = consideration.curve;
+        const float w = consideration.weight;
+
+        switch (c.type) {
+        case CurveType::LINEAR:
+            for (int i = 0; i < n; i++) {
+                score[i] += w * (c.slope * (x[i] - c.x_shift) + c.y_shift);
+            }
+            break;
+
+        case CurveType::QUADRATIC:
+            for (int i = 0; i < n; i++) {
+                float d = std::fabs(x[i] - c.x_shift);
+                score[i] += w * (c.slope * std::pow(d, c.exponent) + c.y_shift);
+            }
+            break;
+
+        case CurveType::LOGISTIC:
+            for (int i = 0; i < n; i++) {
+                score[i] += w * (c.slope / (1.0f + std::exp(-c.exponent * (x[i] - c.x_shift))) + c.y_shift);
+            }
+            break;
+
+        case CurveType::STEP:
+            for (int i = 0; i < n; i++) {
+                score[i] += w * ((x[i] >= c.x_shift ? c.slope : 0.0f) + c.y_shift);
+            }
+            break;
+        }
+    }
+
+    // Target columns captured once per gather (SoA for the inner loop)
+    // Lives in the calling thread's scratch arena for the duration of one gather
+    struct TargetColumns {
+        ArenaVector<int> index;
+        ArenaVector<int> x;
+        ArenaVector<int> y;
+        ArenaVector<float> hit[AI_ACTION_COUNT];    // Expected hits / 3 per action
+
+        explicit TargetColumns(Arena& arena)
+            : index(ArenaAllocator<int>(&arena, MemorySystem::AI))
+            , x(ArenaAllocator<int>(&arena, MemorySystem::AI))
+            , y(ArenaAllocator<int>(&arena, MemorySystem::AI))
+        {
+            for (int a = 0; a < AI_ACTION_COUNT; a++) {
+                hit[a] = ArenaVector<float>(ArenaAllocator<float>(&arena, MemorySystem::AI));
+            }
+        }
+    };
+}
+
+void CandidateBuffer::reserve(int capacity) {
+    if (cell.size() >= capacity) return;
+
+    cell.resize(capacity);
+    target.resize(capacity);
+    action.resize(capacity);
+    strides.resize(capacity);
+    hit_chance.resize(capacity);
+    cover.resize(capacity);
+    threat.resize(capacity);
+    distance.resize(capacity);
+    score.resize(capacity);
+}
+
+float ResponseCurve::evaluate(float x) const {
+    float result = 0.0f;
+    Consideration single(*this, 1.0f);
+    accumulate(&x, &result, 1, single);
+    return result;
+}
+
+UtilityWeights UtilityWeights::getDefault() {
+    UtilityWeights weights;
+    weights.hit_chance = Consideration(ResponseCurve(CurveType::LINEAR, 1.0f), 4.0f);
+    weights.cover = Consideration(ResponseCurve(CurveType::LINEAR, 1.0f), 0.5f);
+    weights.threat = Consideration(ResponseCurve(CurveType::QUADRATIC, -1.0f, 2.0f), 1.0f);
+    weights.distance = Consideration(ResponseCurve(CurveType::LINEAR, -1.0f, 1.0f, 0.0f, 1.0f), 1.5f);
+    return weights;
+}
+
+float UtilityScoring::getHitChance(int attack_bonus, int map, int armor_class) {
+    // Need d20 >= AC - bonus - map; natural 1 / 20 keep it inside 5%..95%
+    int needed = armor_class - attack_bonus - map;
+    float chance = (21 - needed) / 20.0f;
+    if (chance < 0.05f) chance = 0.05f;
+    if (chance > 0.95f) chance = 0.95f;
+    return chance;
+}
+
+bool UtilityScoring::gatherCandidates(const CombatSnapshot& snapshot, int actor,
+                                      const Unigine::Vector<ReachableCell>& reachable,
+                                      const std::atomic<bool>* cancelled, CandidateBuffer& out)
+{
+    out.clear();
+    if (actor < 0 || actor >= snapshot.combatants.size()) return true;
+
+    const CombatantSnapshot& self = snapshot.combatants[actor];
+    const int actions = snapshot.actions_remaining;
+
+    // Hostile targets and their per-action expected hits (MAP starts at the current value)
+    Arena::Scope scratch(Arena::getThreadScratch());
+    TargetColumns targets(Arena::getThreadScratch());
+    for (int t = 0; t < snapshot.combatants.size(); t++) {
+        const CombatantSnapshot& other = snapshot.combatants[t];
+        if (other.is_player_unit == self.is_player_unit || !other.isAlive()) continue;
+        if (!snapshot.isVisible(other.position)) continue;     // Hidden in the fog
+
+        targets.index.push_back(t);
+        targets.x.push_back(other.position.x);
+        targets.y.push_back(other.position.y);
+
+        float expected = 0.0f;
+        for (int a = 0; a < AI_ACTION_COUNT; a++) {
+            if (a > 0) {
+                int map = snapshot.current_map - 5 * (a - 1);
+                if (map < -10) map = -10;
+                expected += getHitChance(self.attack_bonus, map, other.armor_class);
+            }
+            targets.hit[a].push_back(expected / 3.0f);
+        }
+    }
+
+    const int num_targets = (int)targets.index.size();
+    if (num_targets == 0) return true;
+
+    out.reserve(reachable.size() * num_targets * AI_ACTION_COUNT);
+
+    const float diagonal = (float)(snapshot.width + snapshot.height);
+    const float inv_diagonal = diagonal > 0.0f ? 1.0f / diagonal : 0.0f;
+
+    for (int i = 0; i < reachable.size(); i++) {
+        if (cancelled && (i % CANCEL_CHECK_INTERVAL) == 0 && cancelled->load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        const int cell = reachable[i].index;
+        const int cx = cell % snapshot.width;
+        const int cy = cell / snapshot.width;
+
+        const int strides = Pathfinding::getStrideCount(reachable[i].cost, self.speed);
+        if (strides > actions) continue;
+        if (snapshot.occupant[cell] != -1 && snapshot.occupant[cell] != actor) continue;     // The fallen can be passed, not stood on
+
+        // Per-cell considerations shared by every target/action at this cell
+        int blocked_neighbours = 0;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx == 0 && dy == 0) continue;
+                int nx = cx + dx;
+                int ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= snapshot.width || ny >= snapshot.height) continue;
+                blocked_neighbours += snapshot.blocked[snapshot.getIndex(nx, ny)];
+            }
+        }
+
+        int adjacent_hostiles = 0;
+        for (int t = 0; t < num_targets; t++) {
+            if (abs(targets.x[t] - cx) <= 1 && abs(targets.y[t] - cy) <= 1) adjacent_hostiles++;
+        }
+
+        const float cell_cover = blocked_neighbours / 8.0f;
+        const float cell_threat = adjacent_hostiles / 8.0f;
+
+        for (int t = 0; t < num_targets; t++) {
+            const int dx = abs(targets.x[t] - cx);
+            const int dy = abs(targets.y[t] - cy);
+            const bool in_reach = dx <= 1 && dy <= 1;
+            const float target_distance = (dx > dy ? dx : dy) * inv_diagonal;
+
+            for (int a = 0; a < AI_ACTION_COUNT; a++) {
+                const int strikes = getStrikeCount((AIAction)a);
+                if (strikes > 0 && !in_reach) continue;
+                if (strides + strikes > actions) continue;
+                if (strikes == 0 && strides == 0) continue; // Standing still is not an action
+
+                const int n = out.count++;
+                out.cell[n] = cell;
+                out.target[n] = targets.index[t];
+                out.action[n] = (unsigned char)a;
+                out.strides[n] = (unsigned char)strides;
+                out.hit_chance[n] = targets.hit[a][t];
+                out.cover[n] = cell_cover;
+                out.threat[n] = cell_threat;
+                out.distance[n] = target_distance;
+            }
+        }
+    }
+
+    return true;
+}
+
+void UtilityScoring::scoreCandidates(CandidateBuffer& buffer, const UtilityWeights& weights) {
+    const int n = buffer.size();
+    float* score = buffer.score.get();
+
+    for (int i = 0; i < n; i++) {
+        score[i] = 0.0f;
+    }
+
+    accumulate(buffer.hit_chance.get(), score, n, weights.hit_chance);
+    accumulate(buffer.cover.get(), score, n, weights.cover);
+    accumulate(buffer.threat.get(), score, n, weights.threat);
+    accumulate(buffer.distance.get(), score, n, weights.distance);
+}
+
+int UtilityScoring::selectTopK(const CandidateBuffer& buffer, int k, Unigine::Vector<int>& out_indices) {
+    const int n = buffer.size();
+    if (k > n) k = n;
+
+    out_indices.resize(n);
+    for (int i = 0; i < n; i++) {
+        out_indices[i] = i;
+    }
+
+    const float* score = buffer.score.get();
+    int* indices = out_indices.get();
+    std::partial_sort(indices, indices + k, indices + n,
+        [score](int a, int b) {
+            if (score[a] != score[b]) return score[a] > score[b];
+            return a < b;
+        });
+
+    out_indices.resize(k);
+    return k;
+}
@@ -0,0 +1,109 @@
+// UtilityScoring.h
+// Utility AI candidate evaluation: structure-of-arrays candidate buffer + batch scoring kernel
+// One candidate = (destination cell, target, action). Scoring runs as tight loops over
+// plain float arrays - no per-candidate virtual calls or node access.
+
+#pragma once
+
+#include "CombatSnapshot.h"
+#include <UnigineVector.h>
+#include <atomic>
+
+// Action part of a candidate (how the actor spends what is left after moving)
+enum class AIAction : unsigned char {
+    ADVANCE,        // Stride only, close distance to the target
+    STRIKE_1,       // Stride(s) + 1 Strike
+    STRIKE_2,       // Stride(s) + 2 Strikes (second at MAP)
+    STRIKE_3        // 3 Strikes, no movement
+};
+
+const int AI_ACTION_COUNT = 4;
+
+inline int getStrikeCount(AIAction action) { return (int)action; }
+
+// Structure-of-arrays candidate storage. All arrays have size() entries.
+struct CandidateBuffer {
+    Unigine::Vector<int> cell;                  // Destination cell index (y * width + x)
+    Unigine::Vector<int> target;                // Combatant index (-1 = none)
+    Unigine::Vector<unsigned char> action;      // AIAction
+    Unigine::Vector<unsigned char> strides;     // Stride actions needed to reach cell
+
+    // Considerations, normalized to 0..1
+    Unigine::Vector<float> hit_chance;          // Expected hits / 3 (MAP included)
+    Unigine::Vector<float> cover;               // Blocked neighbours of the cell / 8
+    Unigine::Vector<float> threat;              // Living hostiles adjacent to the cell / 8
+    Unigine::Vector<float> distance;            // Distance to target / grid diagonal
+
+    Unigine::Vector<float> score;               // Output of scoreCandidates()
+
+    int count;
+
+    CandidateBuffer() : count(0) {}
+
+    int size() const { return count; }
+    void clear() { count = 0; }
+
+    // Grow every array to hold at least 'capacity' candidates (never shrinks)
+    void reserve(int capacity);
+};
+
+// Response curve mapping a 0..1 consideration to a utility
+enum class CurveType : unsigned char {
+    LINEAR,         // slope * (x - x_shift) + y_shift
+    QUADRATIC,      // slope * (x - x_shift)^exponent + y_shift
+    LOGISTIC,       // slope / (1 + e^(-exponent * (x - x_shift))) + y_shift
+    STEP            // (x >= x_shift ? slope : 0) + y_shift
+};
+
+struct ResponseCurve {
+    CurveType type;
+    float slope;
+    float exponent;
+    float x_shift;
+    float y_shift;
+
+    ResponseCurve(CurveType _type = CurveType::LINEAR, float _slope = 1.0f, float _exponent = 1.0f,
+                  float _x_shift = 0.0f, float _y_shift = 0.0f)
+        : type(_type), slope(_slope), exponent(_exponent), x_shift(_x_shift), y_shift(_y_shift) {}
+
+    float evaluate(float x) const;
+};
+
+// One weighted consideration
+struct Consideration {
+    ResponseCurve curve;
+    float weight;
+
+    Consideration() : weight(0.0f) {}
+    Consideration(const ResponseCurve& _curve, float _weight) : curve(_curve), weight(_weight) {}
+};
+
+// Full scoring configuration (score = sum of weight * curve(consideration))
+struct UtilityWeights {
+    Consideration hit_chance;
+    Consideration cover;
+    Consideration threat;
+    Consideration distance;
+
+    // Aggressive melee defaults used by EnemyPlanner
+    static UtilityWeights getDefault();
+};
+
+namespace UtilityScoring {
+    // Fill 'out' with every (reachable cell x living hostile target x action) candidate for
+    // the actor. Inputs are the per-turn snapshot and a computeReachable() result.
+    // Returns false if cancelled.
+    bool gatherCandidates(const CombatSnapshot& snapshot, int actor,
+                          const Unigine::Vector<ReachableCell>& reachable,
+                          const std::atomic<bool>* cancelled, CandidateBuffer& out);
+
+    // Batch kernel: writes buffer.score for every candidate
+    void scoreCandidates(CandidateBuffer& buffer, const UtilityWeights& weights);
+
+    // Indices of the k best candidates, best first (ties: lower index first).
+    // Returns the number written (min(k, size)).
+    int selectTopK(const CandidateBuffer& buffer, int k, Unigine::Vector<int>& out_indices);
+
+    // Chance (0..1) that d20 + attack_bonus + map meets armor_class (nat 1/20 clamp)
+    float getHitChance(int attack_bonus, int map, int armor_class);
+}
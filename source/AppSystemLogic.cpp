@@ -4,6 +4,7 @@
 #include <UnigineInput.h>
 #include <UnigineConsole.h>
 #include <UnigineGui.h>
+#include "Data/UnitDatabase.h"
 
 using namespace Unigine;
 
@@ -26,6 +27,10 @@ int AppSystemLogic::init()
 	// Components with REGISTER_COMPONENT() macro register automatically
 	ComponentSystem::get()->initialize();
 
+	// Load shared unit stat blocks once, before any world (and its UnitComponents) loads
+	UnitDatabase::get()->load("units/player_units.json");
+	UnitDatabase::get()->load("units/enemy_units.json");
+
 	// Configure mouse cursor for tactical game (not first-person)
 	// Make cursor visible and not grabbed/locked
 	Input::setMouseGrab(false);  // false = cursor not grabbed
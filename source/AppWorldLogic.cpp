@@ -2,6 +2,7 @@
 
 #include <UnigineLog.h>
 #include <UnigineGame.h>
+#include "Core/PerfMonitor.h"
 
 // World logic, it takes effect only when the world is loaded.
 // These methods are called right after corresponding world script's (UnigineScript) methods.
@@ -21,6 +22,9 @@ int AppWorldLogic::init()
 	game = new GameManager();
 	game->init();
 
+	// Always-on frame metrics (perf_stats, perf_budget, perf_csv, perf_record)
+	PerfMonitor::get()->registerCommands();
+
 	Unigine::Log::message("AppWorldLogic::init() - Complete\n");
 	return 1;
 }
@@ -31,9 +35,24 @@ int AppWorldLogic::init()
 
 int AppWorldLogic::update()
 {
+	// Close last frame's metrics (its postUpdate and worker time included): warns about systems over budget
+	PerfMonitor::get()->endFrame();
+
+	// World setup runs a few milliseconds per frame until the game is interactive
+	game->updateLoading();
+
 	// Per-frame update: handle input
 	// Delegate to GameManager
-	game->handleInput();
+	{
+		PerfScope perf(PerfSystem::SELECTION);
+		game->handleInput();
+	}
+
+	// Apply results of background jobs (AI plans) on the main thread
+	{
+		PerfScope perf(PerfSystem::AI);
+		game->updateJobs();
+	}
 
 	return 1;
 }
@@ -41,6 +60,8 @@ int AppWorldLogic::update()
 int AppWorldLogic::postUpdate()
 {
 	// The engine calls this function after updating each render frame: correct behavior after the state of the node has been updated.
+	PerfScope perf(PerfSystem::RENDERING);
+	game->postUpdate();
 	return 1;
 }
 
@@ -52,6 +73,7 @@ int AppWorldLogic::updatePhysics()
 	game->update(dt);
 
 	// WARNING: do not create, delete or change transformations of nodes here, because rendering is already in progress.
+	// Game logic records scene changes in GameManager::scene_commands instead; they are applied in postUpdate.
 	return 1;
 }
 
@@ -63,6 +85,8 @@ int AppWorldLogic::shutdown()
 {
 	Unigine::Log::message("AppWorldLogic::shutdown() - Destroying GameManager...\n");
 
+	PerfMonitor::get()->unregisterCommands();
+
 	// Delete game manager (which will clean up all game systems)
 	delete game;
 	game = nullptr;
@@ -73,14 +97,18 @@ int AppWorldLogic::shutdown()
 
 int AppWorldLogic::save(const Unigine::StreamPtr &stream)
 {
-	// Write here code to be called when the world is saving its state (i.e. state_save is called): save custom user data to a file.
-	UNIGINE_UNUSED(stream);
+	// Called when the world is saving its state (i.e. state_save is called): save combat state.
+	if (game) {
+		game->saveState(stream);
+	}
 	return 1;
 }
 
 int AppWorldLogic::restore(const Unigine::StreamPtr &stream)
 {
-	// Write here code to be called when the world is restoring its state (i.e. state_restore is called): restore custom user data to a file here.
-	UNIGINE_UNUSED(stream);
+	// Called when the world is restoring its state (i.e. state_restore is called): restore combat state.
+	if (game) {
+		game->restoreState(stream);
+	}
 	return 1;
 }
@@ -25,10 +25,20 @@ public:
     PROP_PARAM(Float, tile_coverage, 0.9f);      // 0.9 = tiles cover 90%, leaving 10% gaps
     PROP_PARAM(Float, tile_height_offset, 0.1f); // How far above ground to render (meters)
     PROP_PARAM(Float, tile_thickness, 0.01f);    // Thickness of grid tiles (meters)
+    PROP_PARAM(Toggle, batched_grid, true);      // Chunked vertex-coloured meshes instead of one node per cell
+    PROP_PARAM(Int, chunk_size, 32);             // Cells per chunk edge (batched grid)
+    PROP_PARAM(Int, chunk_budget, 16);           // Chunk meshes that may exist at once (node budget)
+    PROP_PARAM(Float, chunk_full_distance, 40.0f); // Chunks closer than this draw one quad per cell
+    PROP_PARAM(Float, chunk_far_distance, 120.0f); // Chunks closer than this draw merged tiles, beyond: nothing
+    PROP_PARAM(Int, coarse_block, 4);            // Cells per merged tile edge (far LOD)
 
     // Grid colors (RGBA)
     PROP_PARAM(Vec4, grid_color, Unigine::Math::vec4(0.4f, 0.4f, 0.4f, 0.7f)); // Semi-transparent gray
+    PROP_PARAM(Vec4, blocked_color, Unigine::Math::vec4(0.5f, 0.15f, 0.15f, 0.7f)); // Impassable cells (batched grid)
+    PROP_PARAM(Vec4, occupied_color, Unigine::Math::vec4(0.45f, 0.45f, 0.3f, 0.7f)); // Cells with a unit (batched grid)
     PROP_PARAM(Vec4, highlight_color, Unigine::Math::vec4(0.0f, 0.8f, 1.0f, 0.8f)); // Cyan for highlights
+    PROP_PARAM(Vec4, unexplored_color, Unigine::Math::vec4(0.05f, 0.05f, 0.05f, 0.9f)); // Fog: never seen (batched grid)
+    PROP_PARAM(Float, fog_brightness, 0.4f);     // Fog: explored cells out of sight, colour scale
 
 protected:
     void init();
@@ -1,5 +1,6 @@
 // UnitComponent.cpp
 #include "UnitComponent.h"
+#include "../Core/CombatHistory.h"
 #include <UnigineLog.h>
 
 // Register component with Unigine (automatic registration)
@@ -10,13 +11,13 @@ void UnitComponent::init() {
     Unigine::Log::message("UnitComponent::init() - Unit '%s' (Level %d) initialized\n",
         unit_name.get(), level.get());
 
-    // Initialize grid position to origin (will be set by game logic)
-    grid_position = GridPosition(0, 0, 0);
-
     // Ensure current_hp doesn't exceed max_hp
     if (current_hp > max_hp) {
         current_hp = max_hp;
     }
+
+    // Mirror stats into the dense table (grid position starts at origin, set by game logic)
+    table_row = CombatantTable::get()->add(this);
 }
 
 void UnitComponent::update() {
@@ -26,18 +27,28 @@ void UnitComponent::update() {
 
 void UnitComponent::shutdown() {
     Unigine::Log::message("UnitComponent::shutdown() - Unit '%s' destroyed\n", unit_name.get());
+
+    CombatantTable* table = CombatantTable::get();
+    if (table_row >= 0) {
+        table->writeBack();
+        table->remove(table_row);
+        table_row = -1;
+    }
 }
 
 void UnitComponent::takeDamage(int amount) {
     if (amount <= 0) return;
 
-    current_hp = current_hp - amount;
-    if (current_hp < 0) {
-        current_hp = 0;
+    int hp_before = getCurrentHP();
+    int hp = hp_before - amount;
+    if (hp < 0) {
+        hp = 0;
     }
+    setCurrentHP(hp);
+    if (history) history->record(DeltaType::UNIT_HP, getNode()->getID(), hp_before, hp);
 
     Unigine::Log::message("Unit '%s' took %d damage (HP: %d/%d)\n",
-        unit_name.get(), amount, current_hp.get(), max_hp.get());
+        unit_name.get(), amount, hp, getStats().max_hp);
 
     if (!isAlive()) {
         Unigine::Log::message("Unit '%s' has been defeated!\n", unit_name.get());
@@ -47,11 +58,77 @@ void UnitComponent::takeDamage(int amount) {
 void UnitComponent::heal(int amount) {
     if (amount <= 0) return;
 
-    current_hp = current_hp + amount;
-    if (current_hp > max_hp) {
-        current_hp = max_hp;
+    int hp_before = getCurrentHP();
+    const int max = getStats().max_hp;
+    int hp = hp_before + amount;
+    if (hp > max) {
+        hp = max;
     }
+    setCurrentHP(hp);
+    if (history) history->record(DeltaType::UNIT_HP, getNode()->getID(), hp_before, hp);
 
     Unigine::Log::message("Unit '%s' healed %d HP (HP: %d/%d)\n",
-        unit_name.get(), amount, current_hp.get(), max_hp.get());
+        unit_name.get(), amount, hp, max);
+}
+
+const StatBlock& UnitComponent::getStats() const {
+    // Before init (no row yet) fall back to an empty block
+    static const StatBlock defaults;
+    if (table_row < 0) return defaults;
+    return CombatantTable::get()->getStats(table_row);
+}
+
+int UnitComponent::getCurrentHP() const {
+    if (table_row < 0) return current_hp;
+    return CombatantTable::get()->current_hp[table_row];
+}
+
+void UnitComponent::setCurrentHP(int hp) {
+    if (table_row < 0) {
+        current_hp = hp;
+        return;
+    }
+    CombatantTable* table = CombatantTable::get();
+    table->current_hp[table_row] = hp;
+    table->markDirty(table_row);
+}
+
+GridPosition UnitComponent::getGridPosition() const {
+    if (table_row < 0) return GridPosition(0, 0, 0);
+    return CombatantTable::get()->position[table_row];
+}
+
+void UnitComponent::setGridPosition(GridPosition pos) {
+    if (table_row < 0) return;
+    CombatantTable::get()->position[table_row] = pos;
+}
+
+bool UnitComponent::hasReaction() const {
+    if (table_row < 0) return has_reaction != 0;
+    return CombatantTable::get()->has_reaction[table_row] != 0;
+}
+
+void UnitComponent::setReaction(bool available) {
+    if (table_row < 0) {
+        has_reaction = available ? 1 : 0;
+        return;
+    }
+    CombatantTable* table = CombatantTable::get();
+    table->has_reaction[table_row] = available ? 1 : 0;
+    table->markDirty(table_row);
+}
+
+void UnitComponent::setInitiative(int value) {
+    if (table_row < 0) {
+        initiative = value;
+        return;
+    }
+    CombatantTable* table = CombatantTable::get();
+    table->initiative[table_row] = value;
+    table->markDirty(table_row);
+}
+
+void UnitComponent::setFaction(Faction value) {
+    if (table_row < 0) return;
+    CombatantTable::get()->faction[table_row] = (unsigned char)value;
 }
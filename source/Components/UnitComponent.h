@@ -6,6 +6,9 @@
 
 #include <UnigineComponentSystem.h>
 #include "../Grid/GridCell.h"
+#include "../Core/CombatantTable.h"
+
+class CombatHistory;
 
 class UnitComponent : public Unigine::ComponentBase
 {
@@ -20,6 +23,10 @@ public:
     PROP_PARAM(String, unit_name);
     PROP_PARAM(Int, level, 1);
 
+    // Shared stat block (UnitDatabase ID, e.g. "goblin_warrior"). When set, the stat
+    // properties below are ignored; when empty, they form the unit's stat block.
+    PROP_PARAM(String, stat_block);
+
     // Combat stats
     PROP_PARAM(Int, max_hp, 10);
     PROP_PARAM(Int, current_hp, 10);
@@ -49,21 +56,41 @@ public:
     PROP_PARAM(Int, current_map, 0);             // Multiple Attack Penalty (-5/-10 or -4/-8)
     PROP_PARAM(Int, has_reaction, 1);            // 1 reaction per round (1 = available, 0 = spent)
 
-    // Grid position (not exposed to editor, set by code)
-    GridPosition grid_position;
+    // Row in CombatantTable (-1 before init / after shutdown)
+    int table_row = -1;
+
+    // Records HP changes for undo (set by TurnManager while in combat)
+    CombatHistory* history = nullptr;
+
+    // Idle in UnitPool (hidden, not part of any encounter)
+    bool pooled = false;
 
     // Methods
     void takeDamage(int amount);
     void heal(int amount);
-    bool isAlive() const { return current_hp > 0; }
-
-    // Ability modifiers (PF2e: (score - 10) / 2)
-    int getStrengthMod() const { return (strength - 10) / 2; }
-    int getDexterityMod() const { return (dexterity - 10) / 2; }
-    int getConstitutionMod() const { return (constitution - 10) / 2; }
-    int getIntelligenceMod() const { return (intelligence - 10) / 2; }
-    int getWisdomMod() const { return (wisdom - 10) / 2; }
-    int getCharismaMod() const { return (charisma - 10) / 2; }
+    bool isAlive() const { return getCurrentHP() > 0; }
+
+    // Shared stats (stat block of the CombatantTable row)
+    const StatBlock& getStats() const;
+
+    // Mutable combat state - reads and writes go to the CombatantTable row; the
+    // properties above are updated by CombatantTable::writeBack()
+    int getCurrentHP() const;
+    void setCurrentHP(int hp);
+    GridPosition getGridPosition() const;   // Not exposed to editor, set by code
+    void setGridPosition(GridPosition pos);
+    bool hasReaction() const;
+    void setReaction(bool available);
+    void setInitiative(int value);
+    void setFaction(Faction value);
+
+    // Ability modifiers of the unit's stat block (the score properties are ignored for named blocks)
+    int getStrengthMod() const { return getStats().getStrengthMod(); }
+    int getDexterityMod() const { return getStats().getDexterityMod(); }
+    int getConstitutionMod() const { return getStats().getConstitutionMod(); }
+    int getIntelligenceMod() const { return getStats().getIntelligenceMod(); }
+    int getWisdomMod() const { return getStats().getWisdomMod(); }
+    int getCharismaMod() const { return getStats().getCharismaMod(); }
 
 protected:
     void init();
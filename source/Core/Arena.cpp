@@ -0,0 +1,139 @@
+// Arena.cpp
+#include "Arena.h"
+#include <atomic>
+#include <cstdlib>
+
+namespace {
+    const int NUM_SYSTEMS = (int)MemorySystem::COUNT;
+
+    std::atomic<long long> heap_allocations[NUM_SYSTEMS];
+    std::atomic<long long> heap_bytes[NUM_SYSTEMS];
+    std::atomic<long long> arena_allocations[NUM_SYSTEMS];
+    std::atomic<long long> arena_bytes[NUM_SYSTEMS];
+
+    const char* SYSTEM_NAMES[NUM_SYSTEMS] = { "Grid", "Turn", "AI", "Pathing", "Render", "Other" };
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+void MemoryStats::recordHeap(MemorySystem system, size_t bytes) {
+    heap_allocations[(int)system].fetch_add(1, std::memory_order_relaxed);
+    heap_bytes[(int)system].fetch_add((long long)bytes, std::memory_order_relaxed);
+}
+
+void MemoryStats::recordArena(MemorySystem system, size_t bytes) {
+    arena_allocations[(int)system].fetch_add(1, std::memory_order_relaxed);
+    arena_bytes[(int)system].fetch_add((long long)bytes, std::memory_order_relaxed);
+}
+
+MemoryStats::Counters MemoryStats::get(MemorySystem system) {
+    Counters counters;
+    counters.heap_allocations = heap_allocations[(int)system].load(std::memory_order_relaxed);
+    counters.heap_bytes = heap_bytes[(int)system].load(std::memory_order_relaxed);
+    counters.arena_allocations = arena_allocations[(int)system].load(std::memory_order_relaxed);
+    counters.arena_bytes = arena_bytes[(int)system].load(std::memory_order_relaxed);
+    return counters;
+}
+
+const char* MemoryStats::getName(MemorySystem system) {
+    return (int)system < NUM_SYSTEMS ? SYSTEM_NAMES[(int)system] : "?";
+}
+
+void MemoryStats::reset() {
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        heap_allocations[i].store(0, std::memory_order_relaxed);
+        heap_bytes[i].store(0, std::memory_order_relaxed);
+        arena_allocations[i].store(0, std::memory_order_relaxed);
+        arena_bytes[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+Arena::Arena(const char* arena_name, size_t block)
+    : name(arena_name)
+    , block_size(block > 256 ? block : 256)
+    , current(0)
+    , offset(0)
+    , high_water(0)
+{
+}
+
+Arena::~Arena() {
+    for (size_t i = 0; i < blocks.size(); i++) {
+        free(blocks[i].data);
+    }
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment, MemorySystem system) {
+    if (bytes == 0) bytes = 1;
+
+    // Current block, then any later block kept from before a reset
+    while (current < (int)blocks.size()) {
+        const Block& block = blocks[current];
+        const size_t start = alignUp((size_t)block.data + offset, alignment) - (size_t)block.data;
+        if (start + bytes <= block.size) {
+            offset = start + bytes;
+            MemoryStats::recordArena(system, bytes);
+
+            const size_t used = getUsed();
+            if (used > high_water) high_water = used;
+            return block.data + start;
+        }
+        if (current + 1 >= (int)blocks.size()) break;
+        current++;
+        offset = 0;
+    }
+
+    // Out of space: grow by one block (the only heap traffic an arena causes)
+    Block block;
+    block.size = bytes + alignment > block_size ? bytes + alignment : block_size;
+    block.data = static_cast<char*>(malloc(block.size));
+    if (!block.data) throw std::bad_alloc();
+    MemoryStats::recordHeap(system, block.size);
+
+    // Insert after the current block so later (larger) kept blocks stay reachable
+    const int index = blocks.empty() ? 0 : current + 1;
+    blocks.insert(blocks.begin() + index, block);
+    current = index;
+    offset = 0;
+    return allocate(bytes, alignment, system);
+}
+
+void Arena::reset() {
+    current = 0;
+    offset = 0;
+}
+
+Arena::Marker Arena::getMarker() const {
+    Marker marker;
+    marker.block = current;
+    marker.offset = offset;
+    return marker;
+}
+
+void Arena::rewind(const Marker& marker) {
+    current = marker.block;
+    offset = marker.offset;
+}
+
+size_t Arena::getUsed() const {
+    size_t used = offset;
+    for (int i = 0; i < current && i < (int)blocks.size(); i++) {
+        used += blocks[i].size;
+    }
+    return used;
+}
+
+size_t Arena::getCapacity() const {
+    size_t capacity = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        capacity += blocks[i].size;
+    }
+    return capacity;
+}
+
+Arena& Arena::getThreadScratch() {
+    static thread_local Arena scratch("Scratch", 256 * 1024);
+    return scratch;
+}
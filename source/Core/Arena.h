@@ -0,0 +1,137 @@
+// Arena.h
+// Bump allocators for transient combat data, plus per-subsystem allocation counters
+// An Arena hands out memory from large blocks and frees everything at once (reset, or
+// rewind to a marker). Blocks are kept across resets, so a warmed-up arena stops touching
+// the general heap. ArenaAllocator lets std containers live in an arena (ArenaVector).
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Subsystem an allocation is counted against
+enum class MemorySystem : unsigned char {
+    GRID,
+    TURN,
+    AI,
+    PATHING,
+    RENDER,
+    OTHER,
+    COUNT
+};
+
+namespace MemoryStats {
+    struct Counters {
+        long long heap_allocations;     // General-heap allocations (incl. arena block growth)
+        long long heap_bytes;
+        long long arena_allocations;    // Served from an arena without touching the heap
+        long long arena_bytes;
+    };
+
+    void recordHeap(MemorySystem system, size_t bytes);
+    void recordArena(MemorySystem system, size_t bytes);
+
+    Counters get(MemorySystem system);
+    const char* getName(MemorySystem system);
+    void reset();
+}
+
+class Arena {
+public:
+    // Position to rewind to (everything allocated after it is released)
+    struct Marker {
+        int block;
+        size_t offset;
+    };
+
+    // Rewinds the arena when it goes out of scope
+    class Scope {
+    public:
+        explicit Scope(Arena& _arena) : arena(_arena), marker(_arena.getMarker()) {}
+        ~Scope() { arena.rewind(marker); }
+
+    private:
+        Arena& arena;
+        Marker marker;
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    explicit Arena(const char* name, size_t block_size = 64 * 1024);
+    ~Arena();
+
+    void* allocate(size_t bytes, size_t alignment, MemorySystem system);
+
+    void reset();                       // Release everything, keep the blocks
+    Marker getMarker() const;
+    void rewind(const Marker& marker);
+
+    const char* getName() const { return name; }
+    size_t getUsed() const;
+    size_t getCapacity() const;
+    size_t getHighWater() const { return high_water; }
+    int getBlockCount() const { return (int)blocks.size(); }
+
+    // Scratch arena of the calling thread (main thread, each job worker). Use with a Scope.
+    static Arena& getThreadScratch();
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    const char* name;
+    size_t block_size;
+    std::vector<Block> blocks;
+    int current;                        // Block being allocated from
+    size_t offset;                      // Bytes used in the current block
+    size_t high_water;
+
+    // Prevent copying
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+};
+
+// std allocator over an Arena. Without an arena it falls back to the heap (still counted),
+// so arena-aware containers work anywhere. Memory is only reclaimed by the arena itself.
+template <class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator(Arena* _arena = nullptr, MemorySystem _system = MemorySystem::OTHER)
+        : arena(_arena), system(_system) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena), system(other.system) {}
+
+    T* allocate(size_t count) {
+        const size_t bytes = count * sizeof(T);
+        if (arena) return static_cast<T*>(arena->allocate(bytes, alignof(T), system));
+
+        MemoryStats::recordHeap(system, bytes);
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    void deallocate(T* pointer, size_t) {
+        if (!arena) ::operator delete(pointer);
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+    Arena* arena;
+    MemorySystem system;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
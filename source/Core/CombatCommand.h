@@ -0,0 +1,61 @@
+// CombatCommand.h
+// One player or AI decision, as recorded for replays
+// Commands carry intent only; all dice are re-rolled from the encounter seed on replay
+
+#pragma once
+
+#include "../Grid/GridCell.h"
+
+enum class CommandType : unsigned char {
+    STRIDE,     // Move actor to destination, spending action_cost actions
+    STRIKE,     // Actor attacks target (1 action, applies MAP)
+    END_TURN,   // Actor ends its turn
+    UNDO,       // Take back the actor's last action this turn (dice are not re-rolled)
+    REDO        // Re-apply the last undone action
+};
+
+struct CombatCommand {
+    CommandType type;
+    int actor_node_id;
+    int target_node_id;         // STRIKE only
+    GridPosition destination;   // STRIDE only
+    int action_cost;
+
+    CombatCommand()
+        : type(CommandType::END_TURN)
+        , actor_node_id(0)
+        , target_node_id(0)
+        , action_cost(0)
+    {}
+
+    static CombatCommand stride(int actor, GridPosition to, int actions) {
+        CombatCommand command;
+        command.type = CommandType::STRIDE;
+        command.actor_node_id = actor;
+        command.destination = to;
+        command.action_cost = actions;
+        return command;
+    }
+
+    static CombatCommand strike(int actor, int target) {
+        CombatCommand command;
+        command.type = CommandType::STRIKE;
+        command.actor_node_id = actor;
+        command.target_node_id = target;
+        command.action_cost = 1;
+        return command;
+    }
+
+    static CombatCommand endTurn(int actor) {
+        CombatCommand command;
+        command.actor_node_id = actor;
+        return command;
+    }
+
+    static CombatCommand make(CommandType type, int actor) {
+        CombatCommand command;
+        command.type = type;
+        command.actor_node_id = actor;
+        return command;
+    }
+};
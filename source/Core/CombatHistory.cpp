@@ -0,0 +1,267 @@
+// CombatHistory.cpp
+#include "CombatHistory.h"
+#include "TurnManager.h"
+#include "../Grid/GridSystem.h"
+#include "../Components/UnitComponent.h"
+#include "CombatantTable.h"
+#include <UnigineLog.h>
+#include <UnigineWorld.h>
+#include <UnigineComponentSystem.h>
+
+namespace {
+    const int DEFAULT_MAX_DELTAS = 4096;
+}
+
+CombatHistory::CombatHistory(GridSystem* grid_system, TurnManager* turn_mgr)
+    : grid(grid_system)
+    , turn_manager(turn_mgr)
+    , cursor(0)
+    , in_action(false)
+    , applying(false)
+    , max_deltas(DEFAULT_MAX_DELTAS)
+{
+    deltas.reserve(256);
+    actions.reserve(32);
+}
+
+CombatHistory::~CombatHistory() {
+}
+
+int CombatHistory::packPosition(GridPosition pos) {
+    // 12 bits x, 12 bits y, 8 bits z (grids up to 4096x4096, 256 elevation levels)
+    return (pos.x & 0xfff) | ((pos.y & 0xfff) << 12) | ((pos.z & 0xff) << 24);
+}
+
+GridPosition CombatHistory::unpackPosition(int packed) {
+    return GridPosition(packed & 0xfff, (packed >> 12) & 0xfff, (packed >> 24) & 0xff);
+}
+
+void CombatHistory::beginAction(const char* label) {
+    if (applying) return;
+    if (in_action) endAction();
+
+    truncateRedo();
+
+    ActionRecord action;
+    action.first_delta = deltas.size();
+    action.num_deltas = 0;
+    action.label = label;
+    actions.append(action);
+    cursor = actions.size();
+    in_action = true;
+}
+
+void CombatHistory::endAction() {
+    if (!in_action) return;
+    in_action = false;
+
+    // Drop empty steps (nothing changed)
+    if (actions.last().num_deltas == 0) {
+        actions.resize(actions.size() - 1);
+        cursor = actions.size();
+    }
+
+    enforceLimit();
+}
+
+void CombatHistory::record(DeltaType type, int key, int before, int after) {
+    if (applying || before == after) return;
+
+    turn_manager->getStateHash().applyDelta(type, key, before, after);
+
+    const bool implicit = !in_action;
+    if (implicit) beginAction("Change");
+
+    ActionRecord& action = actions.last();
+
+    // Same field changed twice in one action: keep the original 'before' only
+    for (int i = action.first_delta; i < deltas.size(); i++) {
+        if (deltas[i].type == type && deltas[i].key == key) {
+            deltas[i].after = after;
+            if (deltas[i].after == deltas[i].before) {
+                // Changed back: the delta is a no-op now
+                deltas.remove(i);
+                action.num_deltas--;
+            }
+            if (implicit) endAction();
+            return;
+        }
+    }
+
+    StateDelta delta;
+    delta.type = type;
+    delta.key = key;
+    delta.before = before;
+    delta.after = after;
+    deltas.append(delta);
+    action.num_deltas++;
+
+    if (implicit) endAction();
+}
+
+void CombatHistory::beginTurn() {
+    // Keep allocated capacity - steady-state turns do not reallocate
+    deltas.clear();
+    actions.clear();
+    cursor = 0;
+    in_action = false;
+}
+
+void CombatHistory::commit() {
+    if (in_action) endAction();
+
+    // Same as a turn boundary: everything before the roll stays as it is
+    deltas.clear();
+    actions.clear();
+    cursor = 0;
+}
+
+bool CombatHistory::undo() {
+    if (in_action) endAction();
+    if (!canUndo()) return false;
+
+    moved_units.clear();
+    applying = true;
+
+    const ActionRecord& action = actions[cursor - 1];
+    for (int i = action.first_delta + action.num_deltas - 1; i >= action.first_delta; i--) {
+        applyDelta(deltas[i], true);
+    }
+
+    applying = false;
+    cursor--;
+
+    Unigine::Log::message("CombatHistory::undo() - Undid '%s' (%d changes)\n", action.label, action.num_deltas);
+    return true;
+}
+
+bool CombatHistory::redo() {
+    if (in_action) endAction();
+    if (!canRedo()) return false;
+
+    moved_units.clear();
+    applying = true;
+
+    const ActionRecord& action = actions[cursor];
+    for (int i = action.first_delta; i < action.first_delta + action.num_deltas; i++) {
+        applyDelta(deltas[i], false);
+    }
+
+    applying = false;
+    cursor++;
+
+    Unigine::Log::message("CombatHistory::redo() - Redid '%s' (%d changes)\n", action.label, action.num_deltas);
+    return true;
+}
+
+void CombatHistory::rewindTo(int mark) {
+    if (in_action) endAction();
+    if (mark < 0) mark = 0;
+    if (mark > actions.size()) mark = actions.size();
+
+    Unigine::Vector<int> moved;
+    while (cursor > mark && undo()) moved.append(moved_units);
+    while (cursor < mark && redo()) moved.append(moved_units);
+    moved_units = moved;
+}
+
+const char* CombatHistory::getUndoLabel() const {
+    return canUndo() ? actions[cursor - 1].label : "";
+}
+
+void CombatHistory::truncateRedo() {
+    if (cursor >= actions.size()) return;
+
+    deltas.resize(cursor > 0 ? actions[cursor - 1].first_delta + actions[cursor - 1].num_deltas : 0);
+    actions.resize(cursor);
+}
+
+void CombatHistory::enforceLimit() {
+    if (deltas.size() <= max_deltas) return;
+
+    // Drop whole actions from the front until under the cap
+    int drop_actions = 0;
+    int drop_deltas = 0;
+    while (drop_actions < cursor && deltas.size() - drop_deltas > max_deltas) {
+        drop_deltas += actions[drop_actions].num_deltas;
+        drop_actions++;
+    }
+    if (drop_actions == 0) return;
+
+    for (int i = drop_deltas; i < deltas.size(); i++) {
+        deltas[i - drop_deltas] = deltas[i];
+    }
+    deltas.resize(deltas.size() - drop_deltas);
+
+    for (int i = drop_actions; i < actions.size(); i++) {
+        actions[i - drop_actions] = actions[i];
+        actions[i - drop_actions].first_delta -= drop_deltas;
+    }
+    actions.resize(actions.size() - drop_actions);
+    cursor -= drop_actions;
+}
+
+UnitComponent* CombatHistory::findUnit(int node_id) const {
+    // Node ID -> table row: no world or component lookup
+    const CombatantTable* table = CombatantTable::get();
+    const int row = table->findRow(node_id);
+    return row >= 0 ? table->component[row] : nullptr;
+}
+
+void CombatHistory::applyDelta(const StateDelta& delta, bool use_before) {
+    const int value = use_before ? delta.before : delta.after;
+
+    switch (delta.type) {
+    case DeltaType::CELL_OCCUPANT: {
+        GridPosition pos(delta.key % grid->getWidth(), delta.key / grid->getWidth());
+        if (value != 0) {
+            grid->setOccupant(pos, Unigine::World::getNodeByID(value));
+        } else {
+            grid->clearOccupant(pos);
+        }
+        break;
+    }
+    case DeltaType::CELL_BLOCKED:
+        grid->setBlocked(delta.key % grid->getWidth(), delta.key / grid->getWidth(), value != 0);
+        break;
+
+    case DeltaType::CELL_ELEVATION:
+        grid->setElevation(delta.key % grid->getWidth(), delta.key / grid->getWidth(), value);
+        break;
+
+    case DeltaType::UNIT_HP: {
+        UnitComponent* unit = findUnit(delta.key);
+        if (unit) {
+            turn_manager->getStateHash().applyDelta(DeltaType::UNIT_HP, delta.key, unit->getCurrentHP(), value);
+            unit->setCurrentHP(value);
+        }
+        break;
+    }
+    case DeltaType::UNIT_REACTION: {
+        UnitComponent* unit = findUnit(delta.key);
+        if (unit) unit->setReaction(value != 0);
+        break;
+    }
+    case DeltaType::UNIT_POSITION: {
+        UnitComponent* unit = findUnit(delta.key);
+        if (unit) {
+            turn_manager->getStateHash().applyDelta(DeltaType::UNIT_POSITION, delta.key,
+                packPosition(unit->getGridPosition()), value);
+            unit->setGridPosition(unpackPosition(value));
+            moved_units.append(delta.key);
+        }
+        break;
+    }
+    case DeltaType::TURN_ACTIONS:
+        turn_manager->restoreActionState(value, turn_manager->getAttacksThisTurn(), turn_manager->usedAgileWeapon());
+        break;
+
+    case DeltaType::TURN_ATTACKS:
+        turn_manager->restoreActionState(turn_manager->getActionsRemaining(), value, turn_manager->usedAgileWeapon());
+        break;
+
+    case DeltaType::TURN_AGILE:
+        turn_manager->restoreActionState(turn_manager->getActionsRemaining(), turn_manager->getAttacksThisTurn(), value != 0);
+        break;
+    }
+}
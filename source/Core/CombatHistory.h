@@ -0,0 +1,101 @@
+// CombatHistory.h
+// Delta-compressed undo/redo history for the current turn
+// Each action is stored as a handful of (type, key, before, after) deltas, so undo/redo
+// cost O(changed fields). History is cleared at every turn boundary, keeping memory
+// bounded by one turn's worth of actions over a full encounter, and after every roll:
+// only actions without dice (Stride) can be taken back.
+
+#pragma once
+
+#include "../Grid/GridCell.h"
+#include <UnigineVector.h>
+
+class GridSystem;
+class TurnManager;
+class UnitComponent;
+
+// What a delta changes
+enum class DeltaType : unsigned char {
+    CELL_OCCUPANT,      // key = cell index, value = occupant node ID (0 = empty)
+    CELL_BLOCKED,       // key = cell index, value = 0/1
+    CELL_ELEVATION,     // key = cell index, value = elevation level
+    UNIT_HP,            // key = node ID, value = current HP
+    UNIT_REACTION,      // key = node ID, value = 0/1
+    UNIT_POSITION,      // key = node ID, value = packed GridPosition
+    TURN_ACTIONS,       // value = actions remaining
+    TURN_ATTACKS,       // value = attacks this turn (MAP counter)
+    TURN_AGILE          // value = agile weapon used (0/1)
+};
+
+// One changed field (16 bytes)
+struct StateDelta {
+    DeltaType type;
+    int key;
+    int before;
+    int after;
+};
+
+class CombatHistory {
+public:
+    CombatHistory(GridSystem* grid_system, TurnManager* turn_manager);
+    ~CombatHistory();
+
+    // Recording: deltas between beginAction/endAction form one undoable step.
+    // Deltas recorded outside an action become a step of their own.
+    void beginAction(const char* label);
+    void endAction();
+    void record(DeltaType type, int key, int before, int after);
+
+    // Turn boundary: drops all history (undo never crosses into the previous turn)
+    void beginTurn();
+
+    // No undo past here: called after every action that rolls dice. The combat RNG has already
+    // advanced, so taking the action back would let it be retried with a fresh roll.
+    void commit();
+
+    // Undo/redo one action. Return false if there is nothing to undo/redo.
+    bool undo();
+    bool redo();
+
+    // Rewind or replay to a mark from getMark() (e.g. AI rollouts)
+    int getMark() const { return cursor; }
+    void rewindTo(int mark);
+
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor < actions.size(); }
+    bool isApplying() const { return applying; }
+    const char* getUndoLabel() const;
+
+    // Units whose grid position changed in the last undo/redo/rewind (node IDs)
+    const Unigine::Vector<int>& getMovedUnits() const { return moved_units; }
+
+    // Memory cap in deltas; the oldest actions of the turn are dropped beyond it
+    void setMaxDeltas(int max) { max_deltas = max; }
+    int getDeltaCount() const { return deltas.size(); }
+
+    static int packPosition(GridPosition pos);
+    static GridPosition unpackPosition(int packed);
+
+private:
+    struct ActionRecord {
+        int first_delta;
+        int num_deltas;
+        const char* label;      // Static string literal
+    };
+
+    GridSystem* grid;
+    TurnManager* turn_manager;
+
+    Unigine::Vector<StateDelta> deltas;
+    Unigine::Vector<ActionRecord> actions;
+    int cursor;             // Number of applied actions (actions[cursor..] are redoable)
+    bool in_action;
+    bool applying;          // Suppresses recording while undo/redo writes state
+    int max_deltas;
+    Unigine::Vector<int> moved_units;
+
+    void truncateRedo();
+    void enforceLimit();
+    void applyDelta(const StateDelta& delta, bool use_before);
+    UnitComponent* findUnit(int node_id) const;
+};
@@ -0,0 +1,58 @@
+// CombatRandom.cpp
+#include "CombatRandom.h"
+
+CombatRandom::CombatRandom(unsigned long long initial_seed)
+    : seed(0)
+    , state(0)
+    , increment(0)
+{
+    setSeed(initial_seed);
+}
+
+void CombatRandom::setSeed(unsigned long long new_seed) {
+    // Standard PCG32 seeding sequence
+    seed = new_seed;
+    state = 0;
+    increment = (new_seed << 1u) | 1u;
+    next();
+    state += new_seed;
+    next();
+}
+
+unsigned int CombatRandom::next() {
+    unsigned long long old_state = state;
+    state = old_state * 6364136223846793005ULL + increment;
+
+    unsigned int xorshifted = (unsigned int)(((old_state >> 18u) ^ old_state) >> 27u);
+    unsigned int rotation = (unsigned int)(old_state >> 59u);
+    return (xorshifted >> rotation) | (xorshifted << ((0u - rotation) & 31u));
+}
+
+int CombatRandom::rollDie(int sides) {
+    if (sides <= 1) return 1;
+
+    // Reject the top partial range so every face is equally likely
+    const unsigned int range = (unsigned int)sides;
+    const unsigned int threshold = (0u - range) % range;
+    for (;;) {
+        unsigned int value = next();
+        if (value >= threshold) {
+            return (int)(value % range) + 1;
+        }
+    }
+}
+
+void CombatRandom::rollDice(int sides, int* out, int count) {
+    if (sides <= 1) {
+        for (int i = 0; i < count; i++) out[i] = 1;
+        return;
+    }
+
+    const unsigned int range = (unsigned int)sides;
+    const unsigned int threshold = (0u - range) % range;
+    for (int i = 0; i < count; i++) {
+        unsigned int value = next();
+        while (value < threshold) value = next();
+        out[i] = (int)(value % range) + 1;
+    }
+}
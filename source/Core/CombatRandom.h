@@ -0,0 +1,29 @@
+// CombatRandom.h
+// Seeded, platform-independent RNG for combat rolls (PCG32)
+// Every roll that affects combat state must come from here so encounters replay bit-exactly
+
+#pragma once
+
+class CombatRandom {
+public:
+    explicit CombatRandom(unsigned long long seed = 0);
+
+    void setSeed(unsigned long long seed);
+    unsigned long long getSeed() const { return seed; }
+
+    // Uniform 32-bit value
+    unsigned int next();
+
+    // Uniform roll in [1, sides] (no modulo bias)
+    int rollDie(int sides);
+    int rollD20() { return rollDie(20); }
+
+    // Fill out[0..count) with rolls in [1, sides]: the same values, in the same order, as
+    // 'count' calls to rollDie (area saves roll every target's d20 up front)
+    void rollDice(int sides, int* out, int count);
+
+private:
+    unsigned long long seed;
+    unsigned long long state;
+    unsigned long long increment;
+};
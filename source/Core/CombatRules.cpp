@@ -0,0 +1,224 @@
+// CombatRules.cpp
+#include "CombatRules.h"
+#include "../Grid/GridSystem.h"
+#include <cmath>
+
+int CombatRules::getMultipleAttackPenalty(int attacks_this_turn, bool agile) {
+    // No penalty on first attack
+    if (attacks_this_turn == 0) return 0;
+
+    // Agile weapons: -4/-8
+    if (agile) {
+        if (attacks_this_turn == 1) return -4;
+        return -8;
+    }
+
+    // Standard weapons: -5/-10
+    if (attacks_this_turn == 1) return -5;
+    return -10;
+}
+
+DegreeOfSuccess CombatRules::getDegreeOfSuccess(int total, int dc, int natural) {
+    int margin = total - dc;
+    int degree;
+    if (margin >= 10) degree = (int)DegreeOfSuccess::CRITICAL_SUCCESS;
+    else if (margin >= 0) degree = (int)DegreeOfSuccess::SUCCESS;
+    else if (margin > -10) degree = (int)DegreeOfSuccess::FAILURE;
+    else degree = (int)DegreeOfSuccess::CRITICAL_FAILURE;
+
+    if (natural == 20 && degree < (int)DegreeOfSuccess::CRITICAL_SUCCESS) degree++;
+    if (natural == 1 && degree > (int)DegreeOfSuccess::CRITICAL_FAILURE) degree--;
+
+    return (DegreeOfSuccess)degree;
+}
+
+void CombatRules::getDegreesOfSuccess(const int* margin, const int* natural, int count, unsigned char* out) {
+    for (int i = 0; i < count; i++) {
+        int degree = (margin[i] >= 10) + (margin[i] >= 0) + (margin[i] > -10);
+        degree += (natural[i] == 20) & (degree < (int)DegreeOfSuccess::CRITICAL_SUCCESS);
+        degree -= (natural[i] == 1) & (degree > (int)DegreeOfSuccess::CRITICAL_FAILURE);
+        out[i] = (unsigned char)degree;
+    }
+}
+
+int CombatRules::rollInitiative(CombatRandom& rng, int perception, int* out_d20) {
+    int d20 = rng.rollD20();
+    if (out_d20) *out_d20 = d20;
+    return d20 + perception;
+}
+
+StrikeResult CombatRules::resolveStrike(CombatRandom& rng, int attack_bonus, int map, int armor_class,
+                                        const DiceExpr& damage)
+{
+    StrikeResult result;
+    result.natural = rng.rollD20();
+    result.total = result.natural + attack_bonus + map;
+    result.degree = getDegreeOfSuccess(result.total, armor_class, result.natural);
+    result.damage = 0;
+
+    if (result.degree == DegreeOfSuccess::CRITICAL_SUCCESS) {
+        result.damage = damage.rollCritical(rng);
+    } else if (result.degree == DegreeOfSuccess::SUCCESS) {
+        result.damage = damage.roll(rng);
+    }
+    return result;
+}
+
+StrikeOdds CombatRules::getStrikeOdds(int attack_bonus, int map, int armor_class, const DiceExpr& damage) {
+    StrikeOdds odds;
+    odds.hit = 0.0f;
+    odds.critical = 0.0f;
+
+    // Each d20 face is equally likely: same degree rules as resolveStrike
+    for (int natural = 1; natural <= 20; natural++) {
+        DegreeOfSuccess degree = getDegreeOfSuccess(natural + attack_bonus + map, armor_class, natural);
+        if (degree == DegreeOfSuccess::CRITICAL_SUCCESS) {
+            odds.critical += 0.05f;
+            odds.hit += 0.05f;
+        } else if (degree == DegreeOfSuccess::SUCCESS) {
+            odds.hit += 0.05f;
+        }
+    }
+
+    // Critical damage doubles the dice, not the modifier (minimum 0 ignored for averages)
+    const float normal = damage.getAverage();
+    const float critical = normal + damage.count * (damage.sides + 1) * 0.5f;
+    odds.expected_damage = (odds.hit - odds.critical) * normal + odds.critical * critical;
+    return odds;
+}
+
+bool CombatRules::canStride(const GridView& view, GridPosition from, GridPosition to, int speed_feet, int actions) {
+    if (actions < 1 || (from.x == to.x && from.y == to.y)) return false;
+
+    Unigine::Vector<GridPosition> path;
+    int cost = 0;
+    if (!Pathfinding::findPath(view, from, to, path, &cost)) return false;
+    return cost <= speed_feet * actions;
+}
+
+bool CombatRules::isInReach(GridPosition attacker, GridPosition target) {
+    const int dx = attacker.x > target.x ? attacker.x - target.x : target.x - attacker.x;
+    const int dy = attacker.y > target.y ? attacker.y - target.y : target.y - attacker.y;
+    return dx <= 1 && dy <= 1 && (dx | dy) != 0;
+}
+
+int CombatRules::getHeightAdvantage(int attacker_elevation, int target_elevation) {
+    const int bonus = (attacker_elevation - target_elevation) / 2;
+    if (bonus <= 0) return 0;
+    return bonus > 4 ? 4 : bonus;
+}
+
+int CombatRules::getCoverBonus(CoverType cover) {
+    switch (cover) {
+    case CoverType::LESSER: return 1;
+    case CoverType::STANDARD: return 2;
+    case CoverType::GREATER: return 4;
+    default: return 0;
+    }
+}
+
+namespace {
+    // Worst cover along a segment in grid space (cell (x, y) covers [x, x + 1) x [y, y + 1)),
+    // ignoring the attacker's and target's own cells. Coordinates are relative to cell
+    // (origin_x, origin_y), so the same segment samples the same cells wherever the grid
+    // (or a window of it) starts.
+    CoverType getLineCover(const GridView& terrain, const unsigned char* creatures, int origin_x, int origin_y,
+                           double x0, double y0, double x1, double y1,
+                           int attacker_index, int target_index)
+    {
+        const double length = sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+        const int samples = (int)(length * 4.0) + 2;
+
+        CoverType cover = CoverType::NONE;
+        for (int i = 1; i < samples; i++) {
+            const double t = (double)i / samples;
+            const int x = origin_x + (int)floor(x0 + (x1 - x0) * t);
+            const int y = origin_y + (int)floor(y0 + (y1 - y0) * t);
+            if (!terrain.isValid(x, y)) continue;
+
+            const int index = terrain.getIndex(x, y);
+            if (index == attacker_index || index == target_index) continue;
+            if (terrain.blocked[index]) return CoverType::STANDARD;
+            if (creatures && creatures[index]) cover = CoverType::LESSER;
+        }
+        return cover;
+    }
+}
+
+CoverType CombatRules::getCover(const GridView& terrain, const unsigned char* creatures,
+                                GridPosition attacker, GridPosition target)
+{
+    if (!terrain.isValid(attacker.x, attacker.y) || !terrain.isValid(target.x, target.y)) return CoverType::NONE;
+
+    const int attacker_index = terrain.getIndex(attacker.x, attacker.y);
+    const int target_index = terrain.getIndex(target.x, target.y);
+
+    // Corners pulled slightly inside their square so lines do not graze neighbouring cells
+    const double inset = 0.01;
+    const double corner[2] = { inset, 1.0 - inset };
+
+    CoverType best = CoverType::GREATER;
+    const int dx = target.x - attacker.x;
+    const int dy = target.y - attacker.y;
+    for (int a = 0; a < 4 && best != CoverType::NONE; a++) {
+        const double ax = corner[a & 1];
+        const double ay = corner[a >> 1];
+
+        CoverType worst = CoverType::NONE;
+        int obstructed = 0;
+        for (int t = 0; t < 4; t++) {
+            CoverType line = getLineCover(terrain, creatures, attacker.x, attacker.y, ax, ay,
+                dx + corner[t & 1], dy + corner[t >> 1], attacker_index, target_index);
+            if (line != CoverType::NONE) {
+                obstructed++;
+                if ((int)line > (int)worst) worst = line;
+            }
+        }
+
+        CoverType from_corner = obstructed == 4 ? worst : obstructed > 0 ? CoverType::LESSER : CoverType::NONE;
+        if ((int)from_corner < (int)best) best = from_corner;
+    }
+
+    // Shooting down over low cover: one step per 10ft above the target
+    const int reduction = (attacker.z - target.z) / 2;
+    if (reduction > 0) {
+        const int reduced = (int)best - reduction;
+        best = reduced > 0 ? (CoverType)reduced : CoverType::NONE;
+    }
+    return best;
+}
+
+StrikeSituation CombatRules::getStrikeSituation(const StrikeCell* window, int x0, int y0, int width, int height,
+                                                GridPosition attacker, GridPosition target)
+{
+    // Split the box into getCover's terrain and creature masks, in box coordinates
+    Unigine::Vector<unsigned char> terrain;
+    Unigine::Vector<unsigned char> creatures;
+    terrain.resize(width * height);
+    creatures.resize(width * height);
+    for (int i = 0; i < width * height; i++) {
+        terrain[i] = window[i] == StrikeCell::BLOCKED ? 1 : 0;
+        creatures[i] = window[i] == StrikeCell::CREATURE ? 1 : 0;
+    }
+
+    GridView view;
+    view.width = width;
+    view.height = height;
+    view.blocked = terrain.get();
+
+    StrikeSituation situation;
+    situation.cover = getCover(view, creatures.get(),
+        GridPosition(attacker.x - x0, attacker.y - y0, attacker.z),
+        GridPosition(target.x - x0, target.y - y0, target.z));
+    situation.cover_bonus = getCoverBonus(situation.cover);
+    situation.height_bonus = getHeightAdvantage(attacker.z, target.z);
+    return situation;
+}
+
+StrikeSituation CombatRules::getStrikeSituation(const GridSystem& grid, GridPosition attacker, GridPosition target) {
+    return getStrikeSituation(attacker, target, [&grid](int x, int y) {
+        const GridCell* cell = grid.getCell(x, y);
+        if (cell->isOccupied()) return StrikeCell::CREATURE;
+        return cell->blocked ? StrikeCell::BLOCKED : StrikeCell::EMPTY;
+    });
+}
@@ -0,0 +1,157 @@
+// CombatRules.h
+// PF2e rule functions shared by live combat (TurnManager/GameManager) and headless replays
+// Pure functions of their inputs and the CombatRandom stream
+
+#pragma once
+
+#include "CombatRandom.h"
+#include "Dice.h"
+#include "../Grid/Pathfinding.h"
+#include <UnigineVector.h>
+
+class GridSystem;
+
+enum class DegreeOfSuccess {
+    CRITICAL_FAILURE,
+    FAILURE,
+    SUCCESS,
+    CRITICAL_SUCCESS
+};
+
+struct StrikeResult {
+    int natural;                // d20 face
+    int total;                  // d20 + attack bonus + MAP
+    DegreeOfSuccess degree;
+    int damage;                 // 0 unless success / critical success
+};
+
+// Cover from terrain and creatures between attacker and target (GDD Movement-Grid-System)
+enum class CoverType {
+    NONE,
+    LESSER,     // +1 AC (creatures, small obstacles)
+    STANDARD,   // +2 AC (walls, blocked terrain)
+    GREATER     // +4 AC (arrow slits)
+};
+
+// Battlefield modifiers of one Strike (getStrikeSituation)
+struct StrikeSituation {
+    CoverType cover;
+    int cover_bonus;        // Added to the target's AC
+    int height_bonus;       // Added to the attack roll
+};
+
+// Cell contents a Strike's cover is read from
+enum class StrikeCell : unsigned char {
+    EMPTY,
+    CREATURE,   // Any unit, living or not (lesser cover)
+    BLOCKED     // Impassable terrain (standard cover)
+};
+
+// Expected outcome of one Strike, from the full d20 distribution
+struct StrikeOdds {
+    float hit;              // Success or better (includes crits)
+    float critical;         // Critical success
+    float expected_damage;  // Average damage per Strike
+};
+
+namespace CombatRules {
+    // Multiple Attack Penalty for the next attack: 0 / -5 / -10 (agile: 0 / -4 / -8)
+    int getMultipleAttackPenalty(int attacks_this_turn, bool agile);
+
+    // Degree of success: margin >= 10 crit, >= 0 success, > -10 failure, else crit failure.
+    // Natural 20 improves and natural 1 worsens the degree by one step.
+    DegreeOfSuccess getDegreeOfSuccess(int total, int dc, int natural);
+
+    // getDegreeOfSuccess over columns: margin = total - dc, natural = d20 face. Branch-free so
+    // the compiler can vectorise it; out[i] is a DegreeOfSuccess value.
+    void getDegreesOfSuccess(const int* margin, const int* natural, int count, unsigned char* out);
+
+    // Initiative = 1d20 + Perception. Consumes one d20 from rng.
+    int rollInitiative(CombatRandom& rng, int perception, int* out_d20 = nullptr);
+
+    // Strike: d20 + attack_bonus + map vs armor_class, then damage. Consumes rolls from rng
+    // in a fixed order (d20, then damage dice only on a hit).
+    StrikeResult resolveStrike(CombatRandom& rng, int attack_bonus, int map, int armor_class,
+                               const DiceExpr& damage);
+
+    // Exact odds of resolveStrike (no rolls consumed)
+    StrikeOdds getStrikeOdds(int attack_bonus, int map, int armor_class, const DiceExpr& damage);
+
+    // Height advantage: +1 to attack per 10ft (2 levels) above the target, max +4
+    int getHeightAdvantage(int attacker_elevation, int target_elevation);
+
+    int getCoverBonus(CoverType cover);
+
+    // Corner-to-corner cover: from the attacker corner with the clearest view, lines to the
+    // target's corners through blocked terrain (standard) or creatures (lesser). All four lines
+    // obstructed = the worst cover found, some = lesser, none = no cover. Every 10ft the
+    // attacker stands above the target lowers cover one step. 'creatures' may be nullptr.
+    CoverType getCover(const GridView& terrain, const unsigned char* creatures,
+                       GridPosition attacker, GridPosition target);
+
+    // Cover and height advantage of a Strike - the one implementation behind the hover preview,
+    // live Strikes and CombatSimulation. Cover lines never leave the bounding box of the two
+    // cells, so only that box is read: cell(x, y) returns the StrikeCell of a cell on the grid.
+    template <class CellReader>
+    StrikeSituation getStrikeSituation(GridPosition attacker, GridPosition target, const CellReader& cell);
+
+    // getStrikeSituation against the live grid (hover preview, GameManager::executeCommand)
+    StrikeSituation getStrikeSituation(const GridSystem& grid, GridPosition attacker, GridPosition target);
+
+    // getStrikeSituation over a copied box: window[(y - y0) * width + (x - x0)]
+    StrikeSituation getStrikeSituation(const StrikeCell* window, int x0, int y0, int width, int height,
+                                       GridPosition attacker, GridPosition target);
+
+    // Stride legality, shared by live commands and CombatSimulation: 'to' is another cell,
+    // reachable over 'view' (terrain plus units the mover cannot pass) within speed_feet for each
+    // of the actions spent. Whether the destination is free is the caller's check.
+    bool canStride(const GridView& view, GridPosition from, GridPosition to, int speed_feet, int actions);
+
+    // Melee reach: a Strike hits any of the 8 surrounding cells
+    bool isInReach(GridPosition attacker, GridPosition target);
+
+    // Sort entries by initiative_value (highest first); ties go to is_player_unit.
+    // Works on any entry type with those two fields so live and replay orders match exactly.
+    template <class Container>
+    void sortInitiative(Container& entries) {
+        const int count = (int)entries.size();
+        for (int i = 0; i < count - 1; i++) {
+            for (int j = i + 1; j < count; j++) {
+                bool should_swap = false;
+
+                if (entries[i].initiative_value < entries[j].initiative_value) {
+                    // j has higher initiative
+                    should_swap = true;
+                } else if (entries[i].initiative_value == entries[j].initiative_value) {
+                    // Tie: player units go first
+                    if (!entries[i].is_player_unit && entries[j].is_player_unit) {
+                        should_swap = true;
+                    }
+                }
+
+                if (should_swap) {
+                    auto temp = entries[i];
+                    entries[i] = entries[j];
+                    entries[j] = temp;
+                }
+            }
+        }
+    }
+}
+
+template <class CellReader>
+StrikeSituation CombatRules::getStrikeSituation(GridPosition attacker, GridPosition target, const CellReader& cell) {
+    const int x0 = attacker.x < target.x ? attacker.x : target.x;
+    const int y0 = attacker.y < target.y ? attacker.y : target.y;
+    const int width = (attacker.x < target.x ? target.x - attacker.x : attacker.x - target.x) + 1;
+    const int height = (attacker.y < target.y ? target.y - attacker.y : attacker.y - target.y) + 1;
+
+    Unigine::Vector<StrikeCell> window;
+    window.resize(width * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            window[y * width + x] = cell(x0 + x, y0 + y);
+        }
+    }
+    return getStrikeSituation(window.get(), x0, y0, width, height, attacker, target);
+}
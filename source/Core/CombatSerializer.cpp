@@ -0,0 +1,558 @@
+// CombatSerializer.cpp
+#include "CombatSerializer.h"
+#include "TurnManager.h"
+#include "CombatHistory.h"
+#include "../Grid/GridSystem.h"
+#include "../Components/UnitComponent.h"
+#include "CombatantTable.h"
+#include "UnitPool.h"
+#include "../Data/UnitDatabase.h"
+#include "../Spells/SpellSystem.h"
+#include <UnigineLog.h>
+#include <UnigineWorld.h>
+#include <UnigineComponentSystem.h>
+#include <UnigineVector.h>
+#include <UnigineHashMap.h>
+#include <chrono>
+
+using namespace Unigine;
+
+namespace {
+    // Per-unit fields, stored field-major (all HP values, then all AC values, ...)
+    enum UnitField {
+        FIELD_NODE_ID,
+        FIELD_LEVEL,
+        FIELD_MAX_HP,
+        FIELD_CURRENT_HP,
+        FIELD_ARMOR_CLASS,
+        FIELD_SPEED,
+        FIELD_STRENGTH,
+        FIELD_DEXTERITY,
+        FIELD_CONSTITUTION,
+        FIELD_INTELLIGENCE,
+        FIELD_WISDOM,
+        FIELD_CHARISMA,
+        FIELD_FORTITUDE,
+        FIELD_REFLEX,
+        FIELD_WILL,
+        FIELD_ATTACK_BONUS,
+        FIELD_INITIATIVE,
+        FIELD_ACTIONS,
+        FIELD_MAP,
+        FIELD_REACTION,
+        FIELD_POSITION,         // CombatHistory::packPosition
+        FIELD_POOL_UNIT,        // 1 = created by the UnitPool (version 4)
+        NUM_UNIT_FIELDS
+    };
+
+    // Spell effect fields (field-major, like units)
+    enum EffectField {
+        EFFECT_TARGET,
+        EFFECT_SOURCE,
+        EFFECT_SPELL,
+        EFFECT_KIND,
+        EFFECT_VALUE,
+        EFFECT_ROUNDS,
+        NUM_EFFECT_FIELDS
+    };
+
+    // Aura fields (field-major); members follow in one flat array, aura by aura
+    enum AuraField {
+        AURA_SOURCE,
+        AURA_SPELL,
+        AURA_ORIGIN,            // CombatHistory::packPosition
+        AURA_RADIUS,
+        AURA_FILTER,
+        AURA_FACTION,
+        AURA_KIND,
+        AURA_VALUE,
+        AURA_ROUNDS,
+        AURA_MEMBERS,           // Member count
+        NUM_AURA_FIELDS
+    };
+
+    double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    template <class T>
+    bool writeArray(const StreamPtr& stream, const Vector<T>& data) {
+        size_t bytes = sizeof(T) * data.size();
+        stream->writeInt(data.size());
+        return bytes == 0 || stream->write(data.get(), bytes) == bytes;
+    }
+
+    template <class T>
+    bool readArray(const StreamPtr& stream, Vector<T>& data, int expected_size) {
+        int size = stream->readInt();
+        if (size != expected_size) return false;
+
+        data.resize(size);
+        size_t bytes = sizeof(T) * size;
+        return bytes == 0 || stream->read(data.get(), bytes) == bytes;
+    }
+
+    UnitComponent* findUnit(int node_id) {
+        NodePtr node = World::getNodeByID(node_id);
+        return node ? ComponentSystem::get()->getComponent<UnitComponent>(node) : nullptr;
+    }
+}
+
+bool CombatSerializer::save(const StreamPtr& stream, GridSystem* grid, TurnManager* turn_manager,
+                            const SpellSystem* spells, const UnitPool* pool)
+{
+    // Unit properties are read below: flush the dense table's changes to them first
+    CombatantTable::get()->writeBack();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    stream->writeInt(MAGIC);
+    stream->writeInt(VERSION);
+
+    // Grid: three flat per-cell tables
+    const int width = grid->getWidth();
+    const int height = grid->getHeight();
+    const int num_cells = width * height;
+
+    Vector<unsigned char> blocked;
+    Vector<short> elevation;
+    Vector<int> occupant;
+    blocked.resize(num_cells);
+    elevation.resize(num_cells);
+    occupant.resize(num_cells);
+    for (int i = 0; i < num_cells; i++) {
+        const GridCell* cell = grid->getCell(i % width, i / width);
+        blocked[i] = cell->blocked ? 1 : 0;
+        elevation[i] = (short)cell->elevation;
+        occupant[i] = cell->isOccupied() ? cell->occupant->getID() : 0;
+    }
+
+    stream->writeInt(width);
+    stream->writeInt(height);
+    bool ok = writeArray(stream, blocked);
+    ok = ok && writeArray(stream, elevation);
+    ok = ok && writeArray(stream, occupant);
+
+    // Turn state
+    stream->writeInt(turn_manager->isCombatActive() ? 1 : 0);
+    stream->writeInt(turn_manager->getCurrentRound());
+    stream->writeInt(turn_manager->getCurrentTurnIndex());
+    stream->writeInt(turn_manager->getActionsRemaining());
+    stream->writeInt(turn_manager->getAttacksThisTurn());
+    stream->writeInt(turn_manager->usedAgileWeapon() ? 1 : 0);
+
+    // Initiative order + unit table
+    const int num_units = turn_manager->getInitiativeCount();
+    Vector<int> initiative;
+    Vector<unsigned char> is_player;
+    Vector<int> units;
+    initiative.resize(num_units);
+    is_player.resize(num_units);
+    units.resize(num_units * NUM_UNIT_FIELDS);
+    for (int i = 0; i < units.size(); i++) {
+        units[i] = 0;
+    }
+
+    for (int i = 0; i < num_units; i++) {
+        const InitiativeEntry& entry = turn_manager->getInitiativeEntry(i);
+        initiative[i] = entry.initiative_value;
+        is_player[i] = entry.is_player_unit ? 1 : 0;
+
+        UnitComponent* unit = entry.unit_component;
+        if (!unit) continue;
+
+        int* field = units.get() + i;
+        field[FIELD_NODE_ID * num_units] = entry.unit_node ? entry.unit_node->getID() : 0;
+        field[FIELD_CURRENT_HP * num_units] = unit->getCurrentHP();
+
+        // Named blocks are saved by ID (block_ids below); only anonymous ones carry their stats
+        const StatBlock& stats = unit->getStats();
+        if (stats.id[0] == '\0') {
+            field[FIELD_LEVEL * num_units] = stats.level;
+            field[FIELD_MAX_HP * num_units] = stats.max_hp;
+            field[FIELD_ARMOR_CLASS * num_units] = stats.armor_class;
+            field[FIELD_SPEED * num_units] = stats.speed;
+            field[FIELD_STRENGTH * num_units] = stats.strength;
+            field[FIELD_DEXTERITY * num_units] = stats.dexterity;
+            field[FIELD_CONSTITUTION * num_units] = stats.constitution;
+            field[FIELD_INTELLIGENCE * num_units] = stats.intelligence;
+            field[FIELD_WISDOM * num_units] = stats.wisdom;
+            field[FIELD_CHARISMA * num_units] = stats.charisma;
+            field[FIELD_FORTITUDE * num_units] = stats.fortitude;
+            field[FIELD_REFLEX * num_units] = stats.reflex;
+            field[FIELD_WILL * num_units] = stats.will;
+            field[FIELD_ATTACK_BONUS * num_units] = stats.attack_bonus;
+        }
+        field[FIELD_INITIATIVE * num_units] = unit->initiative;
+        field[FIELD_ACTIONS * num_units] = unit->actions_remaining;
+        field[FIELD_MAP * num_units] = unit->current_map;
+        field[FIELD_REACTION * num_units] = unit->has_reaction;
+        field[FIELD_POSITION * num_units] = CombatHistory::packPosition(unit->getGridPosition());
+        field[FIELD_POOL_UNIT * num_units] = pool && pool->owns(unit) ? 1 : 0;
+    }
+
+    stream->writeInt(num_units);
+    stream->writeInt(NUM_UNIT_FIELDS);
+    ok = ok && writeArray(stream, initiative);
+    ok = ok && writeArray(stream, is_player);
+    ok = ok && writeArray(stream, units);
+
+    // Stat block ID per unit ("" = anonymous: the unit's saved stat fields are its block)
+    for (int i = 0; i < num_units; i++) {
+        UnitComponent* unit = turn_manager->getInitiativeEntry(i).unit_component;
+        stream->writeString(unit ? unit->getStats().id : "");
+    }
+
+    // Spell effects (aura effects included) and the auras that grant them
+    Vector<int> effect_fields;
+    Vector<int> aura_fields;
+    Vector<int> members;
+    const Vector<ActiveEffect>* effects = spells ? &spells->getEffects().getEffects() : nullptr;
+    const int num_effects = effects ? effects->size() : 0;
+    const int num_auras = spells ? spells->getAuras().getNumAuras() : 0;
+
+    effect_fields.resize(num_effects * NUM_EFFECT_FIELDS);
+    for (int i = 0; i < num_effects; i++) {
+        const ActiveEffect& effect = (*effects)[i];
+        int* field = effect_fields.get() + i;
+        field[EFFECT_TARGET * num_effects] = effect.target;
+        field[EFFECT_SOURCE * num_effects] = effect.source;
+        field[EFFECT_SPELL * num_effects] = effect.spell;
+        field[EFFECT_KIND * num_effects] = (int)effect.kind;
+        field[EFFECT_VALUE * num_effects] = effect.value;
+        field[EFFECT_ROUNDS * num_effects] = effect.rounds;
+    }
+
+    aura_fields.resize(num_auras * NUM_AURA_FIELDS);
+    for (int i = 0; i < num_auras; i++) {
+        const Aura& aura = spells->getAuras().getAura(i);
+        int* field = aura_fields.get() + i;
+        field[AURA_SOURCE * num_auras] = aura.source;
+        field[AURA_SPELL * num_auras] = aura.spell;
+        field[AURA_ORIGIN * num_auras] = CombatHistory::packPosition(aura.origin);
+        field[AURA_RADIUS * num_auras] = aura.radius_feet;
+        field[AURA_FILTER * num_auras] = (int)aura.filter;
+        field[AURA_FACTION * num_auras] = aura.faction;
+        field[AURA_KIND * num_auras] = (int)aura.kind;
+        field[AURA_VALUE * num_auras] = aura.value;
+        field[AURA_ROUNDS * num_auras] = aura.rounds;
+        field[AURA_MEMBERS * num_auras] = aura.members.size();
+        members.append(aura.members);
+    }
+
+    stream->writeInt(num_effects);
+    stream->writeInt(NUM_EFFECT_FIELDS);
+    ok = ok && writeArray(stream, effect_fields);
+    stream->writeInt(num_auras);
+    stream->writeInt(NUM_AURA_FIELDS);
+    ok = ok && writeArray(stream, aura_fields);
+    ok = ok && writeArray(stream, members);
+
+    if (!ok) {
+        Log::error("CombatSerializer::save() - Stream write failed\n");
+        return false;
+    }
+
+    Log::message("CombatSerializer::save() - Saved %dx%d grid, %d units, %d effects, %d auras in %.2f ms\n",
+        width, height, num_units, num_effects, num_auras, elapsedMs(start));
+    return true;
+}
+
+bool CombatSerializer::restore(const StreamPtr& stream, GridSystem* grid, TurnManager* turn_manager,
+                               SpellSystem* spells, UnitPool* pool)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (stream->readInt() != MAGIC) {
+        Log::error("CombatSerializer::restore() - Not a combat save\n");
+        return false;
+    }
+
+    int version = stream->readInt();
+    if (version < 1 || version > VERSION) {
+        Log::error("CombatSerializer::restore() - Unsupported save version %d (expected <= %d)\n", version, VERSION);
+        return false;
+    }
+
+    // Grid
+    const int width = stream->readInt();
+    const int height = stream->readInt();
+    if (width != grid->getWidth() || height != grid->getHeight()) {
+        Log::error("CombatSerializer::restore() - Grid size mismatch: save %dx%d, world %dx%d\n",
+            width, height, grid->getWidth(), grid->getHeight());
+        return false;
+    }
+
+    const int num_cells = width * height;
+    Vector<unsigned char> blocked;
+    Vector<short> elevation;
+    Vector<int> occupant;
+    if (!readArray(stream, blocked, num_cells) || !readArray(stream, elevation, num_cells)
+        || !readArray(stream, occupant, num_cells)) {
+        Log::error("CombatSerializer::restore() - Corrupt grid section\n");
+        return false;
+    }
+
+    // Turn state
+    const bool combat_active = stream->readInt() != 0;
+    const int round = stream->readInt();
+    const int turn_index = stream->readInt();
+    const int actions = stream->readInt();
+    const int attacks = stream->readInt();
+    const bool agile = stream->readInt() != 0;
+
+    // Initiative + units
+    // Fields are only ever appended: an older save's table is a prefix (zero-filled below)
+    const int num_units = stream->readInt();
+    const int num_fields = stream->readInt();
+    const int expected_fields = version >= 4 ? NUM_UNIT_FIELDS : FIELD_POOL_UNIT;
+    if (num_units < 0 || num_fields != expected_fields) {
+        Log::error("CombatSerializer::restore() - Corrupt unit section\n");
+        return false;
+    }
+
+    Vector<int> initiative;
+    Vector<unsigned char> is_player;
+    Vector<int> units;
+    if (!readArray(stream, initiative, num_units) || !readArray(stream, is_player, num_units)
+        || !readArray(stream, units, num_units * num_fields)) {
+        Log::error("CombatSerializer::restore() - Corrupt unit section\n");
+        return false;
+    }
+    units.resize(num_units * NUM_UNIT_FIELDS);
+    for (int i = num_units * num_fields; i < units.size(); i++) {
+        units[i] = 0;
+    }
+
+    // Pool nodes are created at load: a saved pool unit must still be one of this session's
+    for (int i = 0; i < num_units; i++) {
+        const int* field = units.get() + i;
+        if (!field[FIELD_POOL_UNIT * num_units]) continue;
+
+        UnitComponent* unit = findUnit(field[FIELD_NODE_ID * num_units]);
+        if (!pool || !unit || !pool->owns(unit)) {
+            Log::error("CombatSerializer::restore() - Pool unit node %d not found\n", field[FIELD_NODE_ID * num_units]);
+            return false;
+        }
+    }
+
+    // Stat block IDs (before version 3 every unit's stats came from its saved fields)
+    Vector<String> block_ids;
+    block_ids.resize(num_units);
+    for (int i = 0; version >= 3 && i < num_units; i++) {
+        block_ids[i] = stream->readString();
+        if (!block_ids[i].empty() && UnitDatabase::get()->findBlock(block_ids[i].get()) == UnitDatabase::INVALID_ID) {
+            Log::error("CombatSerializer::restore() - Unknown stat block '%s'\n", block_ids[i].get());
+            return false;
+        }
+    }
+
+    // Spell effects and auras (version 1 reserved an always-empty effect count)
+    Vector<int> effect_fields;
+    Vector<int> aura_fields;
+    Vector<int> members;
+    int num_effects = stream->readInt();
+    int num_auras = 0;
+    if (version >= 2) {
+        const int effect_field_count = stream->readInt();
+        if (num_effects < 0 || effect_field_count != NUM_EFFECT_FIELDS
+            || !readArray(stream, effect_fields, num_effects * NUM_EFFECT_FIELDS)) {
+            Log::error("CombatSerializer::restore() - Corrupt effect section\n");
+            return false;
+        }
+
+        num_auras = stream->readInt();
+        const int aura_field_count = stream->readInt();
+        if (num_auras < 0 || aura_field_count != NUM_AURA_FIELDS
+            || !readArray(stream, aura_fields, num_auras * NUM_AURA_FIELDS)) {
+            Log::error("CombatSerializer::restore() - Corrupt aura section\n");
+            return false;
+        }
+
+        int num_members = 0;
+        for (int i = 0; i < num_auras; i++) {
+            const int count = aura_fields[AURA_MEMBERS * num_auras + i];
+            if (count < 0) {
+                Log::error("CombatSerializer::restore() - Corrupt aura section\n");
+                return false;
+            }
+            num_members += count;
+        }
+        if (!readArray(stream, members, num_members)) {
+            Log::error("CombatSerializer::restore() - Corrupt aura section\n");
+            return false;
+        }
+        // Spell indices and enums must be known to this build (a save from a different spell list)
+        for (int i = 0; spells && i < num_effects; i++) {
+            const int spell = effect_fields[EFFECT_SPELL * num_effects + i];
+            const int kind = effect_fields[EFFECT_KIND * num_effects + i];
+            if (spell < -1 || spell >= spells->getNumSpells() || kind < 0 || kind >= (int)EffectKind::COUNT) {
+                Log::error("CombatSerializer::restore() - Effect %d has unknown spell %d or kind %d\n", i, spell, kind);
+                return false;
+            }
+        }
+        for (int i = 0; spells && i < num_auras; i++) {
+            const int spell = aura_fields[AURA_SPELL * num_auras + i];
+            const int kind = aura_fields[AURA_KIND * num_auras + i];
+            const int filter = aura_fields[AURA_FILTER * num_auras + i];
+            if (spell < 0 || spell >= spells->getNumSpells() || kind < 0 || kind >= (int)EffectKind::COUNT
+                || filter < 0 || filter > (int)SpellFilter::ENEMIES) {
+                Log::error("CombatSerializer::restore() - Aura %d has unknown spell %d, kind %d or filter %d\n",
+                    i, spell, kind, filter);
+                return false;
+            }
+        }
+    } else {
+        num_effects = 0;
+    }
+
+    // Everything read and validated: apply. The current session's effects and auras end first,
+    // so placing units below does not move them through auras that are being replaced.
+    if (spells) spells->endCombat();
+
+    // Grid first, only cells that differ
+    for (int i = 0; i < num_cells; i++) {
+        const int x = i % width;
+        const int y = i / width;
+        GridCell* cell = grid->getCell(x, y);
+
+        if (cell->blocked != (blocked[i] != 0)) grid->setBlocked(x, y, blocked[i] != 0);
+        if (cell->elevation != elevation[i]) grid->setElevation(x, y, elevation[i]);
+
+        const int current = cell->isOccupied() ? cell->occupant->getID() : 0;
+        if (current != occupant[i]) {
+            if (occupant[i] != 0) {
+                grid->setOccupant(GridPosition(x, y), World::getNodeByID(occupant[i]));
+            } else {
+                grid->clearOccupant(GridPosition(x, y));
+            }
+        }
+    }
+
+    // Pool units: keep the ones the save holds (in the initiative or on a cell), return the rest.
+    // A kept unit released after the save comes back out of the pool where the save had it.
+    if (pool) {
+        HashMap<int, int> kept;
+        for (int i = 0; i < num_units; i++) {
+            const int* field = units.get() + i;
+            kept.append(field[FIELD_NODE_ID * num_units], field[FIELD_POSITION * num_units]);
+        }
+        for (int i = 0; i < num_cells; i++) {
+            if (occupant[i] != 0 && !kept.contains(occupant[i])) {
+                kept.append(occupant[i], CombatHistory::packPosition(GridPosition(i % width, i / width)));
+            }
+        }
+
+        Vector<UnitComponent*> pool_units;
+        pool->getUnits(pool_units);
+        for (int i = 0; i < pool_units.size(); i++) {
+            UnitComponent* unit = pool_units[i];
+            HashMap<int, int>::Iterator it = kept.find(unit->getNode()->getID());
+            if (it == kept.end()) {
+                pool->release(unit);
+            } else if (unit->pooled) {
+                pool->claim(unit, CombatHistory::unpackPosition(it->data));
+            }
+        }
+    }
+
+    Vector<InitiativeEntry> order;
+    order.reserve(num_units);
+    for (int i = 0; i < num_units; i++) {
+        const int* field = units.get() + i;
+        UnitComponent* unit = findUnit(field[FIELD_NODE_ID * num_units]);
+        if (!unit) {
+            Log::warning("CombatSerializer::restore() - Unit node %d not found, skipped\n", field[FIELD_NODE_ID * num_units]);
+            continue;
+        }
+
+        // Stat properties are read only for anonymous blocks (CombatantTable::pull)
+        unit->stat_block = block_ids[i].get();
+        if (block_ids[i].empty()) {
+            unit->level = field[FIELD_LEVEL * num_units];
+            unit->max_hp = field[FIELD_MAX_HP * num_units];
+            unit->armor_class = field[FIELD_ARMOR_CLASS * num_units];
+            unit->speed = field[FIELD_SPEED * num_units];
+            unit->strength = field[FIELD_STRENGTH * num_units];
+            unit->dexterity = field[FIELD_DEXTERITY * num_units];
+            unit->constitution = field[FIELD_CONSTITUTION * num_units];
+            unit->intelligence = field[FIELD_INTELLIGENCE * num_units];
+            unit->wisdom = field[FIELD_WISDOM * num_units];
+            unit->charisma = field[FIELD_CHARISMA * num_units];
+            unit->fortitude_save = field[FIELD_FORTITUDE * num_units];
+            unit->reflex_save = field[FIELD_REFLEX * num_units];
+            unit->will_save = field[FIELD_WILL * num_units];
+            unit->attack_bonus = field[FIELD_ATTACK_BONUS * num_units];
+        }
+        unit->current_hp = field[FIELD_CURRENT_HP * num_units];
+        unit->initiative = field[FIELD_INITIATIVE * num_units];
+        unit->actions_remaining = field[FIELD_ACTIONS * num_units];
+        unit->current_map = field[FIELD_MAP * num_units];
+        unit->has_reaction = field[FIELD_REACTION * num_units];
+
+        // Properties are authoritative after a load: refresh the unit's table row from them
+        if (unit->table_row >= 0) CombatantTable::get()->pull(unit->table_row);
+        unit->setGridPosition(CombatHistory::unpackPosition(field[FIELD_POSITION * num_units]));
+
+        InitiativeEntry entry;
+        entry.unit_node = unit->getNode();
+        entry.unit_component = unit;
+        entry.initiative_value = initiative[i];
+        entry.is_player_unit = is_player[i] != 0;
+        order.append(entry);
+    }
+
+    if (combat_active) {
+        turn_manager->restoreCombat(order, round, turn_index);
+        turn_manager->restoreActionState(actions, attacks, agile);
+    } else {
+        turn_manager->endCombat();
+    }
+
+    // Effects and auras as saved, members included (auras are not rescanned)
+    Vector<ActiveEffect> effects;
+    Vector<Aura> auras;
+    if (spells) {
+        effects.resize(num_effects);
+        for (int i = 0; i < num_effects; i++) {
+            const int* field = effect_fields.get() + i;
+            ActiveEffect& effect = effects[i];
+            effect.target = field[EFFECT_TARGET * num_effects];
+            effect.source = field[EFFECT_SOURCE * num_effects];
+            effect.spell = field[EFFECT_SPELL * num_effects];
+            effect.kind = (EffectKind)field[EFFECT_KIND * num_effects];
+            effect.value = field[EFFECT_VALUE * num_effects];
+            effect.rounds = field[EFFECT_ROUNDS * num_effects];
+        }
+
+        auras.resize(num_auras);
+        int member = 0;
+        for (int i = 0; i < num_auras; i++) {
+            const int* field = aura_fields.get() + i;
+            Aura& aura = auras[i];
+            aura.source = field[AURA_SOURCE * num_auras];
+            aura.spell = field[AURA_SPELL * num_auras];
+            aura.origin = CombatHistory::unpackPosition(field[AURA_ORIGIN * num_auras]);
+            aura.radius_feet = field[AURA_RADIUS * num_auras];
+            aura.filter = (SpellFilter)field[AURA_FILTER * num_auras];
+            aura.faction = (unsigned char)field[AURA_FACTION * num_auras];
+            aura.kind = (EffectKind)field[AURA_KIND * num_auras];
+            aura.value = field[AURA_VALUE * num_auras];
+            aura.rounds = field[AURA_ROUNDS * num_auras];
+
+            const int count = field[AURA_MEMBERS * num_auras];
+            aura.members.clear();
+            for (int m = 0; m < count; m++) {
+                aura.members.append(members[member++]);
+            }
+        }
+        spells->restoreEffects(effects, auras);
+    } else if (num_effects > 0 || num_auras > 0) {
+        Log::warning("CombatSerializer::restore() - No spell system, %d effects and %d auras ignored\n",
+            num_effects, num_auras);
+    }
+
+    Log::message("CombatSerializer::restore() - Restored %dx%d grid, %d units, %d effects, %d auras in %.2f ms\n",
+        width, height, order.size(), effects.size(), auras.size(), elapsedMs(start));
+    return true;
+}
@@ -0,0 +1,30 @@
+// CombatSerializer.h
+// Versioned binary save/restore of in-progress combat (grid, initiative, turn state, units,
+// spell effects and auras)
+// Called from AppWorldLogic::save/restore through GameManager. Every per-cell and per-unit
+// table is staged into a flat array and written with a single Stream::write() call.
+
+#pragma once
+
+#include <UnigineStreams.h>
+
+class GridSystem;
+class TurnManager;
+class SpellSystem;
+class UnitPool;
+
+namespace CombatSerializer {
+    const int MAGIC = 0x43554E41;   // "ANUC"
+    const int VERSION = 4;      // 2: spell effects and auras, 3: unit stat block IDs, 4: pool units
+
+    // Write the full combat state. Returns false on stream errors. spells and pool may be nullptr.
+    bool save(const Unigine::StreamPtr& stream, GridSystem* grid, TurnManager* turn_manager,
+              const SpellSystem* spells, const UnitPool* pool);
+
+    // Read a state written by save(). The grid must have the same dimensions.
+    // Attach no undo recorder while restoring - the result is a new baseline. Effects and auras
+    // in play are replaced by the saved ones (none for version 1 saves). Pool units the save
+    // does not hold go back to the pool; saved ones released since are taken out of it.
+    bool restore(const Unigine::StreamPtr& stream, GridSystem* grid, TurnManager* turn_manager,
+                 SpellSystem* spells, UnitPool* pool);
+}
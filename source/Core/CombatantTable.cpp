@@ -0,0 +1,129 @@
+// CombatantTable.cpp
+#include "CombatantTable.h"
+#include "../Components/UnitComponent.h"
+#include <UnigineLog.h>
+
+CombatantTable* CombatantTable::get() {
+    static CombatantTable table;
+    return &table;
+}
+
+int CombatantTable::add(UnitComponent* unit) {
+    const int row = size();
+    resizeColumns(row + 1);
+
+    component[row] = unit;
+    position[row] = GridPosition(0, 0, 0);
+    faction[row] = (unsigned char)Faction::NONE;
+    pull(row);
+
+    // Units created from a named stat block start at full HP
+    if (getStats(row).id[0] != '\0') {
+        current_hp[row] = getStats(row).max_hp;
+        dirty[row] = 1;
+    }
+
+    row_by_node.append(node_id[row], row);
+    return row;
+}
+
+void CombatantTable::remove(int row) {
+    if (row < 0 || row >= size()) return;
+
+    row_by_node.remove(node_id[row]);
+
+    const int last = size() - 1;
+    if (row != last) {
+        copyRow(last, row);
+        component[row]->table_row = row;
+        row_by_node[node_id[row]] = row;
+    }
+    resizeColumns(last);
+}
+
+void CombatantTable::pull(int row) {
+    UnitComponent* unit = component[row];
+
+    node_id[row] = unit->getNode() ? unit->getNode()->getID() : 0;
+
+    // Named stat block from the database, else a (shared) block built from the unit's properties
+    UnitDatabase* database = UnitDatabase::get();
+    int block = UnitDatabase::INVALID_ID;
+    const char* block_id = unit->stat_block.get();
+    if (block_id && block_id[0] != '\0') {
+        block = database->findBlock(block_id);
+        if (block == UnitDatabase::INVALID_ID) {
+            Unigine::Log::warning("CombatantTable::pull() - Unknown stat block '%s' on %s, using its properties\n",
+                block_id, unit->unit_name.get());
+        }
+    }
+    if (block == UnitDatabase::INVALID_ID) {
+        block = database->registerFromProperties(unit);
+    }
+    stat_block[row] = block;
+
+    current_hp[row] = unit->current_hp;
+    initiative[row] = unit->initiative;
+    actions_remaining[row] = unit->actions_remaining;
+    current_map[row] = unit->current_map;
+    has_reaction[row] = unit->has_reaction ? 1 : 0;
+    dirty[row] = 0;
+}
+
+void CombatantTable::resetState(int row) {
+    current_hp[row] = getStats(row).max_hp;
+    initiative[row] = 0;
+    actions_remaining[row] = 3;
+    current_map[row] = 0;
+    has_reaction[row] = 1;
+    position[row] = GridPosition(0, 0, 0);
+    faction[row] = (unsigned char)Faction::NONE;
+    dirty[row] = 1;
+}
+
+void CombatantTable::writeBack() {
+    for (int row = 0; row < size(); row++) {
+        if (!dirty[row]) continue;
+
+        UnitComponent* unit = component[row];
+        unit->current_hp = current_hp[row];
+        unit->initiative = initiative[row];
+        unit->actions_remaining = actions_remaining[row];
+        unit->current_map = current_map[row];
+        unit->has_reaction = has_reaction[row];
+        dirty[row] = 0;
+    }
+}
+
+int CombatantTable::findRow(int node) const {
+    Unigine::HashMap<int, int>::ConstIterator it = row_by_node.find(node);
+    return it != row_by_node.end() ? it->data : -1;
+}
+
+void CombatantTable::resizeColumns(int rows) {
+    component.resize(rows);
+    node_id.resize(rows);
+    stat_block.resize(rows);
+    current_hp.resize(rows);
+    initiative.resize(rows);
+    actions_remaining.resize(rows);
+    current_map.resize(rows);
+    has_reaction.resize(rows);
+    position.resize(rows);
+    faction.resize(rows);
+    dirty.resize(rows);
+}
+
+void CombatantTable::copyRow(int from, int to) {
+    component[to] = component[from];
+    node_id[to] = node_id[from];
+    stat_block[to] = stat_block[from];
+    current_hp[to] = current_hp[from];
+    initiative[to] = initiative[from];
+    actions_remaining[to] = actions_remaining[from];
+    current_map[to] = current_map[from];
+    has_reaction[to] = has_reaction[from];
+    position[to] = position[from];
+    faction[to] = faction[from];
+    dirty[to] = dirty[from];
+}
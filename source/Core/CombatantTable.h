@@ -0,0 +1,73 @@
+// CombatantTable.h
+// Dense structure-of-arrays mirror of every UnitComponent's combat state
+// Rows are added in UnitComponent::init and removed in shutdown. Rules, AI capture and
+// pathing read these arrays instead of PROP_PARAM accessors and component lookups.
+// Stats are not copied per unit: each row holds a UnitDatabase stat block ID (flyweight).
+// Mutable combat state (HP, actions, reaction, initiative, position, faction) lives here
+// while the game runs; writeBack() copies changed rows to the properties at the engine
+// boundary (once per frame, before saves) so the Editor and world saves stay current.
+
+#pragma once
+
+#include "../Grid/GridCell.h"
+#include "../Data/UnitDatabase.h"
+#include <UnigineVector.h>
+#include <UnigineHashMap.h>
+
+class UnitComponent;
+
+enum class Faction : unsigned char {
+    NONE,       // Not in combat
+    PLAYER,
+    ENEMY
+};
+
+class CombatantTable {
+public:
+    // Process-wide table (components init before GameManager exists)
+    static CombatantTable* get();
+
+    // Row lifetime (UnitComponent::init / shutdown). Removal swaps the last row in.
+    int add(UnitComponent* unit);
+    void remove(int row);
+
+    // Re-read the row from the component's properties (after Editor or save-game writes)
+    void pull(int row);
+
+    // Fresh instance of the row's stat block: full HP, no initiative, out of combat
+    void resetState(int row);
+
+    // Shared stats of a row
+    const StatBlock& getStats(int row) const { return UnitDatabase::get()->getBlock(stat_block[row]); }
+
+    // Copy dirty rows' mutable state back to PROP_PARAMs
+    void writeBack();
+    void markDirty(int row) { dirty[row] = 1; }
+
+    int size() const { return component.size(); }
+    int findRow(int node) const;
+
+    // Columns (index = row)
+    Unigine::Vector<UnitComponent*> component;
+    Unigine::Vector<int> node_id;
+
+    Unigine::Vector<int> stat_block;            // UnitDatabase block ID
+
+    // Mutable combat state
+    Unigine::Vector<int> current_hp;
+    Unigine::Vector<int> initiative;
+    Unigine::Vector<int> actions_remaining;
+    Unigine::Vector<int> current_map;
+    Unigine::Vector<unsigned char> has_reaction;
+    Unigine::Vector<GridPosition> position;
+    Unigine::Vector<unsigned char> faction;     // Faction
+    Unigine::Vector<unsigned char> dirty;       // Needs writeBack
+
+private:
+    CombatantTable() {}
+
+    Unigine::HashMap<int, int> row_by_node;
+
+    void resizeColumns(int rows);
+    void copyRow(int from, int to);
+};
@@ -0,0 +1,68 @@
+// Dice.cpp
+#include "Dice.h"
+#include <cctype>
+
+namespace {
+    // Read an unsigned decimal number; returns false if no digits
+    bool readNumber(const char*& p, int& value) {
+        if (!isdigit((unsigned char)*p)) return false;
+        value = 0;
+        while (isdigit((unsigned char)*p)) {
+            value = value * 10 + (*p - '0');
+            p++;
+        }
+        return true;
+    }
+}
+
+bool DiceExpr::parse(const char* text, DiceExpr& out) {
+    if (!text) return false;
+
+    DiceExpr result;
+
+    const char* p = text;
+    while (*p == ' ') p++;
+
+    int first = 0;
+    bool has_first = readNumber(p, first);
+
+    if (*p == 'd' || *p == 'D') {
+        p++;
+        result.count = has_first ? first : 1;
+        if (!readNumber(p, result.sides) || result.sides <= 0) return false;
+
+        if (*p == '+' || *p == '-') {
+            bool negative = *p == '-';
+            p++;
+            if (!readNumber(p, result.bonus)) return false;
+            if (negative) result.bonus = -result.bonus;
+        }
+    } else {
+        // Flat damage
+        if (!has_first) return false;
+        result.bonus = first;
+    }
+
+    while (*p == ' ') p++;
+    if (*p != '\0') return false;
+
+    // Only write on success so callers keep their fallback on malformed input
+    out = result;
+    return true;
+}
+
+int DiceExpr::roll(CombatRandom& rng) const {
+    int total = bonus;
+    for (int i = 0; i < count; i++) {
+        total += rng.rollDie(sides);
+    }
+    return total > 0 ? total : 0;
+}
+
+int DiceExpr::rollCritical(CombatRandom& rng) const {
+    int total = bonus;
+    for (int i = 0; i < count * 2; i++) {
+        total += rng.rollDie(sides);
+    }
+    return total > 0 ? total : 0;
+}
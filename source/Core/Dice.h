@@ -0,0 +1,28 @@
+// Dice.h
+// Parsed dice expressions ("XdY+Z") rolled with CombatRandom
+
+#pragma once
+
+#include "CombatRandom.h"
+
+struct DiceExpr {
+    int count;      // Number of dice (X)
+    int sides;      // Die size (Y)
+    int bonus;      // Flat modifier (Z, may be negative)
+
+    DiceExpr() : count(0), sides(0), bonus(0) {}
+    DiceExpr(int _count, int _sides, int _bonus = 0) : count(_count), sides(_sides), bonus(_bonus) {}
+
+    // Parse "XdY", "XdY+Z", "XdY-Z", "dY" or a flat "Z". Returns false (out untouched) on malformed input.
+    static bool parse(const char* text, DiceExpr& out);
+
+    // Roll the expression (minimum 0)
+    int roll(CombatRandom& rng) const;
+
+    // Critical hit (GDD rule): double the dice, not the modifier. Minimum 0.
+    int rollCritical(CombatRandom& rng) const;
+
+    int getMin() const { return count + bonus; }
+    int getMax() const { return count * sides + bonus; }
+    float getAverage() const { return count * (sides + 1) * 0.5f + bonus; }
+};
@@ -0,0 +1,263 @@
+// JobSystem.cpp
+#include "JobSystem.h"
+#include <UnigineLog.h>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    // Which JobSystem worker the current thread is (if any)
+    thread_local const JobSystem* current_system = nullptr;
+    thread_local int current_worker = -1;
+}
+
+JobSystem::JobSystem(int num_workers)
+    : next_worker(0)
+    , queued(0)
+    , stopping(false)
+{
+    for (int i = 0; i < MAX_SYSTEMS; i++) {
+        task_count[i].store(0);
+        total_ns[i].store(0);
+        max_ns[i].store(0);
+    }
+    system_names.push_back("Other");
+
+    if (num_workers <= 0) {
+        int hardware = (int)std::thread::hardware_concurrency();
+        num_workers = hardware > 1 ? hardware - 1 : 1; // Leave the main thread its core
+    }
+
+    // Create every deque before any worker can try to steal from it
+    for (int i = 0; i < num_workers; i++) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    for (int i = 0; i < num_workers; i++) {
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+
+    Unigine::Log::message("JobSystem::JobSystem() - Started %d worker threads\n", num_workers);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i]->thread.join();
+    }
+    workers.clear();
+}
+
+int JobSystem::getSystemId(const char* name) {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    for (size_t i = 0; i < system_names.size(); i++) {
+        if (system_names[i] == name) return (int)i;
+    }
+    if ((int)system_names.size() >= MAX_SYSTEMS) return 0;
+
+    system_names.push_back(name);
+    return (int)system_names.size() - 1;
+}
+
+JobHandle JobSystem::submit(int system, std::function<void()> work) {
+    return submit(system, std::move(work), std::vector<JobHandle>());
+}
+
+JobHandle JobSystem::submit(int system, std::function<void()> work, const std::vector<JobHandle>& dependencies) {
+    JobHandle job = std::make_shared<JobTask>();
+    job->work = std::move(work);
+    job->system = system >= 0 && system < MAX_SYSTEMS ? system : 0;
+
+    // The extra count keeps the task from starting while dependencies are still being registered
+    job->unfinished.store((int)dependencies.size() + 1);
+    for (size_t i = 0; i < dependencies.size(); i++) {
+        const JobHandle& dependency = dependencies[i];
+        bool pending = false;
+        if (dependency) {
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            if (!dependency->done.load(std::memory_order_acquire)) {
+                dependency->dependents.push_back(job);
+                pending = true;
+            }
+        }
+        if (!pending) job->unfinished.fetch_sub(1);
+    }
+
+    if (job->unfinished.fetch_sub(1) == 1) schedule(job);
+    return job;
+}
+
+void JobSystem::wait(const JobHandle& job) {
+    const int self = getCurrentWorker();
+    while (!isDone(job)) {
+        if (!runOne(self)) std::this_thread::yield();
+    }
+}
+
+void JobSystem::parallelFor(int system, int begin, int end, int grain, const std::function<void(int, int)>& body) {
+    const int count = end - begin;
+    if (count <= 0) return;
+
+    // Automatic grain: about four chunks per thread (workers + caller)
+    if (grain <= 0) {
+        const int threads = getWorkerCount() + 1;
+        grain = count / (threads * 4);
+        if (grain < 1) grain = 1;
+    }
+
+    // Small ranges are not worth a task
+    if (count <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<int> remaining((count + grain - 1) / grain);
+    for (int start = begin; start < end; start += grain) {
+        const int stop = start + grain < end ? start + grain : end;
+        submit(system, [&body, &remaining, start, stop]() {
+            body(start, stop);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    // Help until every chunk is done (the chunks reference this stack frame)
+    const int self = getCurrentWorker();
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) std::this_thread::yield();
+    }
+}
+
+void JobSystem::getTimings(std::vector<JobTiming>& out) const {
+    std::lock_guard<std::mutex> lock(names_mutex);
+    out.clear();
+    for (size_t i = 0; i < system_names.size(); i++) {
+        JobTiming timing;
+        timing.system = system_names[i];
+        timing.tasks = (int)task_count[i].load(std::memory_order_relaxed);
+        timing.total_ms = total_ns[i].load(std::memory_order_relaxed) / 1000000.0;
+        timing.max_ms = max_ns[i].load(std::memory_order_relaxed) / 1000000.0;
+        out.push_back(timing);
+    }
+}
+
+void JobSystem::resetTimings() {
+    for (int i = 0; i < MAX_SYSTEMS; i++) {
+        task_count[i].store(0, std::memory_order_relaxed);
+        total_ns[i].store(0, std::memory_order_relaxed);
+        max_ns[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void JobSystem::schedule(const JobHandle& job) {
+    // Workers keep their own follow-up work local; other threads spread tasks round-robin
+    int target = getCurrentWorker();
+    if (target < 0) target = (int)(next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size());
+
+    {
+        std::lock_guard<std::mutex> lock(workers[target]->mutex);
+        workers[target]->tasks.push_back(job);
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Lock so a worker cannot miss the wake-up between its check and its wait
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_one();
+}
+
+bool JobSystem::runOne(int self) {
+    JobHandle job = self >= 0 ? pop(self) : JobHandle();
+    if (!job) job = steal(self);
+    if (!job) return false;
+
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    execute(job);
+    return true;
+}
+
+JobHandle JobSystem::pop(int self) {
+    Worker& worker = *workers[self];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return JobHandle();
+
+    // Newest first: its data is most likely still in cache
+    JobHandle job = worker.tasks.back();
+    worker.tasks.pop_back();
+    return job;
+}
+
+JobHandle JobSystem::steal(int self) {
+    const int count = (int)workers.size();
+    const int first = self >= 0 ? self + 1 : 0;
+    for (int i = 0; i < count; i++) {
+        const int victim = (first + i) % count;
+        if (victim == self) continue;
+
+        Worker& worker = *workers[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) continue;
+
+        // Oldest first: usually the largest remaining piece of work
+        JobHandle job = worker.tasks.front();
+        worker.tasks.pop_front();
+        return job;
+    }
+    return JobHandle();
+}
+
+void JobSystem::execute(const JobHandle& job) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (job->work) job->work();
+    const long long elapsed = (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    const int system = job->system;
+    task_count[system].fetch_add(1, std::memory_order_relaxed);
+    total_ns[system].fetch_add(elapsed, std::memory_order_relaxed);
+    long long previous = max_ns[system].load(std::memory_order_relaxed);
+    while (elapsed > previous && !max_ns[system].compare_exchange_weak(previous, elapsed, std::memory_order_relaxed)) {
+    }
+
+    finish(job);
+}
+
+void JobSystem::finish(const JobHandle& job) {
+    // Release captured state right away (the handle may outlive the task)
+    job->work = nullptr;
+
+    std::vector<JobHandle> ready;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->done.store(true, std::memory_order_release);
+        ready.swap(job->dependents);
+    }
+
+    for (size_t i = 0; i < ready.size(); i++) {
+        if (ready[i]->unfinished.fetch_sub(1) == 1) schedule(ready[i]);
+    }
+}
+
+void JobSystem::workerLoop(int index) {
+    current_system = this;
+    current_worker = index;
+
+    for (;;) {
+        if (runOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+int JobSystem::getCurrentWorker() const {
+    return current_system == this ? current_worker : -1;
+}
+
+bool JobSystem::isWorkerThread() {
+    return current_system != nullptr;
+}
@@ -0,0 +1,104 @@
+// JobSystem.h
+// Work-stealing task scheduler shared by every game system (owned by GameManager)
+// Each worker owns a deque: it pushes and pops its own tasks at the back, idle workers steal
+// from the front of others. Tasks may depend on other tasks and run once all of them finish.
+// Tasks must work on plain data (snapshots, GridView arrays) - never on Unigine nodes.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct JobTask {
+    std::function<void()> work;
+    int system;                         // Timing bucket (JobSystem::getSystemId)
+    std::atomic<int> unfinished;        // Dependencies left (+1 while being submitted)
+    std::atomic<bool> done;
+    std::mutex mutex;                   // Guards dependents and the done transition
+    std::vector<std::shared_ptr<JobTask>> dependents;
+
+    JobTask() : system(0), unfinished(0), done(false) {}
+};
+
+typedef std::shared_ptr<JobTask> JobHandle;
+
+// Accumulated task time of one system since the last resetTimings()
+struct JobTiming {
+    std::string system;
+    int tasks;
+    double total_ms;
+    double max_ms;
+};
+
+class JobSystem {
+public:
+    static const int MAX_SYSTEMS = 32;
+
+    explicit JobSystem(int num_workers = 0);  // 0 = hardware threads - 1 (at least 1)
+    ~JobSystem();                             // Runs queued tasks to completion, then joins
+
+    // Timing bucket for a system name (registered on first use, "Other" when full)
+    int getSystemId(const char* name);
+
+    // Queue a task; with dependencies it starts only after all of them are done
+    JobHandle submit(int system, std::function<void()> work);
+    JobHandle submit(int system, std::function<void()> work, const std::vector<JobHandle>& dependencies);
+
+    // Block until the task is done. The calling thread runs queued tasks meanwhile.
+    void wait(const JobHandle& job);
+    static bool isDone(const JobHandle& job) { return !job || job->done.load(std::memory_order_acquire); }
+
+    // Run body(range_begin, range_end) over [begin, end) split into chunks of 'grain'
+    // (0 = automatic) on all workers and the caller. Returns when every chunk is done.
+    void parallelFor(int system, int begin, int end, int grain, const std::function<void(int, int)>& body);
+
+    int getWorkerCount() const { return (int)workers.size(); }
+
+    // True on a worker thread of any JobSystem (the main thread helping in wait() is not one)
+    static bool isWorkerThread();
+
+    // Per-system task timings
+    void getTimings(std::vector<JobTiming>& out) const;
+    void resetTimings();
+
+private:
+    struct Worker {
+        std::deque<JobHandle> tasks;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned int> next_worker;      // Round-robin target for external submissions
+    std::atomic<int> queued;                    // Tasks sitting in deques
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    // Timings (written by workers, lock-free)
+    mutable std::mutex names_mutex;
+    std::vector<std::string> system_names;
+    std::atomic<long long> task_count[MAX_SYSTEMS];
+    std::atomic<long long> total_ns[MAX_SYSTEMS];
+    std::atomic<long long> max_ns[MAX_SYSTEMS];
+
+    void schedule(const JobHandle& job);
+    bool runOne(int self);          // self = worker index, -1 for other threads
+    JobHandle pop(int self);
+    JobHandle steal(int self);
+    void execute(const JobHandle& job);
+    void finish(const JobHandle& job);
+    void workerLoop(int index);
+    int getCurrentWorker() const;
+
+    // Prevent copying
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+};
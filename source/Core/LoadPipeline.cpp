@@ -0,0 +1,108 @@
+// LoadPipeline.cpp
+#include "LoadPipeline.h"
+#include <UnigineLog.h>
+
+LoadPipeline::LoadPipeline()
+    : current(0)
+    , frames(0)
+    , created(Clock::now())
+    , completed(created)
+{
+}
+
+void LoadPipeline::addStage(const char* name, float weight, const StepFunction& step) {
+    Stage stage;
+    stage.name = name;
+    stage.weight = weight > 0.0f ? weight : 0.0f;
+    stage.step = step;
+    stage.progress = 0.0f;
+    stage.busy_ms = 0.0;
+    stage.frames = 0;
+    stage.begun = false;
+    stages.push_back(stage);
+}
+
+bool LoadPipeline::update(double budget_ms) {
+    if (isComplete()) return true;
+    frames++;
+
+    const Clock::time_point frame_start = Clock::now();
+    int counted_stage = -1;
+
+    while (!isComplete()) {
+        Stage& stage = stages[current];
+        if (!stage.begun) {
+            stage.begun = true;
+            stage.started = Clock::now();
+        }
+        if (counted_stage != current) {
+            stage.frames++;
+            counted_stage = current;
+        }
+
+        const Clock::time_point step_start = Clock::now();
+        const LoadStep result = stage.step(stage.progress);
+        const Clock::time_point step_end = Clock::now();
+        stage.busy_ms += toMs(step_end - step_start);
+
+        if (result == LoadStep::DONE) {
+            stage.progress = 1.0f;
+            stage.finished = step_end;
+            Unigine::Log::message("LoadPipeline::update() - '%s' done (%.2f ms busy, %.2f ms elapsed, %d frames)\n",
+                stage.name.c_str(), stage.busy_ms, toMs(stage.finished - stage.started), stage.frames);
+            current++;
+            if (isComplete()) completed = step_end;
+        } else if (result == LoadStep::WAIT) {
+            break;
+        }
+
+        if (toMs(Clock::now() - frame_start) >= budget_ms) break;
+    }
+
+    return isComplete();
+}
+
+float LoadPipeline::getProgress() const {
+    float total = 0.0f;
+    float done = 0.0f;
+    for (size_t i = 0; i < stages.size(); i++) {
+        total += stages[i].weight;
+        done += stages[i].weight * stages[i].progress;
+    }
+    return total > 0.0f ? done / total : (isComplete() ? 1.0f : 0.0f);
+}
+
+const char* LoadPipeline::getCurrentStage() const {
+    return isComplete() ? "" : stages[current].name.c_str();
+}
+
+double LoadPipeline::getElapsedMs() const {
+    return toMs((isComplete() ? completed : Clock::now()) - created);
+}
+
+void LoadPipeline::getTimings(std::vector<LoadStageTiming>& out) const {
+    out.clear();
+    for (size_t i = 0; i < stages.size(); i++) {
+        const Stage& stage = stages[i];
+        LoadStageTiming timing;
+        timing.name = stage.name;
+        timing.busy_ms = stage.busy_ms;
+        timing.elapsed_ms = (int)i < current ? toMs(stage.finished - stage.started) : 0.0;
+        timing.frames = stage.frames;
+        out.push_back(timing);
+    }
+}
+
+void LoadPipeline::logTimings() const {
+    Unigine::Log::message("LoadPipeline: %s after %.2f ms over %d frames\n",
+        isComplete() ? "interactive" : "loading", getElapsedMs(), frames);
+    for (size_t i = 0; i < stages.size(); i++) {
+        const Stage& stage = stages[i];
+        Unigine::Log::message("  %-12s %8.2f ms busy  %8.2f ms elapsed  %4d frames\n", stage.name.c_str(),
+            stage.busy_ms, (int)i < current ? toMs(stage.finished - stage.started) : 0.0, stage.frames);
+    }
+}
+
+double LoadPipeline::toMs(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
@@ -0,0 +1,73 @@
+// LoadPipeline.h
+// Time-sliced world setup: named stages run a little per frame within a time budget,
+// so loading never blocks a frame for long. Stages may hand heavy non-engine work to
+// the JobSystem and wait for it without stalling the main thread.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+enum class LoadStep {
+    CONTINUE,   // More work left: call again (this frame if there is budget left)
+    WAIT,       // Waiting on a background job: try again next frame
+    DONE        // Stage finished
+};
+
+struct LoadStageTiming {
+    std::string name;
+    double busy_ms;         // Main-thread time spent in the stage's steps
+    double elapsed_ms;      // Wall time from the stage's first step to its completion
+    int frames;             // Frames the stage was active in
+};
+
+class LoadPipeline {
+public:
+    // step(progress): do one small piece of work, report the stage's progress in [0, 1]
+    typedef std::function<LoadStep(float& progress)> StepFunction;
+
+    LoadPipeline();
+
+    // Stages run in the order added; weight is the stage's share of getProgress()
+    void addStage(const char* name, float weight, const StepFunction& step);
+
+    // Run steps until budget_ms of main-thread time is used or a stage waits.
+    // Returns true once every stage is done.
+    bool update(double budget_ms);
+
+    bool isComplete() const { return current >= (int)stages.size(); }
+    float getProgress() const;                  // Weighted, 0..1
+    const char* getCurrentStage() const;        // "" when complete
+
+    // Since construction; after completion, the time it took to become interactive
+    double getElapsedMs() const;
+    int getFrames() const { return frames; }
+
+    void getTimings(std::vector<LoadStageTiming>& out) const;
+    void logTimings() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Stage {
+        std::string name;
+        float weight;
+        StepFunction step;
+        float progress;
+        double busy_ms;
+        Clock::time_point started;
+        Clock::time_point finished;
+        int frames;
+        bool begun;
+    };
+
+    std::vector<Stage> stages;
+    int current;
+    int frames;
+    Clock::time_point created;
+    Clock::time_point completed;
+
+    static double toMs(Clock::duration duration);
+};
@@ -0,0 +1,627 @@
+// Lockstep.cpp
+#include "Lockstep.h"
+#include <UnigineLog.h>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+using namespace Unigine;
+
+namespace {
+    const unsigned char PROTOCOL_VERSION = 2;     // 2: server-side command checks, REJECTED
+    const int MAX_PAYLOAD = 254;                // Frame length is one byte (type + payload)
+    const int WRITE_TIMEOUT_USEC = 100000;
+    const char* LOOPBACK_HOST = "127.0.0.1";
+    const double SELF_TEST_TIMEOUT_MS = 10000.0;
+    const double SELF_TEST_GRACE_MS = 500.0;    // After a client fails, time for the server's verdict
+
+    // Command header: low bits = CommandType, high bits = fields that differ from the previous command
+    const unsigned char TYPE_MASK = 0x07;
+    const unsigned char FIELD_ACTOR = 0x08;
+    const unsigned char FIELD_TARGET = 0x10;
+    const unsigned char FIELD_DESTINATION = 0x20;
+    const unsigned char FIELD_COST = 0x40;
+
+    void writeVarint(Vector<unsigned char>& out, unsigned long long value) {
+        while (value >= 0x80) {
+            out.append((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        out.append((unsigned char)value);
+    }
+
+    bool readVarint(const unsigned char* data, int size, int& offset, unsigned long long& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && offset < size; shift += 7) {
+            const unsigned char byte = data[offset++];
+            value |= (unsigned long long)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // Signed deltas as small unsigned values (-1 -> 1, 1 -> 2, ...)
+    void writeDelta(Vector<unsigned char>& out, int value, int previous) {
+        const int delta = (int)((unsigned int)value - (unsigned int)previous);
+        writeVarint(out, ((unsigned int)delta << 1) ^ (unsigned int)(delta >> 31));
+    }
+
+    bool readDelta(const unsigned char* data, int size, int& offset, int previous, int& value) {
+        unsigned long long coded = 0;
+        if (!readVarint(data, size, offset, coded) || coded > 0xFFFFFFFFULL) return false;
+        const unsigned int zigzag = (unsigned int)coded;
+        const int delta = (int)(zigzag >> 1) ^ -(int)(zigzag & 1);
+        value = (int)((unsigned int)previous + (unsigned int)delta);
+        return true;
+    }
+
+    unsigned int foldHash(unsigned long long hash) {
+        return (unsigned int)(hash ^ (hash >> 32));
+    }
+
+    int getCellDistance(GridPosition a, GridPosition b) {
+        const int dx = a.x > b.x ? a.x - b.x : b.x - a.x;
+        const int dy = a.y > b.y ? a.y - b.y : b.y - a.y;
+        return dx > dy ? dx : dy;
+    }
+
+    bool isCombatOver(const CombatSimulation& simulation) {
+        bool players = false;
+        bool enemies = false;
+        const Vector<CombatantSnapshot>& units = simulation.getUnits();
+        for (int i = 0; i < units.size(); i++) {
+            if (!units[i].isAlive()) continue;
+            if (units[i].is_player_unit) players = true;
+            else enemies = true;
+        }
+        return !players || !enemies;
+    }
+
+    // Scripted client: Strike an adjacent foe, else step one square toward the nearest, else end
+    CombatCommand chooseCommand(const CombatSimulation& simulation) {
+        const Vector<CombatantSnapshot>& units = simulation.getUnits();
+        const CombatantSnapshot& self = units[simulation.getActor()];
+        if (!self.isAlive() || simulation.getActionsRemaining() <= 0) return CombatCommand::endTurn(self.node_id);
+
+        int target = -1;
+        int best = INT_MAX;
+        for (int i = 0; i < units.size(); i++) {
+            if (!units[i].isAlive() || units[i].is_player_unit == self.is_player_unit) continue;
+            const int distance = getCellDistance(self.position, units[i].position);
+            if (distance < best) {
+                best = distance;
+                target = i;
+            }
+        }
+        if (target < 0) return CombatCommand::endTurn(self.node_id);
+        if (best <= 1) return CombatCommand::strike(self.node_id, units[target].node_id);
+
+        const CombatSnapshot& map = simulation.getEncounter();
+        GridPosition step;
+        int step_distance = best;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                const GridPosition pos(self.position.x + dx, self.position.y + dy);
+                if ((dx == 0 && dy == 0) || pos.x < 0 || pos.y < 0 || pos.x >= map.width || pos.y >= map.height) continue;
+
+                const int index = map.getIndex(pos);
+                if (map.blocked[index] || simulation.getOccupant(pos) != -1) continue;
+
+                const int distance = getCellDistance(pos, units[target].position);
+                if (distance >= step_distance) continue;
+
+                // Climbing is not a Stride: the server would reject the step
+                const GridPosition candidate(pos.x, pos.y, map.elevation[index]);
+                const char* error = "";
+                if (!simulation.validate(CombatCommand::stride(self.node_id, candidate, 1), error)) continue;
+
+                step_distance = distance;
+                step = candidate;
+            }
+        }
+        if (step_distance < best) return CombatCommand::stride(self.node_id, step, 1);
+        return CombatCommand::endTurn(self.node_id);
+    }
+}
+
+void LockstepCommandCodec::encode(const CombatCommand& command, Vector<unsigned char>& out) {
+    unsigned char header = (unsigned char)command.type & TYPE_MASK;
+    if (command.actor_node_id != previous.actor_node_id) header |= FIELD_ACTOR;
+    if (command.target_node_id != previous.target_node_id) header |= FIELD_TARGET;
+    if (command.destination != previous.destination) header |= FIELD_DESTINATION;
+    if (command.action_cost != previous.action_cost) header |= FIELD_COST;
+
+    out.append(header);
+    if (header & FIELD_ACTOR) writeDelta(out, command.actor_node_id, previous.actor_node_id);
+    if (header & FIELD_TARGET) writeDelta(out, command.target_node_id, command.actor_node_id);
+    if (header & FIELD_DESTINATION) {
+        writeDelta(out, command.destination.x, previous.destination.x);
+        writeDelta(out, command.destination.y, previous.destination.y);
+        writeDelta(out, command.destination.z, previous.destination.z);
+    }
+    if (header & FIELD_COST) writeDelta(out, command.action_cost, previous.action_cost);
+
+    previous = command;
+}
+
+bool LockstepCommandCodec::decode(const unsigned char* data, int size, CombatCommand& out) {
+    if (size < 1 || (data[0] & TYPE_MASK) > (unsigned char)CommandType::REDO) return false;
+
+    const unsigned char header = data[0];
+    CombatCommand command = previous;
+    command.type = (CommandType)(header & TYPE_MASK);
+
+    int offset = 1;
+    bool valid = true;
+    if (header & FIELD_ACTOR) valid &= readDelta(data, size, offset, previous.actor_node_id, command.actor_node_id);
+    if (header & FIELD_TARGET) valid &= readDelta(data, size, offset, command.actor_node_id, command.target_node_id);
+    if (header & FIELD_DESTINATION) {
+        valid &= readDelta(data, size, offset, previous.destination.x, command.destination.x);
+        valid &= readDelta(data, size, offset, previous.destination.y, command.destination.y);
+        valid &= readDelta(data, size, offset, previous.destination.z, command.destination.z);
+    }
+    if (header & FIELD_COST) valid &= readDelta(data, size, offset, previous.action_cost, command.action_cost);
+    if (!valid || offset != size) return false;
+
+    previous = command;
+    out = command;
+    return true;
+}
+
+void LockstepConnection::attach(const SocketPtr& connected_socket) {
+    socket = connected_socket;
+    socket->nonblock();
+    socket->nodelay();
+    inbox.clear();
+    closed = false;
+}
+
+bool LockstepConnection::send(LockstepMessage type, const Vector<unsigned char>& payload) {
+    if (!isOpen() || payload.size() > MAX_PAYLOAD) return false;
+
+    frame.clear();
+    frame.append((unsigned char)(payload.size() + 1));
+    frame.append((unsigned char)type);
+    frame.append(payload);
+
+    int written = 0;
+    while (written < frame.size()) {
+        if (!socket->isReadyToWrite(WRITE_TIMEOUT_USEC)) {
+            closed = true;
+            return false;
+        }
+        const size_t count = socket->write(frame.get() + written, frame.size() - written);
+        if (count == 0) {
+            closed = true;
+            return false;
+        }
+        written += (int)count;
+    }
+    bytes_sent += written;
+    return true;
+}
+
+bool LockstepConnection::receive(LockstepMessage& out_type, Vector<unsigned char>& out_payload) {
+    if (!socket) return false;
+
+    unsigned char buffer[512];
+    while (!closed && socket->isReadyToRead()) {
+        const size_t count = socket->read(buffer, sizeof(buffer));
+        if (count == 0) {
+            closed = true;      // Readable with no data: the peer hung up
+            break;
+        }
+        const int offset = inbox.size();
+        inbox.resize(offset + (int)count);
+        memcpy(inbox.get() + offset, buffer, count);
+        bytes_received += (int)count;
+    }
+
+    if (inbox.size() < 2 || inbox.size() < 1 + inbox[0]) return false;
+    const int length = inbox[0];
+    if (length == 0) {
+        closed = true;
+        return false;
+    }
+
+    out_type = (LockstepMessage)inbox[1];
+    out_payload.resize(length - 1);
+    if (length > 1) memcpy(out_payload.get(), inbox.get() + 2, length - 1);
+
+    const int remaining = inbox.size() - (1 + length);
+    if (remaining > 0) memmove(inbox.get(), inbox.get() + 1 + length, remaining);
+    inbox.resize(remaining);
+    return true;
+}
+
+LockstepServer::LockstepServer(const CombatSnapshot& encounter_state, int num_clients,
+                               unsigned long long encounter_seed, int interval)
+    : encounter(encounter_state)
+    , simulation(nullptr)
+    , max_clients(num_clients)
+    , seed(encounter_seed)
+    , hash_interval(interval > 0 ? interval : 1)
+    , desync_turn(0)
+    , commands_relayed(0)
+    , commands_rejected(0)
+    , hashes_compared(0)
+{
+}
+
+LockstepServer::~LockstepServer() {
+    for (int i = 0; i < peers.size(); i++) {
+        delete peers[i];
+    }
+    delete simulation;
+    if (listener) listener->close();
+}
+
+bool LockstepServer::listen(const char* host, int port) {
+    listener = Socket::create(Socket::SOCKET_TYPE_STREAM);
+    if (!listener->open(host, port) || !listener->bind() || !listener->listen(max_clients)) {
+        Log::error("LockstepServer::listen() - Cannot listen on %s:%d\n", host, port);
+        listener.clear();
+        return false;
+    }
+    listener->nonblock();
+    return true;
+}
+
+void LockstepServer::update() {
+    if (!listener) return;
+    accept();
+
+    LockstepMessage type;
+    Vector<unsigned char> data;
+    for (int i = 0; i < peers.size(); i++) {
+        while (peers[i]->connection.receive(type, data)) {
+            handle(peers[i], type, data);
+        }
+    }
+}
+
+void LockstepServer::accept() {
+    while (peers.size() < max_clients && listener->isReadyToRead()) {
+        SocketPtr socket = Socket::create(Socket::SOCKET_TYPE_STREAM);
+        if (!listener->accept(socket)) break;
+
+        Peer* peer = new Peer();
+        peer->connection.attach(socket);
+        peer->slot = peers.size();
+        peer->last_hash_turn = -1;      // -1 = no HELLO yet
+        peers.append(peer);
+    }
+}
+
+void LockstepServer::handle(Peer* peer, LockstepMessage type, const Vector<unsigned char>& data) {
+    switch (type) {
+    case LockstepMessage::HELLO: {
+        // The match starts once: a late or repeated HELLO must not start (and leak) another
+        if (simulation) {
+            Log::warning("LockstepServer::update() - HELLO after the start, ignored\n");
+            return;
+        }
+        if (data.size() != 1 || data[0] != PROTOCOL_VERSION) {
+            Log::warning("LockstepServer::update() - Client speaks another protocol version, ignored\n");
+            return;
+        }
+        peer->last_hash_turn = 0;
+
+        // Everyone starts together, so no client can miss a relayed command
+        if (peers.size() < max_clients) return;
+        for (int i = 0; i < peers.size(); i++) {
+            if (peers[i]->last_hash_turn < 0) return;
+        }
+        simulation = new CombatSimulation(seed, encounter);
+        simulation->startCombat();
+        for (int i = 0; i < peers.size(); i++) {
+            payload.clear();
+            payload.append((unsigned char)i);
+            writeVarint(payload, seed);
+            writeVarint(payload, (unsigned long long)hash_interval);
+            peers[i]->connection.send(LockstepMessage::WELCOME, payload);
+        }
+        return;
+    }
+    case LockstepMessage::COMMAND: {
+        CombatCommand command;
+        if (!peer->from_client.decode(data.get(), data.size(), command)) {
+            Log::warning("LockstepServer::update() - Malformed command, dropped\n");
+            return;
+        }
+
+        // Checked and applied here first: every relayed command executes on every honest peer
+        const char* error = "";
+        if (!accepts(peer, command, error) || !simulation->execute(command, error)) {
+            Log::warning("LockstepServer::update() - Slot %d command rejected: %s\n", peer->slot, error);
+            payload.clear();
+            peer->connection.send(LockstepMessage::REJECTED, payload);
+            commands_rejected++;
+            return;
+        }
+        for (int i = 0; i < peers.size(); i++) {
+            payload.clear();
+            peers[i]->to_client.encode(command, payload);
+            peers[i]->connection.send(LockstepMessage::COMMAND, payload);
+        }
+        commands_relayed++;
+        return;
+    }
+    case LockstepMessage::HASH: {
+        int offset = 0;
+        unsigned long long delta = 0;
+        if (!readVarint(data.get(), data.size(), offset, delta) || offset + 4 != data.size()) {
+            Log::warning("LockstepServer::update() - Malformed hash report, dropped\n");
+            return;
+        }
+        const unsigned char* bytes = data.get() + offset;
+        const unsigned int hash = (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) |
+            ((unsigned int)bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+        peer->last_hash_turn += (int)delta;
+        compareHash(peer->last_hash_turn, hash);
+        return;
+    }
+    default:
+        Log::warning("LockstepServer::update() - Unexpected message %d, ignored\n", (int)type);
+        return;
+    }
+}
+
+bool LockstepServer::accepts(const Peer* peer, const CombatCommand& command, const char*& error) const {
+    if (!simulation) {
+        error = "game not started";
+        return false;
+    }
+    const int actor = simulation->getActor();
+    if (actor < 0 || simulation->getUnits()[actor].node_id != command.actor_node_id) {
+        error = "not that unit's turn";
+        return false;
+    }
+    if (simulation->getUnits()[actor].is_player_unit != (peer->slot == 0)) {
+        error = "unit belongs to the other slot";
+        return false;
+    }
+    return true;
+}
+
+void LockstepServer::compareHash(int turn, unsigned int hash) {
+    for (int i = 0; i < pending.size(); i++) {
+        TurnHash& entry = pending[i];
+        if (entry.turn != turn) continue;
+
+        if (entry.hash != hash && desync_turn == 0) {
+            desync_turn = turn;
+            Log::warning("LockstepServer::update() - Desync at turn %d (%08x vs %08x)\n", turn, entry.hash, hash);
+            payload.clear();
+            writeVarint(payload, (unsigned long long)turn);
+            for (int p = 0; p < peers.size(); p++) {
+                peers[p]->connection.send(LockstepMessage::DESYNC, payload);
+            }
+        }
+        if (++entry.reports == max_clients) {
+            hashes_compared++;
+            pending.removeFast(i);
+        }
+        return;
+    }
+
+    TurnHash entry;
+    entry.turn = turn;
+    entry.hash = hash;
+    entry.reports = 1;
+    pending.append(entry);
+}
+
+LockstepClient::LockstepClient(const CombatSnapshot& encounter_state)
+    : encounter(encounter_state)
+    , simulation(nullptr)
+    , slot(-1)
+    , hash_interval(1)
+    , last_hash_turn(0)
+    , desync_turn(0)
+    , waiting(false)
+    , error("")
+{
+}
+
+LockstepClient::~LockstepClient() {
+    delete simulation;
+}
+
+bool LockstepClient::connect(const char* host, int port) {
+    SocketPtr socket = Socket::create(Socket::SOCKET_TYPE_STREAM);
+    if (!socket->open(host, port) || !socket->connect()) {
+        Log::error("LockstepClient::connect() - Cannot connect to %s:%d\n", host, port);
+        error = "cannot connect";
+        return false;
+    }
+    connection.attach(socket);
+
+    payload.clear();
+    payload.append(PROTOCOL_VERSION);
+    return connection.send(LockstepMessage::HELLO, payload);
+}
+
+bool LockstepClient::update() {
+    LockstepMessage type;
+    Vector<unsigned char> data;
+    while (connection.receive(type, data)) {
+        if (!handle(type, data)) break;
+    }
+    if (!connection.isOpen() && error[0] == '\0') error = "connection closed";
+    return error[0] == '\0';
+}
+
+bool LockstepClient::handle(LockstepMessage type, const Vector<unsigned char>& data) {
+    switch (type) {
+    case LockstepMessage::WELCOME: {
+        int offset = 1;
+        unsigned long long seed = 0;
+        unsigned long long interval = 0;
+        if (simulation || data.size() < 1 || !readVarint(data.get(), data.size(), offset, seed) ||
+            !readVarint(data.get(), data.size(), offset, interval) || interval == 0) {
+            error = "malformed welcome";
+            return false;
+        }
+        slot = data[0];
+        hash_interval = (int)interval;
+        simulation = new CombatSimulation(seed, encounter);
+        simulation->startCombat();
+        reportHash();
+        return true;
+    }
+    case LockstepMessage::COMMAND: {
+        // After a failure this peer has stopped simulating but still hears the server's verdict
+        if (error[0] != '\0') return true;
+
+        CombatCommand command;
+        if (!simulation || !from_server.decode(data.get(), data.size(), command)) {
+            error = "malformed command";
+            return false;
+        }
+        const int actor = simulation->findUnit(command.actor_node_id);
+        if (actor >= 0 && controls(simulation->getUnits()[actor])) waiting = false;
+
+        const int turns_before = simulation->getTurnsStarted();
+        if (!simulation->execute(command, error)) {
+            Log::warning("LockstepClient::update() - Slot %d cannot execute a relayed command: %s\n", slot, error);
+            return false;
+        }
+        if (simulation->getTurnsStarted() != turns_before) reportHash();
+        return true;
+    }
+    case LockstepMessage::REJECTED:
+        // The server's state disagrees with ours (or we broke the rules): stop proposing
+        waiting = false;
+        error = "command rejected by the server";
+        Log::warning("LockstepClient::update() - Slot %d: command rejected by the server\n", slot);
+        return false;
+
+    case LockstepMessage::DESYNC: {
+        int offset = 0;
+        unsigned long long turn = 0;
+        if (!readVarint(data.get(), data.size(), offset, turn)) return true;
+        desync_turn = (int)turn;
+        Log::warning("LockstepClient::update() - Slot %d: server reports a desync at turn %d\n", slot, desync_turn);
+        return true;
+    }
+    default:
+        return true;
+    }
+}
+
+void LockstepClient::submit(const CombatCommand& command) {
+    if (!simulation || waiting || error[0] != '\0') return;
+
+    payload.clear();
+    to_server.encode(command, payload);
+    waiting = connection.send(LockstepMessage::COMMAND, payload);
+}
+
+void LockstepClient::reportHash() {
+    const int turn = simulation->getTurnsStarted();
+    if ((turn - 1) % hash_interval != 0) return;
+
+    const unsigned int hash = foldHash(simulation->getTurnHash());
+    payload.clear();
+    writeVarint(payload, (unsigned long long)(turn - last_hash_turn));
+    payload.append((unsigned char)(hash & 0xff));
+    payload.append((unsigned char)((hash >> 8) & 0xff));
+    payload.append((unsigned char)((hash >> 16) & 0xff));
+    payload.append((unsigned char)(hash >> 24));
+    last_hash_turn = turn;
+    connection.send(LockstepMessage::HASH, payload);
+}
+
+bool LockstepSelfTest::run(const CombatSnapshot& encounter, unsigned long long seed, int max_turns, int hash_interval,
+                           bool inject_desync, int port, LockstepTestReport& out_report)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    auto elapsed = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+    out_report = LockstepTestReport();
+
+    LockstepServer server(encounter, 2, seed, hash_interval);
+    if (!server.listen(LOOPBACK_HOST, port)) {
+        out_report.error = "cannot listen on loopback";
+        return false;
+    }
+
+    CombatSnapshot diverged = encounter;
+    if (inject_desync && diverged.combatants.size() > 0) {
+        CombatantSnapshot& unit = diverged.combatants[0];
+        unit.current_hp += unit.current_hp > 1 ? -1 : 1;
+    }
+    LockstepClient first(encounter);
+    LockstepClient second(diverged);
+    LockstepClient* clients[2] = { &first, &second };
+
+    // Connect, then let the server accept before the second client queues up
+    for (int i = 0; i < 2; i++) {
+        if (!clients[i]->connect(LOOPBACK_HOST, port)) {
+            out_report.error = "cannot connect over loopback";
+            return false;
+        }
+        server.update();
+    }
+
+    double failed_at = -1.0;
+    for (;;) {
+        server.update();
+
+        bool finished = true;
+        for (int i = 0; i < 2; i++) {
+            LockstepClient* client = clients[i];
+            if (!client->update()) {
+                if (failed_at < 0.0) {
+                    failed_at = elapsed();
+                    out_report.error = client->getError();
+                }
+                continue;
+            }
+            if (!client->isStarted()) {
+                finished = false;
+                continue;
+            }
+
+            const CombatSimulation* simulation = client->getSimulation();
+            if (simulation->getTurnsStarted() > max_turns || isCombatOver(*simulation)) continue;
+            finished = false;
+
+            const int actor = simulation->getActor();
+            if (!client->isWaiting() && actor >= 0 && client->controls(simulation->getUnits()[actor])) {
+                client->submit(chooseCommand(*simulation));
+            }
+        }
+
+        if (server.getDesyncTurn() > 0 && first.getDesyncTurn() > 0 && second.getDesyncTurn() > 0) break;
+        if (failed_at < 0.0 && finished && !server.hasPendingHashes()) break;
+        if (failed_at >= 0.0 && elapsed() - failed_at > SELF_TEST_GRACE_MS) break;
+        if (elapsed() > SELF_TEST_TIMEOUT_MS) {
+            if (failed_at < 0.0) out_report.error = "timed out";
+            failed_at = elapsed();
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    out_report.commands = server.getCommandsRelayed();
+    out_report.hashes = server.getHashesCompared();
+    out_report.desync_turn = server.getDesyncTurn();
+    out_report.turns = INT_MAX;
+    for (int i = 0; i < 2; i++) {
+        const CombatSimulation* simulation = clients[i]->getSimulation();
+        const int turns = simulation ? simulation->getTurnsStarted() : 0;
+        if (turns < out_report.turns) out_report.turns = turns;
+        if (simulation) out_report.final_hash[i] = simulation->getTurnHash();
+        out_report.bytes_up += clients[i]->getConnection().getBytesSent();
+        out_report.bytes_down += clients[i]->getConnection().getBytesReceived();
+    }
+
+    out_report.completed = failed_at < 0.0 && out_report.desync_turn == 0 &&
+        out_report.final_hash[0] == out_report.final_hash[1];
+    out_report.elapsed_ms = elapsed();
+    return out_report.completed;
+}
@@ -0,0 +1,206 @@
+// Lockstep.h
+// Deterministic lockstep multiplayer over Unigine sockets: peers exchange commands, never state
+// Every client runs the same CombatSimulation from the server's seed and a shared encounter.
+// A command is executed only when the server relays it back, so all peers apply one stream in
+// one order. The server runs the simulation too and relays a command only if the sending slot
+// controls the acting unit and the command is legal (CombatSimulation::validate); the sender
+// gets REJECTED otherwise. At turn starts (every hash_interval turns) clients report a 32-bit fold of the
+// turn hash; the server compares the reports and announces the first desynced turn.
+// Frames are [length][type][payload] over TCP. Commands are coded against the previous command
+// on the same connection (changed fields only, zigzag varints): a Stride or Strike is 4-8 bytes
+// on the wire, a typical turn a few dozen.
+// Scope: a protocol and determinism harness for Stride, Strike, End Turn, Undo and Redo, driven
+// only by LockstepSelfTest (console lockstep_test). Split out as follow-up work, not done here:
+//  - Casts. They are not CombatCommands (see SpellSystem.h) and CombatSimulation has no spell
+//    catalog, saves or effect table, so a peer cannot cast and a Strike ignores Bless and the like.
+//  - The live game. Peers play CombatSimulation, not the scene: relayed commands do not go
+//    through GameManager::executeCommand, TurnManager turn boundaries or GridSystem.
+// Networked play of the live game is therefore not supported.
+
+#pragma once
+
+#include "Replay.h"
+#include <UnigineSockets.h>
+#include <UnigineVector.h>
+
+enum class LockstepMessage : unsigned char {
+    HELLO,      // Client -> server: protocol version
+    WELCOME,    // Server -> client: slot, seed, hash interval
+    COMMAND,    // Client -> server: proposed command. Server -> clients: command to execute
+    HASH,       // Client -> server: turn delta since the last report + folded turn hash
+    DESYNC,     // Server -> clients: first turn whose reported hashes differ
+    REJECTED    // Server -> client: its proposed command was not relayed (wrong slot or illegal)
+};
+
+// Delta coder for one direction of one connection (sender and receiver keep one each, in step)
+class LockstepCommandCodec {
+public:
+    void reset() { previous = CombatCommand(); }
+
+    void encode(const CombatCommand& command, Unigine::Vector<unsigned char>& out);
+    bool decode(const unsigned char* data, int size, CombatCommand& out);
+
+private:
+    CombatCommand previous;
+};
+
+// Framed, non-blocking message stream over a connected socket
+class LockstepConnection {
+public:
+    LockstepConnection() : bytes_sent(0), bytes_received(0), closed(false) {}
+
+    void attach(const Unigine::SocketPtr& connected_socket);
+    bool isOpen() const { return socket && !closed; }
+
+    bool send(LockstepMessage type, const Unigine::Vector<unsigned char>& payload);
+
+    // Next complete frame, if one has arrived (reads whatever the socket has first)
+    bool receive(LockstepMessage& out_type, Unigine::Vector<unsigned char>& out_payload);
+
+    int getBytesSent() const { return bytes_sent; }
+    int getBytesReceived() const { return bytes_received; }
+
+private:
+    Unigine::SocketPtr socket;
+    Unigine::Vector<unsigned char> inbox;     // Received bytes not yet returned as frames
+    Unigine::Vector<unsigned char> frame;     // Send scratch
+    int bytes_sent;
+    int bytes_received;
+    bool closed;
+};
+
+// Authoritative server: checks, orders and relays commands, compares turn hashes.
+// Slot 0 plays the player units, slot 1 the enemies.
+class LockstepServer {
+public:
+    LockstepServer(const CombatSnapshot& encounter, int num_clients, unsigned long long seed, int hash_interval);
+    ~LockstepServer();
+
+    bool listen(const char* host, int port);
+    void update();
+
+    int getNumClients() const { return peers.size(); }
+    int getDesyncTurn() const { return desync_turn; }      // 0 = none
+    int getCommandsRelayed() const { return commands_relayed; }
+    int getCommandsRejected() const { return commands_rejected; }
+    int getHashesCompared() const { return hashes_compared; }
+    bool hasPendingHashes() const { return pending.size() > 0; }
+
+private:
+    struct Peer {
+        LockstepConnection connection;
+        LockstepCommandCodec from_client;
+        LockstepCommandCodec to_client;
+        int slot;
+        int last_hash_turn;
+    };
+
+    // First report of a turn, waiting for the others
+    struct TurnHash {
+        int turn;
+        unsigned int hash;
+        int reports;
+    };
+
+    CombatSnapshot encounter;
+    CombatSimulation* simulation;               // Referee state, created when every client is in
+    Unigine::SocketPtr listener;
+    Unigine::Vector<Peer*> peers;
+    Unigine::Vector<TurnHash> pending;
+    Unigine::Vector<unsigned char> payload;     // Scratch
+    int max_clients;
+    unsigned long long seed;
+    int hash_interval;
+    int desync_turn;
+    int commands_relayed;
+    int commands_rejected;
+    int hashes_compared;
+
+    void accept();
+    bool accepts(const Peer* peer, const CombatCommand& command, const char*& error) const;
+    void handle(Peer* peer, LockstepMessage type, const Unigine::Vector<unsigned char>& data);
+    void compareHash(int turn, unsigned int hash);
+
+    LockstepServer(const LockstepServer&) = delete;
+    LockstepServer& operator=(const LockstepServer&) = delete;
+};
+
+class LockstepClient {
+public:
+    explicit LockstepClient(const CombatSnapshot& encounter);
+    ~LockstepClient();
+
+    bool connect(const char* host, int port);
+
+    // Execute relayed commands and report hashes. Returns false once the connection failed
+    // or a relayed command did not execute (getError()).
+    bool update();
+
+    // Propose a command for one of this slot's units; it runs when the server relays it
+    void submit(const CombatCommand& command);
+
+    bool isStarted() const { return simulation != nullptr; }
+    bool isWaiting() const { return waiting; }                 // Own command not relayed yet
+    int getSlot() const { return slot; }
+    bool controls(const CombatantSnapshot& unit) const { return unit.is_player_unit == (slot == 0); }
+
+    const CombatSimulation* getSimulation() const { return simulation; }
+    int getDesyncTurn() const { return desync_turn; }
+    const char* getError() const { return error; }
+    const LockstepConnection& getConnection() const { return connection; }
+
+private:
+    CombatSnapshot encounter;
+    CombatSimulation* simulation;
+    LockstepConnection connection;
+    LockstepCommandCodec to_server;
+    LockstepCommandCodec from_server;
+    Unigine::Vector<unsigned char> payload;     // Scratch
+    int slot;
+    int hash_interval;
+    int last_hash_turn;
+    int desync_turn;
+    bool waiting;
+    const char* error;
+
+    bool handle(LockstepMessage type, const Unigine::Vector<unsigned char>& data);
+    void reportHash();
+
+    LockstepClient(const LockstepClient&) = delete;
+    LockstepClient& operator=(const LockstepClient&) = delete;
+};
+
+struct LockstepTestReport {
+    bool completed;             // Both clients finished with the same state
+    int turns;                  // Turns started on the slowest client
+    int commands;               // Commands relayed by the server
+    int hashes;                 // Turn hashes compared by the server
+    int desync_turn;            // First mismatching turn reported by the server (0 = none)
+    int bytes_up;               // Client -> server, both clients
+    int bytes_down;             // Server -> client, both clients
+    unsigned long long final_hash[2];
+    const char* error;
+    double elapsed_ms;
+
+    LockstepTestReport()
+        : completed(false)
+        , turns(0)
+        , commands(0)
+        , hashes(0)
+        , desync_turn(0)
+        , bytes_up(0)
+        , bytes_down(0)
+        , error("")
+        , elapsed_ms(0.0)
+    {
+        final_hash[0] = final_hash[1] = 0;
+    }
+};
+
+namespace LockstepSelfTest {
+    // Server and two scripted clients in this process over loopback, playing 'encounter' from
+    // 'seed' for up to max_turns turns (or until one side is down). inject_desync gives the
+    // second client a different starting HP on one unit, which the hashes must catch.
+    bool run(const CombatSnapshot& encounter, unsigned long long seed, int max_turns, int hash_interval,
+             bool inject_desync, int port, LockstepTestReport& out_report);
+}
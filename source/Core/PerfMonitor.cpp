@@ -0,0 +1,301 @@
+// PerfMonitor.cpp
+#include "PerfMonitor.h"
+#include "Arena.h"
+#include <UnigineLog.h>
+#include <UnigineConsole.h>
+#include <UnigineString.h>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    const int NUM_SYSTEMS = (int)PerfSystem::COUNT;
+    const int NUM_COUNTERS = (int)PerfCounter::COUNT;
+
+    const char* SYSTEM_NAMES[NUM_SYSTEMS] = { "selection", "ai", "pathing", "rendering", "ai_workers" };
+    const char* COUNTER_NAMES[NUM_COUNTERS] = {
+        "paths", "hover_hits", "hover_misses", "nodes_created", "heap_allocs", "scene_commands"
+    };
+
+    // Upper bounds of the histogram buckets in ms (last bucket is open-ended)
+    const float BUCKET_LIMITS[PerfMonitor::HISTOGRAM_BUCKETS] = {
+        0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 33.0f, 1e9f
+    };
+
+    // Defaults for a 60 FPS frame (16.6 ms) shared with the engine
+    const float DEFAULT_BUDGETS[NUM_SYSTEMS] = { 1.0f, 2.0f, 2.0f, 2.0f, 0.0f };
+
+    const unsigned int WARNING_INTERVAL = 60;   // Frames between warnings for one system
+    const int RECORD_FLUSH_ROWS = 60;
+
+    long long getHeapAllocations() {
+        long long total = 0;
+        for (int i = 0; i < (int)MemorySystem::COUNT; i++) {
+            total += MemoryStats::get((MemorySystem)i).heap_allocations;
+        }
+        return total;
+    }
+}
+
+PerfMonitor* PerfMonitor::get() {
+    static PerfMonitor monitor;
+    return &monitor;
+}
+
+PerfMonitor::PerfMonitor()
+    : frames(0)
+    , history_next(0)
+    , history_size(0)
+    , frame_number(0)
+    , last_heap_allocations(0)
+    , recording_rows(0)
+{
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        frame_ns[i].store(0);
+        budget_ms[i] = DEFAULT_BUDGETS[i];
+        last_warning[i] = 0;
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        frame_counts[i].store(0);
+    }
+    reset();
+}
+
+void PerfMonitor::addTime(PerfSystem system, double ms) {
+    frame_ns[(int)system].fetch_add((long long)(ms * 1000000.0), std::memory_order_relaxed);
+}
+
+void PerfMonitor::count(PerfCounter counter, int amount) {
+    frame_counts[(int)counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void PerfMonitor::endFrame() {
+    frame_number++;
+    frames++;
+
+    // Heap allocations come from MemoryStats: take this frame's difference
+    const long long heap = getHeapAllocations();
+    count(PerfCounter::HEAP_ALLOCATIONS, (int)(heap - last_heap_allocations));
+    last_heap_allocations = heap;
+
+    const int row = history_next;
+    history_next = (history_next + 1) % HISTORY_FRAMES;
+    if (history_size < HISTORY_FRAMES) history_size++;
+    history_frame[row] = frame_number;
+
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        const float ms = frame_ns[i].exchange(0, std::memory_order_relaxed) / 1000000.0f;
+        history_ms[row][i] = ms;
+        if (ms > max_ms[i]) max_ms[i] = ms;
+
+        int bucket = 0;
+        while (ms > BUCKET_LIMITS[bucket]) bucket++;
+        histogram[i][bucket]++;
+
+        // Over budget: warn at most once per WARNING_INTERVAL frames, with the overrun count
+        if (budget_ms[i] > 0.0f && ms > budget_ms[i]) {
+            overruns[i]++;
+            if (last_warning[i] == 0 || frame_number - last_warning[i] >= WARNING_INTERVAL) {
+                Unigine::Log::warning("PerfMonitor - %s over budget: %.2f ms (budget %.2f ms, %d frames over since last warning)\n",
+                    SYSTEM_NAMES[i], ms, budget_ms[i], overruns[i]);
+                last_warning[i] = frame_number;
+                overruns[i] = 0;
+            }
+        }
+    }
+
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        const int value = frame_counts[i].exchange(0, std::memory_order_relaxed);
+        history_counts[row][i] = value;
+        counter_totals[i] += value;
+    }
+
+    if (recording) {
+        writeCsvRow(recording, row);
+        if (++recording_rows % RECORD_FLUSH_ROWS == 0) recording->flush();
+    }
+}
+
+float PerfMonitor::getLastFrameMs(PerfSystem system) const {
+    if (history_size == 0) return 0.0f;
+    return history_ms[(history_next + HISTORY_FRAMES - 1) % HISTORY_FRAMES][(int)system];
+}
+
+float PerfMonitor::getPercentileMs(PerfSystem system, float percentile) const {
+    if (frames == 0) return 0.0f;
+
+    const int wanted = (int)(frames * percentile + 0.5f);
+    int seen = 0;
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS - 1; bucket++) {
+        seen += histogram[(int)system][bucket];
+        if (seen >= wanted) return BUCKET_LIMITS[bucket] < max_ms[(int)system] ? BUCKET_LIMITS[bucket] : max_ms[(int)system];
+    }
+    return max_ms[(int)system];
+}
+
+float PerfMonitor::getHoverHitRate() const {
+    const long long hits = counter_totals[(int)PerfCounter::HOVER_HITS];
+    const long long total = hits + counter_totals[(int)PerfCounter::HOVER_MISSES];
+    return total > 0 ? (float)hits / total : 0.0f;
+}
+
+void PerfMonitor::reset() {
+    frames = 0;
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        max_ms[i] = 0.0f;
+        overruns[i] = 0;
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+            histogram[i][bucket] = 0;
+        }
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        counter_totals[i] = 0;
+    }
+    last_heap_allocations = getHeapAllocations();
+}
+
+const char* PerfMonitor::getSystemName(PerfSystem system) {
+    return (int)system < NUM_SYSTEMS ? SYSTEM_NAMES[(int)system] : "?";
+}
+
+const char* PerfMonitor::getCounterName(PerfCounter counter) {
+    return (int)counter < NUM_COUNTERS ? COUNTER_NAMES[(int)counter] : "?";
+}
+
+float PerfMonitor::getBucketLimitMs(int bucket) {
+    return BUCKET_LIMITS[bucket];
+}
+
+bool PerfMonitor::exportCsv(const char* path) const {
+    Unigine::FilePtr file = Unigine::File::create();
+    if (!file->open(path, "wb")) {
+        Unigine::Log::warning("PerfMonitor::exportCsv() - Cannot open '%s'\n", path);
+        return false;
+    }
+
+    writeCsvHeader(file);
+    const int first = (history_next + HISTORY_FRAMES - history_size) % HISTORY_FRAMES;
+    for (int i = 0; i < history_size; i++) {
+        writeCsvRow(file, (first + i) % HISTORY_FRAMES);
+    }
+    file->close();
+
+    Unigine::Log::message("PerfMonitor::exportCsv() - %d frames written to '%s'\n", history_size, path);
+    return true;
+}
+
+bool PerfMonitor::startRecording(const char* path) {
+    stopRecording();
+
+    Unigine::FilePtr file = Unigine::File::create();
+    if (!file->open(path, "wb")) {
+        Unigine::Log::warning("PerfMonitor::startRecording() - Cannot open '%s'\n", path);
+        return false;
+    }
+    writeCsvHeader(file);
+    recording = file;
+    recording_rows = 0;
+
+    Unigine::Log::message("PerfMonitor::startRecording() - Recording frames to '%s'\n", path);
+    return true;
+}
+
+void PerfMonitor::stopRecording() {
+    if (!recording) return;
+
+    recording->close();
+    recording.clear();
+    Unigine::Log::message("PerfMonitor::stopRecording() - %d frames recorded\n", recording_rows);
+}
+
+void PerfMonitor::writeCsvHeader(const Unigine::FilePtr& file) const {
+    Unigine::String header = "frame";
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        header += Unigine::String::format(",%s_ms", SYSTEM_NAMES[i]);
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        header += Unigine::String::format(",%s", COUNTER_NAMES[i]);
+    }
+    header += "\n";
+    file->puts(header.get());
+}
+
+void PerfMonitor::writeCsvRow(const Unigine::FilePtr& file, int history_index) const {
+    Unigine::String line = Unigine::String::format("%u", history_frame[history_index]);
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        line += Unigine::String::format(",%.3f", history_ms[history_index][i]);
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        line += Unigine::String::format(",%d", history_counts[history_index][i]);
+    }
+    line += "\n";
+    file->puts(line.get());
+}
+
+void PerfMonitor::registerCommands() {
+    Unigine::Console::addCommand("perf_stats", "Print frame time percentiles and counters ('perf_stats reset' clears them)",
+        Unigine::MakeCallback(this, &PerfMonitor::consoleStats));
+    Unigine::Console::addCommand("perf_budget", "Set a system's frame budget: perf_budget <selection|ai|pathing|rendering|ai_workers> <ms>",
+        Unigine::MakeCallback(this, &PerfMonitor::consoleBudget));
+    Unigine::Console::addCommand("perf_csv", "Export the last frames as CSV: perf_csv <file>",
+        Unigine::MakeCallback(this, &PerfMonitor::consoleCsv));
+    Unigine::Console::addCommand("perf_record", "Stream every frame to a CSV file: perf_record <file|off>",
+        Unigine::MakeCallback(this, &PerfMonitor::consoleRecord));
+}
+
+void PerfMonitor::unregisterCommands() {
+    stopRecording();
+    Unigine::Console::removeCommand("perf_stats");
+    Unigine::Console::removeCommand("perf_budget");
+    Unigine::Console::removeCommand("perf_csv");
+    Unigine::Console::removeCommand("perf_record");
+}
+
+void PerfMonitor::consoleStats(int argc, char** argv) {
+    if (argc > 1 && !strcmp(argv[1], "reset")) {
+        reset();
+        Unigine::Log::message("perf_stats: reset\n");
+        return;
+    }
+
+    Unigine::Log::message("perf_stats: %d frames\n", frames);
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        const PerfSystem system = (PerfSystem)i;
+        Unigine::Log::message("  %-10s p50 <= %.2f ms  p95 <= %.2f ms  p99 <= %.2f ms  max %.2f ms  (budget %.2f ms)\n",
+            SYSTEM_NAMES[i], getPercentileMs(system, 0.5f), getPercentileMs(system, 0.95f),
+            getPercentileMs(system, 0.99f), max_ms[i], budget_ms[i]);
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        Unigine::Log::message("  %-14s %lld\n", COUNTER_NAMES[i], counter_totals[i]);
+    }
+    Unigine::Log::message("  hover cache hit rate %.1f%%\n", getHoverHitRate() * 100.0f);
+}
+
+void PerfMonitor::consoleBudget(int argc, char** argv) {
+    if (argc < 3) {
+        for (int i = 0; i < NUM_SYSTEMS; i++) {
+            Unigine::Log::message("perf_budget: %s %.2f ms\n", SYSTEM_NAMES[i], budget_ms[i]);
+        }
+        return;
+    }
+
+    for (int i = 0; i < NUM_SYSTEMS; i++) {
+        if (!strcmp(argv[1], SYSTEM_NAMES[i])) {
+            budget_ms[i] = (float)atof(argv[2]);
+            Unigine::Log::message("perf_budget: %s %.2f ms\n", SYSTEM_NAMES[i], budget_ms[i]);
+            return;
+        }
+    }
+    Unigine::Log::warning("perf_budget: unknown system '%s'\n", argv[1]);
+}
+
+void PerfMonitor::consoleCsv(int argc, char** argv) {
+    exportCsv(argc > 1 ? argv[1] : "perf.csv");
+}
+
+void PerfMonitor::consoleRecord(int argc, char** argv) {
+    if (argc > 1 && !strcmp(argv[1], "off")) {
+        stopRecording();
+        return;
+    }
+    startRecording(argc > 1 ? argv[1] : "perf_record.csv");
+}
@@ -0,0 +1,132 @@
+// PerfMonitor.h
+// Always-on runtime metrics: per-system frame times (histograms, budgets) and event counters
+// Times and counts may be added from any thread; endFrame() (main thread, once per frame)
+// folds them into histograms, a rolling history for CSV export and budget warnings.
+
+#pragma once
+
+#include <UnigineStreams.h>
+#include <atomic>
+#include <chrono>
+
+// Timed systems (a system's time may include nested systems, e.g. AI_WORKERS includes its pathing)
+enum class PerfSystem : unsigned char {
+    SELECTION,      // Input, picking, hover preview
+    AI,             // Plan application (main thread)
+    PATHING,        // Reachability and path searches (main thread; worker searches count in their job)
+    RENDERING,      // Scene commands, grid streaming and visual updates
+    AI_WORKERS,     // Enemy planning on the job workers (off the frame, no budget by default)
+    COUNT
+};
+
+enum class PerfCounter : unsigned char {
+    PATHS_COMPUTED,
+    HOVER_HITS,
+    HOVER_MISSES,
+    NODES_CREATED,
+    HEAP_ALLOCATIONS,   // Counted by MemoryStats (arena growth and arena-aware containers)
+    SCENE_COMMANDS,
+    COUNT
+};
+
+class PerfMonitor {
+public:
+    static const int HISTOGRAM_BUCKETS = 10;
+    static const int HISTORY_FRAMES = 600;          // Rolling window (10 s at 60 FPS)
+
+    static PerfMonitor* get();
+
+    // Thread-safe accumulation into the current frame
+    void addTime(PerfSystem system, double ms);
+    void count(PerfCounter counter, int amount = 1);
+
+    // Close the current frame: histograms, history row, budget warnings, CSV recording
+    void endFrame();
+
+    // Frame budget per system in ms (0 = no budget)
+    void setBudget(PerfSystem system, float ms) { budget_ms[(int)system] = ms; }
+    float getBudget(PerfSystem system) const { return budget_ms[(int)system]; }
+
+    // Statistics since the last reset()
+    float getLastFrameMs(PerfSystem system) const;
+    float getPercentileMs(PerfSystem system, float percentile) const;  // Histogram bucket bound
+    float getMaxMs(PerfSystem system) const { return max_ms[(int)system]; }
+    long long getCounterTotal(PerfCounter counter) const { return counter_totals[(int)counter]; }
+    float getHoverHitRate() const;
+    void reset();
+
+    static const char* getSystemName(PerfSystem system);
+    static const char* getCounterName(PerfCounter counter);
+    static float getBucketLimitMs(int bucket);
+
+    // Rolling history as CSV (one row per frame, oldest first)
+    bool exportCsv(const char* path) const;
+
+    // Stream rows to a CSV file while playing (flushed once a second)
+    bool startRecording(const char* path);
+    void stopRecording();
+
+    // Console: perf_stats [reset], perf_budget <system> <ms>, perf_csv <file>, perf_record <file|off>
+    void registerCommands();
+    void unregisterCommands();
+
+private:
+    PerfMonitor();
+
+    // Current frame (any thread)
+    std::atomic<long long> frame_ns[(int)PerfSystem::COUNT];
+    std::atomic<int> frame_counts[(int)PerfCounter::COUNT];
+
+    // Folded by endFrame (main thread)
+    float budget_ms[(int)PerfSystem::COUNT];
+    int histogram[(int)PerfSystem::COUNT][HISTOGRAM_BUCKETS];
+    float max_ms[(int)PerfSystem::COUNT];
+    long long counter_totals[(int)PerfCounter::COUNT];
+    int frames;
+
+    // Rolling history (ring buffer)
+    float history_ms[HISTORY_FRAMES][(int)PerfSystem::COUNT];
+    int history_counts[HISTORY_FRAMES][(int)PerfCounter::COUNT];
+    unsigned int history_frame[HISTORY_FRAMES];
+    int history_next;
+    int history_size;
+    unsigned int frame_number;
+
+    // Budget warnings are rate limited per system
+    int overruns[(int)PerfSystem::COUNT];
+    unsigned int last_warning[(int)PerfSystem::COUNT];
+
+    long long last_heap_allocations;
+
+    Unigine::FilePtr recording;
+    int recording_rows;
+
+    void writeCsvHeader(const Unigine::FilePtr& file) const;
+    void writeCsvRow(const Unigine::FilePtr& file, int history_index) const;
+
+    void consoleStats(int argc, char** argv);
+    void consoleBudget(int argc, char** argv);
+    void consoleCsv(int argc, char** argv);
+    void consoleRecord(int argc, char** argv);
+
+    // Prevent copying
+    PerfMonitor(const PerfMonitor&) = delete;
+    PerfMonitor& operator=(const PerfMonitor&) = delete;
+};
+
+// Adds the time between construction and destruction to a system (nothing if not enabled)
+class PerfScope {
+public:
+    explicit PerfScope(PerfSystem _system, bool _enabled = true)
+        : system(_system), enabled(_enabled), start(std::chrono::steady_clock::now()) {}
+    ~PerfScope() {
+        if (!enabled) return;
+        PerfMonitor::get()->addTime(system,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    PerfSystem system;
+    bool enabled;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,503 @@
+// Replay.cpp
+#include "Replay.h"
+#include "CombatRules.h"
+#include "CombatHistory.h"
+#include "StateHash.h"
+#include <chrono>
+
+using namespace Unigine;
+
+namespace {
+    // Load limits: a corrupt count must fail, not allocate gigabytes
+    const int MAX_UNITS = 4096;
+    const int MAX_COMMANDS = 1 << 20;
+    const int MAX_CHECKPOINTS = 1 << 20;
+
+    // Ints per record of each table
+    const int UNIT_INTS = 12;
+    const int COMMAND_INTS = 5;
+    const int CHECKPOINT_INTS = 5;      // 64-bit hash as two ints
+
+    template <class T>
+    void writeArray(const StreamPtr& stream, const Vector<T>& data) {
+        stream->writeInt(data.size());
+        if (data.size() > 0) stream->write(data.get(), sizeof(T) * data.size());
+    }
+
+    template <class T>
+    bool readArray(const StreamPtr& stream, Vector<T>& data, int max_size) {
+        int size = stream->readInt();
+        if (size < 0 || size > max_size) return false;
+
+        data.resize(size);
+        size_t bytes = sizeof(T) * size;
+        return bytes == 0 || stream->read(data.get(), bytes) == bytes;
+    }
+
+    // Records of 'count' ints, without a size prefix; false on a short read
+    void writeInts(const StreamPtr& stream, const Vector<int>& data) {
+        if (data.size() > 0) stream->write(data.get(), sizeof(int) * data.size());
+    }
+
+    bool readInts(const StreamPtr& stream, Vector<int>& data, int count) {
+        data.resize(count);
+        size_t bytes = sizeof(int) * count;
+        return bytes == 0 || stream->read(data.get(), bytes) == bytes;
+    }
+
+    void writeLong(const StreamPtr& stream, unsigned long long value) {
+        stream->writeInt((int)(value & 0xFFFFFFFFULL));
+        stream->writeInt((int)(value >> 32));
+    }
+
+    unsigned long long readLong(const StreamPtr& stream) {
+        unsigned long long low = (unsigned int)stream->readInt();
+        unsigned long long high = (unsigned int)stream->readInt();
+        return low | (high << 32);
+    }
+}
+
+CombatSimulation::CombatSimulation(unsigned long long seed, const CombatSnapshot& encounter_state)
+    : encounter(encounter_state)
+    , rng(seed)
+    , round(1)
+    , turn_index(-1)
+    , turns_started(0)
+    , undo_cursor(0)
+{
+    state.units = encounter.combatants;
+    state.occupant = encounter.occupant;
+    state.actions = 3;
+    state.attacks = 0;
+}
+
+void CombatSimulation::startCombat() {
+    // Same roll order as TurnManager::rollInitiative: players, then enemies, living only
+    Vector<CombatantSnapshot>& units = state.units;
+    for (int i = 0; i < units.size(); i++) {
+        if (!units[i].isAlive()) continue;
+
+        Entry entry;
+        entry.combatant = i;
+        entry.initiative_value = CombatRules::rollInitiative(rng, units[i].perception);
+        entry.is_player_unit = units[i].is_player_unit;
+        units[i].initiative = entry.initiative_value;
+        order.append(entry);
+    }
+    CombatRules::sortInitiative(order);
+
+    for (int i = 0; i < order.size(); i++) {
+        const CombatantSnapshot& unit = units[order[i].combatant];
+        state.hash.toggleUnitPosition(unit.node_id, CombatHistory::packPosition(unit.position));
+        state.hash.toggleUnitHP(unit.node_id, unit.current_hp);
+        state.hash.toggleInitiative(i, unit.node_id, unit.initiative);
+    }
+
+    startNextTurn();
+}
+
+void CombatSimulation::startNextTurn() {
+    turn_index++;
+    if (turn_index >= order.size()) {
+        round++;
+        turn_index = 0;
+    }
+    state.actions = 3;
+    state.attacks = 0;
+    turns_started++;
+    undo_states.clear();
+    undo_cursor = 0;
+}
+
+unsigned long long CombatSimulation::getTurnHash() const {
+    return state.hash.getTurnValue(round, turn_index);
+}
+
+int CombatSimulation::getActor() const {
+    if (turn_index < 0 || turn_index >= order.size()) return -1;
+    return order[turn_index].combatant;
+}
+
+int CombatSimulation::getOccupant(GridPosition pos) const {
+    if (pos.x < 0 || pos.y < 0 || pos.x >= encounter.width || pos.y >= encounter.height) return -1;
+    return state.occupant[encounter.getIndex(pos)];
+}
+
+int CombatSimulation::findUnit(int node_id) const {
+    for (int i = 0; i < state.units.size(); i++) {
+        if (state.units[i].node_id == node_id) return i;
+    }
+    return -1;
+}
+
+void CombatSimulation::beginAction() {
+    undo_states.resize(undo_cursor * 2);
+    undo_states.append(state);
+}
+
+void CombatSimulation::endAction() {
+    undo_states.append(state);
+    undo_cursor++;
+}
+
+void CombatSimulation::commit() {
+    undo_states.clear();
+    undo_cursor = 0;
+}
+
+bool CombatSimulation::validate(const CombatCommand& command, const char*& error) const {
+    if (order.size() == 0) {
+        error = "no combatants";
+        return false;
+    }
+
+    const int actor = order[turn_index].combatant;
+    const CombatantSnapshot& self = state.units[actor];
+    if (self.node_id != command.actor_node_id) {
+        error = "command issued by a unit whose turn it is not";
+        return false;
+    }
+
+    switch (command.type) {
+    case CommandType::STRIDE: {
+        if (state.actions < command.action_cost) {
+            error = "stride without enough actions";
+            return false;
+        }
+        const GridPosition to = command.destination;
+        if (to.x < 0 || to.y < 0 || to.x >= encounter.width || to.y >= encounter.height) {
+            error = "stride off the grid";
+            return false;
+        }
+        if (state.occupant[encounter.getIndex(to)] != -1) {
+            error = "stride onto an occupied cell";
+            return false;
+        }
+
+        // Terrain and living units block, as in CombatSnapshot::buildStrideMask
+        const int num_cells = encounter.width * encounter.height;
+        Vector<unsigned char> mask;
+        mask.resize(num_cells);
+        for (int i = 0; i < num_cells; i++) {
+            const int other = state.occupant[i];
+            const bool occupied = other >= 0 && other != actor && state.units[other].isAlive();
+            mask[i] = (encounter.blocked[i] || occupied) ? 1 : 0;
+        }
+        if (!CombatRules::canStride(encounter.getView(mask), self.position, to, self.speed, command.action_cost)) {
+            error = "stride out of range or blocked";
+            return false;
+        }
+        return true;
+    }
+    case CommandType::STRIKE: {
+        const int target = findUnit(command.target_node_id);
+        if (target < 0 || state.actions < 1) {
+            error = "strike without a target or actions";
+            return false;
+        }
+        const CombatantSnapshot& defender = state.units[target];
+        if (!defender.isAlive() || defender.is_player_unit == self.is_player_unit) {
+            error = "strike at a fallen or friendly unit";
+            return false;
+        }
+        if (!CombatRules::isInReach(self.position, defender.position)) {
+            error = "strike out of reach";
+            return false;
+        }
+        return true;
+    }
+    case CommandType::UNDO:
+        if (undo_cursor == 0) {
+            error = "undo with nothing to undo";
+            return false;
+        }
+        return true;
+
+    case CommandType::REDO:
+        if (undo_cursor * 2 >= undo_states.size()) {
+            error = "redo with nothing to redo";
+            return false;
+        }
+        return true;
+
+    case CommandType::END_TURN:
+        return true;
+    }
+    error = "unknown command";
+    return false;
+}
+
+bool CombatSimulation::execute(const CombatCommand& command, const char*& error) {
+    if (!validate(command, error)) return false;
+
+    const int actor = order[turn_index].combatant;
+    switch (command.type) {
+    case CommandType::STRIDE: {
+        const GridPosition to = command.destination;
+
+        beginAction();
+        CombatantSnapshot& unit = state.units[actor];
+        state.occupant[encounter.getIndex(unit.position)] = -1;
+        state.occupant[encounter.getIndex(to)] = actor;
+        state.hash.applyDelta(DeltaType::UNIT_POSITION, unit.node_id,
+            CombatHistory::packPosition(unit.position), CombatHistory::packPosition(to));
+        unit.position = to;
+        state.actions -= command.action_cost;
+        endAction();
+        return true;
+    }
+    case CommandType::STRIKE: {
+        const int target = findUnit(command.target_node_id);
+
+        beginAction();
+        const CombatantSnapshot& attacker = state.units[actor];
+        CombatantSnapshot& defender = state.units[target];
+
+        // Cover and height exactly as the live Strike reads them from GridSystem
+        const StrikeSituation situation = CombatRules::getStrikeSituation(attacker.position, defender.position,
+            [this](int x, int y) {
+                const int index = encounter.getIndex(x, y);
+                if (state.occupant[index] != -1) return StrikeCell::CREATURE;
+                return encounter.blocked[index] ? StrikeCell::BLOCKED : StrikeCell::EMPTY;
+            });
+
+        StrikeResult result = CombatRules::resolveStrike(rng, attacker.attack_bonus + situation.height_bonus,
+            CombatRules::getMultipleAttackPenalty(state.attacks, false), defender.armor_class + situation.cover_bonus,
+            attacker.damage);
+
+        if (result.damage > 0) {
+            int hp = defender.current_hp - result.damage;
+            if (hp < 0) hp = 0;
+            state.hash.applyDelta(DeltaType::UNIT_HP, defender.node_id, defender.current_hp, hp);
+            defender.current_hp = hp;
+        }
+        state.actions--;
+        state.attacks++;
+        endAction();
+        commit();
+        return true;
+    }
+    case CommandType::UNDO:
+        undo_cursor--;
+        state = undo_states[undo_cursor * 2];
+        return true;
+
+    case CommandType::REDO:
+        state = undo_states[undo_cursor * 2 + 1];
+        undo_cursor++;
+        return true;
+
+    case CommandType::END_TURN:
+        startNextTurn();
+        return true;
+    }
+    return false;
+}
+
+void ReplayLog::clear() {
+    seed = 0;
+    encounter = CombatSnapshot();
+    commands.clear();
+    checkpoints.clear();
+}
+
+bool ReplayLog::save(const StreamPtr& stream) const {
+    if (!stream) return false;
+
+    stream->writeInt(MAGIC);
+    stream->writeInt(VERSION);
+    writeLong(stream, seed);
+
+    // Encounter grid
+    stream->writeInt(encounter.width);
+    stream->writeInt(encounter.height);
+    writeArray(stream, encounter.blocked);
+    writeArray(stream, encounter.elevation);
+    writeArray(stream, encounter.occupant);
+
+    // Encounter units, commands and checkpoints: fixed-size records of plain ints, each table
+    // staged and written in one call
+    Vector<int> records;
+    records.reserve(encounter.combatants.size() * UNIT_INTS);
+    for (int i = 0; i < encounter.combatants.size(); i++) {
+        const CombatantSnapshot& unit = encounter.combatants[i];
+        records.append(unit.node_id);
+        records.append(CombatHistory::packPosition(unit.position));
+        records.append(unit.current_hp);
+        records.append(unit.max_hp);
+        records.append(unit.armor_class);
+        records.append(unit.attack_bonus);
+        records.append(unit.speed);
+        records.append(unit.perception);
+        records.append(unit.damage.count);
+        records.append(unit.damage.sides);
+        records.append(unit.damage.bonus);
+        records.append(unit.is_player_unit ? 1 : 0);
+    }
+    stream->writeInt(encounter.combatants.size());
+    writeInts(stream, records);
+
+    records.clear();
+    records.reserve(commands.size() * COMMAND_INTS);
+    for (int i = 0; i < commands.size(); i++) {
+        const CombatCommand& command = commands[i];
+        records.append((int)command.type);
+        records.append(command.actor_node_id);
+        records.append(command.target_node_id);
+        records.append(CombatHistory::packPosition(command.destination));
+        records.append(command.action_cost);
+    }
+    stream->writeInt(commands.size());
+    writeInts(stream, records);
+
+    records.clear();
+    records.reserve(checkpoints.size() * CHECKPOINT_INTS);
+    for (int i = 0; i < checkpoints.size(); i++) {
+        records.append(checkpoints[i].turn_number);
+        records.append(checkpoints[i].round);
+        records.append(checkpoints[i].turn_index);
+        records.append((int)(checkpoints[i].hash & 0xFFFFFFFFULL));
+        records.append((int)(checkpoints[i].hash >> 32));
+    }
+    stream->writeInt(checkpoints.size());
+    writeInts(stream, records);
+    return true;
+}
+
+bool ReplayLog::load(const StreamPtr& stream) {
+    clear();
+    if (!stream) return false;
+    if (stream->readInt() != MAGIC) return false;
+    if (stream->readInt() != VERSION) return false;
+    seed = readLong(stream);
+
+    encounter.width = stream->readInt();
+    encounter.height = stream->readInt();
+    if (encounter.width <= 0 || encounter.height <= 0 || encounter.width > 4096 || encounter.height > 4096) return false;
+
+    const int num_cells = encounter.width * encounter.height;
+    if (!readArray(stream, encounter.blocked, num_cells)) return false;
+    if (!readArray(stream, encounter.elevation, num_cells)) return false;
+    if (!readArray(stream, encounter.occupant, num_cells)) return false;
+    if (encounter.blocked.size() != num_cells || encounter.elevation.size() != num_cells
+        || encounter.occupant.size() != num_cells) {
+        return false;
+    }
+
+    // Every table is capped and must be read in full (a truncated file fails, it does not
+    // load as zeros)
+    Vector<int> records;
+    const int num_units = stream->readInt();
+    if (num_units < 0 || num_units > MAX_UNITS || !readInts(stream, records, num_units * UNIT_INTS)) return false;
+    encounter.combatants.resize(num_units);
+    for (int i = 0; i < num_units; i++) {
+        const int* record = records.get() + i * UNIT_INTS;
+        CombatantSnapshot& unit = encounter.combatants[i];
+        unit.node_id = record[0];
+        unit.position = CombatHistory::unpackPosition(record[1]);
+        unit.current_hp = record[2];
+        unit.max_hp = record[3];
+        unit.armor_class = record[4];
+        unit.attack_bonus = record[5];
+        unit.speed = record[6];
+        unit.perception = record[7];
+        unit.damage.count = record[8];
+        unit.damage.sides = record[9];
+        unit.damage.bonus = record[10];
+        unit.is_player_unit = record[11] != 0;
+        unit.initiative = 0;
+    }
+
+    const int num_commands = stream->readInt();
+    if (num_commands < 0 || num_commands > MAX_COMMANDS || !readInts(stream, records, num_commands * COMMAND_INTS)) {
+        return false;
+    }
+    commands.resize(num_commands);
+    for (int i = 0; i < num_commands; i++) {
+        const int* record = records.get() + i * COMMAND_INTS;
+        CombatCommand& command = commands[i];
+        command.type = (CommandType)record[0];
+        command.actor_node_id = record[1];
+        command.target_node_id = record[2];
+        command.destination = CombatHistory::unpackPosition(record[3]);
+        command.action_cost = record[4];
+    }
+
+    const int num_checkpoints = stream->readInt();
+    if (num_checkpoints < 0 || num_checkpoints > MAX_CHECKPOINTS
+        || !readInts(stream, records, num_checkpoints * CHECKPOINT_INTS)) {
+        return false;
+    }
+    checkpoints.resize(num_checkpoints);
+    for (int i = 0; i < num_checkpoints; i++) {
+        const int* record = records.get() + i * CHECKPOINT_INTS;
+        checkpoints[i].turn_number = record[0];
+        checkpoints[i].round = record[1];
+        checkpoints[i].turn_index = record[2];
+        checkpoints[i].hash = (unsigned long long)(unsigned int)record[3]
+            | ((unsigned long long)(unsigned int)record[4] << 32);
+    }
+    return true;
+}
+
+void ReplayRecorder::begin(unsigned long long seed, const CombatSnapshot& encounter) {
+    log.clear();
+    log.seed = seed;
+    log.encounter = encounter;
+    recording = true;
+}
+
+void ReplayRecorder::recordCommand(const CombatCommand& command) {
+    if (recording) log.commands.append(command);
+}
+
+void ReplayRecorder::checkpoint(int round, int turn_index, unsigned long long hash) {
+    if (!recording) return;
+
+    ReplayCheckpoint checkpoint;
+    checkpoint.turn_number = log.checkpoints.size() + 1;
+    checkpoint.round = round;
+    checkpoint.turn_index = turn_index;
+    checkpoint.hash = hash;
+    log.checkpoints.append(checkpoint);
+}
+
+bool ReplayRunner::run(const ReplayLog& log, ReplayReport& out_report) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    out_report = ReplayReport();
+    CombatSimulation simulation(log.seed, log.encounter);
+    simulation.startCombat();
+
+    // Compare the checkpoint of every turn started; stop at the first divergence
+    bool matched = true;
+    int turns_compared = 0;
+    for (int i = 0; matched; i++) {
+        while (matched && turns_compared < simulation.getTurnsStarted()) {
+            turns_compared++;
+            if (turns_compared > log.checkpoints.size()) break;
+
+            const unsigned long long expected = log.checkpoints[turns_compared - 1].hash;
+            const unsigned long long actual = simulation.getTurnHash();
+            out_report.turns_checked = turns_compared;
+            if (actual != expected) {
+                matched = false;
+                out_report.first_divergent_turn = turns_compared;
+                out_report.expected_hash = expected;
+                out_report.actual_hash = actual;
+            }
+        }
+        if (!matched || i >= log.commands.size()) break;
+
+
+        if (!simulation.execute(log.commands[i], out_report.error)) {
+            matched = false;
+            out_report.first_divergent_turn = simulation.getTurnsStarted();
+        }
+    }
+
+    out_report.completed = matched && out_report.turns_checked == log.checkpoints.size();
+    out_report.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return out_report.completed;
+}
@@ -0,0 +1,150 @@
+// Replay.h
+// Deterministic combat replays: encounter seed + initial state + command stream,
+// with a state hash checkpointed at every turn start.
+// ReplayRunner re-simulates a log headlessly (plain data, no nodes, no logging) and
+// reports the first turn whose hash differs - regression tests for rules changes and
+// exact reproduction of bug reports. Lockstep peers (Lockstep.h) run the same simulation.
+
+#pragma once
+
+#include "CombatCommand.h"
+#include "CombatRandom.h"
+#include "StateHash.h"
+#include "../AI/CombatSnapshot.h"
+#include <UnigineVector.h>
+#include <UnigineStreams.h>
+
+// Hash taken at TurnManager::startNextTurn
+struct ReplayCheckpoint {
+    int turn_number;            // 1-based count of turns started
+    int round;
+    int turn_index;
+    unsigned long long hash;
+};
+
+struct ReplayLog {
+    static const int MAGIC = 0x50524E41;    // "ANRP"
+    static const int VERSION = 1;
+
+    unsigned long long seed;
+    CombatSnapshot encounter;   // Units in startCombat order (players, then enemies)
+    Unigine::Vector<CombatCommand> commands;
+    Unigine::Vector<ReplayCheckpoint> checkpoints;
+
+    ReplayLog() : seed(0) {}
+
+    void clear();
+    bool save(const Unigine::StreamPtr& stream) const;
+    bool load(const Unigine::StreamPtr& stream);
+};
+
+// Live capture, fed by GameManager (commands) and TurnManager (checkpoints)
+class ReplayRecorder {
+public:
+    ReplayRecorder() : recording(false) {}
+
+    void begin(unsigned long long seed, const CombatSnapshot& encounter);
+    void end() { recording = false; }
+    bool isRecording() const { return recording; }
+
+    void recordCommand(const CombatCommand& command);
+    void checkpoint(int round, int turn_index, unsigned long long hash);
+
+    const ReplayLog& getLog() const { return log; }
+
+private:
+    ReplayLog log;
+    bool recording;
+};
+
+struct ReplayReport {
+    bool completed;             // Every command executed and every checkpoint matched
+    int turns_checked;
+    int first_divergent_turn;   // 1-based, 0 = no divergence
+    unsigned long long expected_hash;
+    unsigned long long actual_hash;
+    const char* error;          // Static reason when a command could not be executed
+    double elapsed_ms;
+
+    ReplayReport()
+        : completed(false)
+        , turns_checked(0)
+        , first_divergent_turn(0)
+        , expected_hash(0)
+        , actual_hash(0)
+        , error("")
+        , elapsed_ms(0.0)
+    {}
+};
+
+// Mirror of TurnManager + GameManager::executeCommand over plain data (no nodes, no logging).
+// Every peer that executes the same commands from the same seed and encounter reaches the
+// same state and the same turn hashes as the live game.
+class CombatSimulation {
+public:
+    CombatSimulation(unsigned long long seed, const CombatSnapshot& encounter);
+
+    // Roll initiative and start the first turn
+    void startCombat();
+
+    // Apply one command for the unit whose turn it is. On failure 'error' gets a static reason
+    // and the state is unchanged.
+    bool execute(const CombatCommand& command, const char*& error);
+
+    // The checks execute() runs, without applying the command (same rules as the live
+    // GameManager::executeCommand: reachable free cell, living adjacent foe, actions left)
+    bool validate(const CombatCommand& command, const char*& error) const;
+
+    // Turn counters (TurnManager::startNextTurn equivalents)
+    int getTurnsStarted() const { return turns_started; }
+    int getRound() const { return round; }
+    unsigned long long getTurnHash() const;
+
+    // Acting combatant index into getUnits() (-1 before startCombat)
+    int getActor() const;
+    int getActionsRemaining() const { return state.actions; }
+
+    const CombatSnapshot& getEncounter() const { return encounter; }
+    const Unigine::Vector<CombatantSnapshot>& getUnits() const { return state.units; }
+    int getOccupant(GridPosition pos) const;     // Combatant index, -1 = empty or off the grid
+    int findUnit(int node_id) const;
+
+private:
+    // Initiative slot (same fields TurnManager sorts on)
+    struct Entry {
+        int combatant;
+        int initiative_value;
+        bool is_player_unit;
+    };
+
+    // Everything an action can change (undo/redo restore whole copies)
+    struct State {
+        Unigine::Vector<CombatantSnapshot> units;
+        Unigine::Vector<int> occupant;
+        StateHash hash;
+        int actions;
+        int attacks;
+    };
+
+    CombatSnapshot encounter;
+    State state;
+    Unigine::Vector<Entry> order;
+    CombatRandom rng;
+    int round;
+    int turn_index;
+    int turns_started;
+
+    // This turn's actions, as (before, after) pairs - CombatHistory equivalent
+    Unigine::Vector<State> undo_states;
+    int undo_cursor;
+
+    void startNextTurn();
+    void beginAction();
+    void endAction();
+    void commit();      // CombatHistory::commit equivalent (after rolls)
+};
+
+namespace ReplayRunner {
+    // Re-simulate the log with the current rules. Stops at the first divergence.
+    bool run(const ReplayLog& log, ReplayReport& out_report);
+}
@@ -0,0 +1,86 @@
+// SceneCommandBuffer.cpp
+#include "SceneCommandBuffer.h"
+#include <UnigineLog.h>
+#include <thread>
+
+SceneCommandBuffer::SceneCommandBuffer(int initial_capacity)
+    : active(0)
+    , capacity(initial_capacity > 16 ? initial_capacity : 16)
+    , overflow_total(0)
+{
+    buffers[0].commands.resize(capacity);
+    buffers[1].commands.resize(capacity);
+}
+
+SceneCommandBuffer::~SceneCommandBuffer() {
+}
+
+void SceneCommandBuffer::push(const SceneCommand& command) {
+    for (;;) {
+        const int index = active.load();
+        Buffer& buffer = buffers[index];
+
+        // Announce the write, then make sure drain() has not swapped this buffer out meanwhile
+        buffer.writers.fetch_add(1);
+        if (active.load() != index) {
+            buffer.writers.fetch_sub(1);
+            continue;
+        }
+
+        const int slot = buffer.count.fetch_add(1, std::memory_order_relaxed);
+        if (slot < (int)buffer.commands.size()) {
+            buffer.commands[slot] = command;
+        } else {
+            // Full: rare, the buffer grows on its next drain
+            std::lock_guard<std::mutex> lock(buffer.overflow_mutex);
+            buffer.overflow.push_back(command);
+        }
+
+        buffer.writers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+}
+
+int SceneCommandBuffer::drain(const std::function<void(const SceneCommand&)>& apply) {
+    const int index = active.load();
+    Buffer& buffer = buffers[index];
+
+    // New pushes go to the other buffer; wait for the ones already writing into this one.
+    // Both sides store then load (push: writers then active, here: active then writers), so
+    // the loads are seq_cst: with acquire, this could read writers == 0 before the swap is
+    // visible to a producer that then writes into the buffer being drained.
+    active.store(1 - index);
+    while (buffer.writers.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    const int count = buffer.count.load(std::memory_order_relaxed);
+    const int in_place = count < (int)buffer.commands.size() ? count : (int)buffer.commands.size();
+    for (int i = 0; i < in_place; i++) {
+        apply(buffer.commands[i]);
+    }
+
+    // Overflowed commands were pushed after every in-place slot was claimed
+    const int overflowed = (int)buffer.overflow.size();
+    for (int i = 0; i < overflowed; i++) {
+        apply(buffer.overflow[i]);
+    }
+    buffer.overflow.clear();
+    buffer.count.store(0, std::memory_order_relaxed);
+
+    if (overflowed > 0) {
+        // No producer can reach this buffer until the next swap: safe to resize
+        while (capacity < count) capacity *= 2;
+        buffer.commands.resize(capacity);
+        overflow_total += overflowed;
+        Unigine::Log::warning("SceneCommandBuffer::drain() - %d commands overflowed, capacity raised to %d\n",
+            overflowed, capacity);
+    }
+    if ((int)buffer.commands.size() < capacity) buffer.commands.resize(capacity);
+
+    return count;
+}
+
+int SceneCommandBuffer::getPendingCount() const {
+    return buffers[active.load()].count.load(std::memory_order_relaxed);
+}
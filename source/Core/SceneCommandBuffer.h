@@ -0,0 +1,120 @@
+// SceneCommandBuffer.h
+// Visual intents recorded by game logic (any thread) and applied to the scene in one batch
+// from AppWorldLogic::postUpdate, where nodes may be created, deleted and moved.
+// Commands reference nodes by ID and cells by coordinates - never by engine pointers.
+
+#pragma once
+
+#include <UnigineMathLib.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+enum class SceneCommandType : unsigned char {
+    SYNC_UNIT,          // Place a unit's node on its current grid cell
+    MOVE_NODE,          // Set a node's world position
+    ENABLE_NODE,        // Show or hide a node
+    HIGHLIGHT_CELL,     // Light a grid cell with a colour
+    UNHIGHLIGHT_CELL,
+    CLEAR_HIGHLIGHTS
+};
+
+struct SceneCommand {
+    SceneCommandType type;
+    int node_id;                        // SYNC_UNIT, MOVE_NODE, ENABLE_NODE
+    int x, y;                           // Cell commands
+    bool enabled;                       // ENABLE_NODE
+    Unigine::Math::dvec3 position;      // MOVE_NODE
+    Unigine::Math::vec4 color;          // HIGHLIGHT_CELL
+
+    SceneCommand()
+        : type(SceneCommandType::CLEAR_HIGHLIGHTS)
+        , node_id(0)
+        , x(0)
+        , y(0)
+        , enabled(true)
+    {}
+
+    static SceneCommand syncUnit(int node_id) {
+        SceneCommand command;
+        command.type = SceneCommandType::SYNC_UNIT;
+        command.node_id = node_id;
+        return command;
+    }
+
+    static SceneCommand moveNode(int node_id, const Unigine::Math::dvec3& position) {
+        SceneCommand command;
+        command.type = SceneCommandType::MOVE_NODE;
+        command.node_id = node_id;
+        command.position = position;
+        return command;
+    }
+
+    static SceneCommand enableNode(int node_id, bool enabled) {
+        SceneCommand command;
+        command.type = SceneCommandType::ENABLE_NODE;
+        command.node_id = node_id;
+        command.enabled = enabled;
+        return command;
+    }
+
+    static SceneCommand highlightCell(int x, int y, const Unigine::Math::vec4& color) {
+        SceneCommand command;
+        command.type = SceneCommandType::HIGHLIGHT_CELL;
+        command.x = x;
+        command.y = y;
+        command.color = color;
+        return command;
+    }
+
+    static SceneCommand unhighlightCell(int x, int y) {
+        SceneCommand command;
+        command.type = SceneCommandType::UNHIGHLIGHT_CELL;
+        command.x = x;
+        command.y = y;
+        return command;
+    }
+
+    static SceneCommand clearHighlights() {
+        return SceneCommand();
+    }
+};
+
+class SceneCommandBuffer {
+public:
+    explicit SceneCommandBuffer(int capacity = 1024);
+    ~SceneCommandBuffer();
+
+    // Record a command (thread-safe, lock-free unless this frame's buffer is full).
+    // Commands from one thread are applied in the order they were pushed.
+    void push(const SceneCommand& command);
+
+    // Main thread only: swap buffers and apply everything recorded since the last drain.
+    // Producers keep writing into the other buffer meanwhile. Returns the number applied.
+    int drain(const std::function<void(const SceneCommand&)>& apply);
+
+    int getPendingCount() const;                // Approximate (producers may be mid-push)
+    int getCapacity() const { return capacity; }
+    int getOverflowCount() const { return overflow_total; }   // Pushes that took the locked path
+
+private:
+    struct Buffer {
+        std::vector<SceneCommand> commands;     // Fixed size between drains
+        std::atomic<int> count;                 // Slots claimed (may exceed commands.size())
+        std::atomic<int> writers;               // Producers currently inside push()
+        std::mutex overflow_mutex;
+        std::vector<SceneCommand> overflow;     // Commands past the end of 'commands'
+
+        Buffer() : count(0), writers(0) {}
+    };
+
+    Buffer buffers[2];
+    std::atomic<int> active;                    // Buffer producers write into
+    int capacity;
+    int overflow_total;
+
+    // Prevent copying
+    SceneCommandBuffer(const SceneCommandBuffer&) = delete;
+    SceneCommandBuffer& operator=(const SceneCommandBuffer&) = delete;
+};
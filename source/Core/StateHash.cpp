@@ -0,0 +1,67 @@
+// StateHash.cpp
+#include "StateHash.h"
+#include "../AI/CombatSnapshot.h"
+
+namespace {
+    enum HashFeature {
+        FEATURE_POSITION = 1,
+        FEATURE_HP,
+        FEATURE_INITIATIVE_SLOT,
+        FEATURE_INITIATIVE_VALUE,
+        FEATURE_TURN
+    };
+
+    // splitmix64 finalizer: good avalanche, identical on every platform
+    unsigned long long mix(unsigned long long x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+}
+
+unsigned long long StateHash::getKey(int feature, int a, int b) {
+    return mix(mix(((unsigned long long)feature << 32) | (unsigned int)a) ^ (unsigned int)b);
+}
+
+void StateHash::toggleUnitPosition(int node_id, int packed_position) {
+    hash ^= getKey(FEATURE_POSITION, node_id, packed_position);
+}
+
+void StateHash::toggleUnitHP(int node_id, int hp) {
+    hash ^= getKey(FEATURE_HP, node_id, hp);
+}
+
+void StateHash::toggleInitiative(int slot, int node_id, int initiative) {
+    hash ^= getKey(FEATURE_INITIATIVE_SLOT, slot, node_id);
+    hash ^= getKey(FEATURE_INITIATIVE_VALUE, node_id, initiative);
+}
+
+void StateHash::applyDelta(DeltaType type, int key, int before, int after) {
+    switch (type) {
+    case DeltaType::UNIT_POSITION:
+        toggleUnitPosition(key, before);
+        toggleUnitPosition(key, after);
+        break;
+    case DeltaType::UNIT_HP:
+        toggleUnitHP(key, before);
+        toggleUnitHP(key, after);
+        break;
+    default:
+        break;
+    }
+}
+
+void StateHash::rebuild(const CombatSnapshot& snapshot) {
+    hash = 0;
+    for (int i = 0; i < snapshot.combatants.size(); i++) {
+        const CombatantSnapshot& combatant = snapshot.combatants[i];
+        toggleUnitPosition(combatant.node_id, CombatHistory::packPosition(combatant.position));
+        toggleUnitHP(combatant.node_id, combatant.current_hp);
+        toggleInitiative(i, combatant.node_id, combatant.initiative);
+    }
+}
+
+unsigned long long StateHash::getTurnValue(int round, int turn_index) const {
+    return hash ^ getKey(FEATURE_TURN, round, turn_index);
+}
@@ -0,0 +1,39 @@
+// StateHash.h
+// Incremental Zobrist-style hash of the combat state (unit positions, HP, initiative order)
+// Each (feature, value) pair maps to a pseudo-random 64-bit key; the hash is the XOR of the
+// keys of all current features, so a change costs two XORs (remove old, add new).
+// Keys are derived with a mixing function instead of a table, so any grid size and node ID works.
+
+#pragma once
+
+#include "CombatHistory.h"
+
+struct CombatSnapshot;
+
+class StateHash {
+public:
+    StateHash() : hash(0) {}
+
+    void clear() { hash = 0; }
+    unsigned long long getValue() const { return hash; }
+
+    // Feature toggles (call once to add a feature, again to remove it)
+    void toggleUnitPosition(int node_id, int packed_position);
+    void toggleUnitHP(int node_id, int hp);
+    void toggleInitiative(int slot, int node_id, int initiative);
+
+    // Apply a recorded change. Only UNIT_POSITION and UNIT_HP are hashed - grid occupancy
+    // follows from unit positions, terrain does not change during combat.
+    void applyDelta(DeltaType type, int key, int before, int after);
+
+    // Full recompute from plain combat data (combatants must be in initiative order)
+    void rebuild(const CombatSnapshot& snapshot);
+
+    // Hash of a turn checkpoint: state plus the turn counters
+    unsigned long long getTurnValue(int round, int turn_index) const;
+
+private:
+    unsigned long long hash;
+
+    static unsigned long long getKey(int feature, int a, int b);
+};
@@ -1,18 +1,32 @@
 // TurnManager.cpp
 #include "TurnManager.h"
 #include "../Components/UnitComponent.h"
+#include "CombatHistory.h"
+#include "CombatRules.h"
+#include "CombatantTable.h"
+#include "Replay.h"
 #include <UnigineNode.h>
 #include <UnigineLog.h>
 #include <UnigineGame.h>
-#include <random>
+
+namespace {
+    // Initiative slots reserved beyond the starting units (reinforcements, summons)
+    const int INITIATIVE_SPARE = 8;
+}
 
 TurnManager::TurnManager()
     : combat_active(false)
     , current_round(0)
     , current_turn_index(-1)
+    , turn_owner_removed(false)
     , actions_remaining(3)
     , attacks_this_turn(0)
     , used_agile_weapon(false)
+    , state_version(0)
+    , history(nullptr)
+    , replay(nullptr)
+    , encounter_arena("Encounter", 4096)
+    , initiative_order(ArenaAllocator<InitiativeEntry>(&encounter_arena, MemorySystem::TURN))
 {
 }
 
@@ -27,17 +41,20 @@ void TurnManager::startCombat(const Unigine::Vector<Unigine::NodePtr>& player_un
     combat_active = true;
     current_round = 1;
     current_turn_index = -1;
-    initiative_order.clear();
+    turn_owner_removed = false;
+    resetInitiativeOrder(player_units.size() + enemy_units.size());
+    state_version++;
 
     // Roll initiative for all units
     rollInitiative(player_units, enemy_units);
 
     // Sort by initiative (highest to lowest)
     sortInitiativeOrder();
+    rebuildStateHash();
 
     // Log initiative order
     Unigine::Log::message("Initiative order:\n");
-    for (int i = 0; i < initiative_order.size(); i++) {
+    for (int i = 0; i < (int)initiative_order.size(); i++) {
         const InitiativeEntry& entry = initiative_order[i];
         if (entry.unit_component) {
             Unigine::Log::message("  %d. %s (Initiative: %d) %s\n",
@@ -57,10 +74,64 @@ void TurnManager::endCombat() {
 
     Unigine::Log::message("TurnManager::endCombat() - Combat ended\n");
 
+    // Units stop recording HP changes once they leave combat
+    for (int i = 0; i < (int)initiative_order.size(); i++) {
+        if (initiative_order[i].unit_component) {
+            initiative_order[i].unit_component->history = nullptr;
+            initiative_order[i].unit_component->setFaction(Faction::NONE);
+        }
+    }
+
     combat_active = false;
     current_round = 0;
     current_turn_index = -1;
-    initiative_order.clear();
+    turn_owner_removed = false;
+    resetInitiativeOrder(0);
+    state_version++;
+
+    if (history) history->beginTurn();
+}
+
+void TurnManager::restoreCombat(const Unigine::Vector<InitiativeEntry>& order, int round, int turn_index) {
+    // Detach units of any combat in progress
+    for (int i = 0; i < (int)initiative_order.size(); i++) {
+        if (initiative_order[i].unit_component) {
+            initiative_order[i].unit_component->history = nullptr;
+        }
+    }
+
+    combat_active = true;
+    current_round = round;
+    current_turn_index = turn_index;
+    turn_owner_removed = false;
+    resetInitiativeOrder(order.size());
+    for (int i = 0; i < order.size(); i++) {
+        initiative_order.push_back(order[i]);
+    }
+    state_version++;
+
+    for (int i = 0; i < (int)initiative_order.size(); i++) {
+        if (initiative_order[i].unit_component) {
+            initiative_order[i].unit_component->history = history;
+            initiative_order[i].unit_component->setFaction(
+                initiative_order[i].is_player_unit ? Faction::PLAYER : Faction::ENEMY);
+        }
+    }
+    rebuildStateHash();
+
+    if (history) history->beginTurn();
+
+    Unigine::Log::message("TurnManager::restoreCombat() - Resumed round %d, turn %d (%d units)\n",
+        current_round, current_turn_index + 1, initiative_order.size());
+}
+
+void TurnManager::resetInitiativeOrder(int capacity) {
+    // Hand the old order's memory back before the encounter arena is reused
+    ArenaVector<InitiativeEntry>(ArenaAllocator<InitiativeEntry>(&encounter_arena, MemorySystem::TURN)).swap(initiative_order);
+    encounter_arena.reset();
+
+    // Room for reinforcements: joining units do not regrow the order mid-combat
+    initiative_order.reserve(capacity + INITIATIVE_SPARE);
 }
 
 void TurnManager::rollInitiative(const Unigine::Vector<Unigine::NodePtr>& player_units,
@@ -74,7 +145,9 @@ void TurnManager::rollInitiative(const Unigine::Vector<Unigine::NodePtr>& player
             entry.unit_component = unit;
             entry.initiative_value = rollInitiativeForUnit(unit);
             entry.is_player_unit = true;
-            initiative_order.append(entry);
+            initiative_order.push_back(entry);
+            unit->history = history;
+            unit->setFaction(Faction::PLAYER);
         }
     }
 
@@ -87,7 +160,9 @@ void TurnManager::rollInitiative(const Unigine::Vector<Unigine::NodePtr>& player
             entry.unit_component = unit;
             entry.initiative_value = rollInitiativeForUnit(unit);
             entry.is_player_unit = false;
-            initiative_order.append(entry);
+            initiative_order.push_back(entry);
+            unit->history = history;
+            unit->setFaction(Faction::ENEMY);
         }
     }
 }
@@ -95,42 +170,94 @@ void TurnManager::rollInitiative(const Unigine::Vector<Unigine::NodePtr>& player
 void TurnManager::sortInitiativeOrder() {
     // Sort by initiative value (highest to lowest)
     // On ties, player units go first
-    for (int i = 0; i < initiative_order.size() - 1; i++) {
-        for (int j = i + 1; j < initiative_order.size(); j++) {
-            bool should_swap = false;
-
-            if (initiative_order[i].initiative_value < initiative_order[j].initiative_value) {
-                // j has higher initiative
-                should_swap = true;
-            } else if (initiative_order[i].initiative_value == initiative_order[j].initiative_value) {
-                // Tie: player units go first
-                if (!initiative_order[i].is_player_unit && initiative_order[j].is_player_unit) {
-                    should_swap = true;
-                }
-            }
-
-            if (should_swap) {
-                InitiativeEntry temp = initiative_order[i];
-                initiative_order[i] = initiative_order[j];
-                initiative_order[j] = temp;
-            }
+    CombatRules::sortInitiative(initiative_order);
+}
+
+void TurnManager::addUnit(const Unigine::NodePtr& unit_node, bool is_player_unit) {
+    if (!combat_active) return;
+
+    UnitComponent* unit = Unigine::ComponentSystem::get()->getComponent<UnitComponent>(unit_node);
+    if (!unit || !unit->isAlive()) return;
+
+    InitiativeEntry entry;
+    entry.unit_node = unit_node;
+    entry.unit_component = unit;
+    entry.initiative_value = rollInitiativeForUnit(unit);
+    entry.is_player_unit = is_player_unit;
+    unit->history = history;
+    unit->setFaction(is_player_unit ? Faction::PLAYER : Faction::ENEMY);
+
+    // Same ordering as sortInitiativeOrder: higher first, players win ties, newcomers after equals
+    int index = 0;
+    while (index < (int)initiative_order.size()) {
+        const InitiativeEntry& other = initiative_order[index];
+        if (entry.initiative_value > other.initiative_value) break;
+        if (entry.initiative_value == other.initiative_value && entry.is_player_unit && !other.is_player_unit) break;
+        index++;
+    }
+    initiative_order.insert(initiative_order.begin() + index, entry);
+
+    // Keep the current unit current
+    if (index <= current_turn_index) current_turn_index++;
+
+    rebuildStateHash();
+    state_version++;
+
+    Unigine::Log::message("TurnManager::addUnit() - %s joins at position %d (Initiative: %d)\n",
+        unit->unit_name.get(), index + 1, entry.initiative_value);
+}
+
+void TurnManager::removeUnit(const Unigine::NodePtr& unit_node) {
+    for (int i = 0; i < (int)initiative_order.size(); i++) {
+        if (initiative_order[i].unit_node != unit_node) continue;
+
+        if (initiative_order[i].unit_component) {
+            initiative_order[i].unit_component->history = nullptr;
+            initiative_order[i].unit_component->setFaction(Faction::NONE);
         }
+        initiative_order.erase(initiative_order.begin() + i);
+
+        // Removing the acting unit hands the turn to the next one at the next startNextTurn,
+        // which must not end the turn of the unit before it (that turn is already over)
+        if (i == current_turn_index) turn_owner_removed = true;
+        if (i <= current_turn_index) current_turn_index--;
+
+        rebuildStateHash();
+        state_version++;
+        return;
+    }
+}
+
+void TurnManager::rebuildStateHash() {
+    const CombatantTable* table = CombatantTable::get();
+
+    state_hash.clear();
+    for (int i = 0; i < (int)initiative_order.size(); i++) {
+        const InitiativeEntry& entry = initiative_order[i];
+        if (!entry.unit_component || entry.unit_component->table_row < 0) continue;
+
+        const int row = entry.unit_component->table_row;
+        const int node_id = table->node_id[row];
+        state_hash.toggleUnitPosition(node_id, CombatHistory::packPosition(table->position[row]));
+        state_hash.toggleUnitHP(node_id, table->current_hp[row]);
+        state_hash.toggleInitiative(i, node_id, entry.initiative_value);
     }
 }
 
 void TurnManager::startNextTurn() {
     if (!combat_active) return;
 
-    // End previous turn if there was one
-    if (current_turn_index >= 0) {
+    // End previous turn if there was one (and it is still in the order)
+    if (current_turn_index >= 0 && !turn_owner_removed) {
         endCurrentTurn();
     }
+    turn_owner_removed = false;
 
     // Advance to next unit
     current_turn_index++;
 
     // Check if we need to advance round
-    if (current_turn_index >= initiative_order.size()) {
+    if (current_turn_index >= (int)initiative_order.size()) {
         advanceRound();
         current_turn_index = 0;
     }
@@ -139,6 +266,13 @@ void TurnManager::startNextTurn() {
     actions_remaining = 3;
     attacks_this_turn = 0;
     used_agile_weapon = false;
+    state_version++;
+
+    // New turn: previous turn is committed and can no longer be undone
+    if (history) history->beginTurn();
+
+    if (replay) replay->checkpoint(current_round, current_turn_index,
+        state_hash.getTurnValue(current_round, current_turn_index));
 
     UnitComponent* current_unit = getCurrentUnit();
     if (current_unit) {
@@ -151,7 +285,7 @@ void TurnManager::startNextTurn() {
             isPlayerTurn() ? "PLAYER" : "ENEMY");
         Unigine::Log::message("Actions: %d | Reaction: %s\n",
             actions_remaining,
-            current_unit->has_reaction.get() ? "Yes" : "No");
+            current_unit->hasReaction() ? "Yes" : "No");
     }
 }
 
@@ -181,10 +315,13 @@ void TurnManager::spendActions(int action_cost, ActionType type) {
         return;
     }
 
+    if (history) history->record(DeltaType::TURN_ACTIONS, 0, actions_remaining, actions_remaining - action_cost);
     actions_remaining -= action_cost;
+    state_version++;
 
     // Track attacks for MAP calculation
     if (type == ActionType::STRIKE || type == ActionType::SPELL_ATTACK) {
+        if (history) history->record(DeltaType::TURN_ATTACKS, 0, attacks_this_turn, attacks_this_turn + 1);
         attacks_this_turn++;
         Unigine::Log::message("Attack #%d this turn (MAP: %d)\n", attacks_this_turn, getCurrentMAP());
     }
@@ -193,49 +330,47 @@ void TurnManager::spendActions(int action_cost, ActionType type) {
 }
 
 int TurnManager::getCurrentMAP() const {
-    // No penalty on first attack
-    if (attacks_this_turn == 0) return 0;
-
-    // Agile weapons: -4/-8
-    if (used_agile_weapon) {
-        if (attacks_this_turn == 1) return -4;
-        return -8;
-    }
+    return CombatRules::getMultipleAttackPenalty(attacks_this_turn, used_agile_weapon);
+}
 
-    // Standard weapons: -5/-10
-    if (attacks_this_turn == 1) return -5;
-    return -10;
+void TurnManager::restoreActionState(int actions, int attacks, bool agile) {
+    actions_remaining = actions;
+    attacks_this_turn = attacks;
+    used_agile_weapon = agile;
+    state_version++;
 }
 
 bool TurnManager::hasReaction() const {
     UnitComponent* current_unit = getCurrentUnit();
-    return current_unit ? current_unit->has_reaction.get() : false;
+    return current_unit ? current_unit->hasReaction() : false;
 }
 
 void TurnManager::spendReaction() {
     UnitComponent* current_unit = getCurrentUnit();
-    if (current_unit && current_unit->has_reaction.get()) {
-        current_unit->has_reaction = false;
+    if (current_unit && current_unit->hasReaction()) {
+        if (history) history->record(DeltaType::UNIT_REACTION, getCurrentUnitNode()->getID(), 1, 0);
+        current_unit->setReaction(false);
+        state_version++;
         Unigine::Log::message("Reaction spent\n");
     }
 }
 
 UnitComponent* TurnManager::getCurrentUnit() const {
-    if (current_turn_index < 0 || current_turn_index >= initiative_order.size()) {
+    if (current_turn_index < 0 || current_turn_index >= (int)initiative_order.size()) {
         return nullptr;
     }
     return initiative_order[current_turn_index].unit_component;
 }
 
 Unigine::NodePtr TurnManager::getCurrentUnitNode() const {
-    if (current_turn_index < 0 || current_turn_index >= initiative_order.size()) {
+    if (current_turn_index < 0 || current_turn_index >= (int)initiative_order.size()) {
         return nullptr;
     }
     return initiative_order[current_turn_index].unit_node;
 }
 
 bool TurnManager::isPlayerTurn() const {
-    if (current_turn_index < 0 || current_turn_index >= initiative_order.size()) {
+    if (current_turn_index < 0 || current_turn_index >= (int)initiative_order.size()) {
         return false;
     }
     return initiative_order[current_turn_index].is_player_unit;
@@ -253,21 +388,17 @@ void TurnManager::insertDelayedUnit(int new_initiative_index) {
     Unigine::Log::message("TurnManager::insertDelayedUnit() - Not yet implemented\n");
 }
 
-int TurnManager::rollInitiativeForUnit(UnitComponent* unit) const {
+int TurnManager::rollInitiativeForUnit(UnitComponent* unit) {
     // Initiative = 1d20 + Perception modifier
-    // For now, use Wisdom modifier as Perception (PF2e default)
-    int perception_mod = unit->getWisdomMod();
+    // Perception comes from the unit's stat block (defaults to the Wisdom modifier)
+    int perception_mod = unit->getStats().perception;
 
-    // Use C++11 random for better quality RNG
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> d20(1, 20);
+    // Seeded combat RNG so the encounter replays exactly
+    int d20_roll = 0;
+    int initiative = CombatRules::rollInitiative(rng, perception_mod, &d20_roll);
 
-    int d20_roll = d20(gen);  // 1d20
-    int initiative = d20_roll + perception_mod;
-
-    // Store initiative in unit component
-    unit->initiative = initiative;
+    // Store initiative with the unit
+    unit->setInitiative(initiative);
 
     Unigine::Log::message("  %s: rolled %d + %d (Perception) = %d\n",
         unit->unit_name.get(), d20_roll, perception_mod, initiative);
@@ -287,12 +418,18 @@ void TurnManager::applyEndOfTurnEffects(UnitComponent* unit) {
 }
 
 void TurnManager::resetTurnState(UnitComponent* unit) {
+    CombatantTable* table = CombatantTable::get();
+    const int row = unit->table_row;
+    if (row < 0) return;
+
     // Reset action economy
-    unit->actions_remaining = 3;
+    table->actions_remaining[row] = 3;
 
     // Refresh reaction (1 per round, refreshes at start of turn)
-    unit->has_reaction = true;
+    table->has_reaction[row] = 1;
 
     // Reset MAP tracking (will be tracked by TurnManager during turn)
-    unit->current_map = 0;
+    table->current_map[row] = 0;
+
+    table->markDirty(row);
 }
@@ -7,8 +7,13 @@
 #include <UnigineVector.h>
 #include <UniginePtr.h>
 #include <UnigineNode.h>
+#include "CombatRandom.h"
+#include "StateHash.h"
+#include "Arena.h"
 
 class UnitComponent;
+class CombatHistory;
+class ReplayRecorder;
 
 // Represents a unit in the initiative order
 struct InitiativeEntry {
@@ -45,12 +50,20 @@ public:
     void endCombat();
     bool isCombatActive() const { return combat_active; }
 
+    // Resume a saved combat with an already-sorted initiative order (no rolls, no turn start)
+    void restoreCombat(const Unigine::Vector<InitiativeEntry>& order, int round, int turn_index);
+
     // Initiative & turn order
     void rollInitiative(const Unigine::Vector<Unigine::NodePtr>& player_units,
                         const Unigine::Vector<Unigine::NodePtr>& enemy_units);
     void sortInitiativeOrder();
 
-    // Turn progression
+    // Units joining or leaving a combat in progress (reinforcements, pooled despawns).
+    // A joining unit rolls initiative and is slotted in without disturbing the current turn.
+    void addUnit(const Unigine::NodePtr& unit_node, bool is_player_unit);
+    void removeUnit(const Unigine::NodePtr& unit_node);
+
+    // Turn progression (after removeUnit of the acting unit, the removed unit's turn is not ended again)
     void startNextTurn();
     void endCurrentTurn();
     void advanceRound();
@@ -60,6 +73,11 @@ public:
     void spendActions(int action_cost, ActionType type = ActionType::NONE);
     int getActionsRemaining() const { return actions_remaining; }
     int getCurrentMAP() const;
+    int getAttacksThisTurn() const { return attacks_this_turn; }
+    bool usedAgileWeapon() const { return used_agile_weapon; }
+
+    // Restore action economy directly (undo/redo, save games) - not recorded
+    void restoreActionState(int actions, int attacks, bool agile);
 
     // Reactions (1 per round, refreshes at turn start)
     bool hasReaction() const;
@@ -72,8 +90,24 @@ public:
     int getCurrentRound() const { return current_round; }
     bool isPlayerTurn() const;
 
+    // State version: bumped whenever turn, action or reaction state changes
+    unsigned int getStateVersion() const { return state_version; }
+
+    // Optional undo recorder (nullptr = not recording). Cleared at every turn start.
+    void setHistory(CombatHistory* recorder) { history = recorder; }
+
+    // Seeded RNG for every combat roll (initiative, strikes). Seed before startCombat.
+    void setSeed(unsigned long long seed) { rng.setSeed(seed); }
+    CombatRandom& getRandom() { return rng; }
+
+    // Incremental hash of positions, HP and initiative (kept current by CombatHistory::record)
+    StateHash& getStateHash() { return state_hash; }
+
+    // Optional replay capture: the state hash is checkpointed at every startNextTurn
+    void setReplayRecorder(ReplayRecorder* recorder) { replay = recorder; }
+
     // Initiative order queries
-    int getInitiativeCount() const { return initiative_order.size(); }
+    int getInitiativeCount() const { return (int)initiative_order.size(); }
     const InitiativeEntry& getInitiativeEntry(int index) const { return initiative_order[index]; }
 
     // Delay action (free action, changes initiative)
@@ -84,14 +118,28 @@ private:
     bool combat_active;
     int current_round;
     int current_turn_index;     // Index into initiative_order
+    bool turn_owner_removed;    // The acting unit left mid-turn: the next start ends no turn
     int actions_remaining;      // 3 actions per turn
     int attacks_this_turn;      // For MAP calculation
     bool used_agile_weapon;     // Agile weapons have reduced MAP (-4/-8 instead of -5/-10)
+    unsigned int state_version;
+    CombatHistory* history;
+    CombatRandom rng;
+    StateHash state_hash;
+    ReplayRecorder* replay;
 
-    Unigine::Vector<InitiativeEntry> initiative_order;  // Sorted highest to lowest
+    // Encounter-lifetime data (initiative order) lives in one arena, released at combat boundaries
+    Arena encounter_arena;
+    ArenaVector<InitiativeEntry> initiative_order;      // Sorted highest to lowest
+
+    // Helper: Empty the order and reset the encounter arena, reserving room for 'capacity' units
+    void resetInitiativeOrder(int capacity);
 
     // Helper: Get initiative value for a unit (Perception + 1d20)
-    int rollInitiativeForUnit(UnitComponent* unit) const;
+    int rollInitiativeForUnit(UnitComponent* unit);
+
+    // Helper: Recompute state_hash from the initiative order
+    void rebuildStateHash();
 
     // Helper: Apply end-of-turn effects (decrement conditions, etc.)
     void applyEndOfTurnEffects(UnitComponent* unit);
@@ -0,0 +1,236 @@
+// UnitPool.cpp
+#include "UnitPool.h"
+#include "CombatantTable.h"
+#include "../Grid/GridSystem.h"
+#include "../UI/GridRenderer.h"
+#include "../Components/UnitComponent.h"
+#include "../Data/UnitDatabase.h"
+#include "PerfMonitor.h"
+#include <UnigineObjects.h>
+#include <UnigineNodes.h>
+#include <UnigineWorld.h>
+#include <UnigineComponentSystem.h>
+#include <UnigineLog.h>
+
+using namespace Unigine;
+using namespace Unigine::Math;
+
+namespace {
+    const char* UNIT_MESH = "DummyUnits/capsule.mesh";
+    const char* UNIT_MATERIAL = "DummyUnits/capsule_mesh_base_0.mat";
+
+    // Idle units wait below the map
+    const dvec3 PARKING_POSITION(0.0, 0.0, -1000.0);
+
+    // Capsule pivot is at its centre: stand it on the cell
+    const double UNIT_HEIGHT_OFFSET = 1.0;
+}
+
+UnitPool::UnitPool(GridSystem* grid_system, GridRenderer* renderer)
+    : grid(grid_system)
+    , grid_renderer(renderer)
+    , spawn_counter(0)
+{
+    pool_root = NodeDummy::create();
+    pool_root->setName("UnitPool");
+
+    Vector<NodePtr> root_nodes;
+    World::getRootNodes(root_nodes);
+    if (root_nodes.size() > 0) {
+        root_nodes[0]->addChild(pool_root);
+    }
+}
+
+UnitPool::~UnitPool() {
+    // Deleting the root deletes every pooled node (and their components)
+    if (pool_root) {
+        pool_root.deleteLater();
+        pool_root.clear();
+    }
+}
+
+void UnitPool::reserve(const char* stat_block, int count) {
+    const int block = UnitDatabase::get()->findBlock(stat_block);
+    if (block == UnitDatabase::INVALID_ID) {
+        Log::warning("UnitPool::reserve() - Unknown stat block '%s'\n", stat_block);
+        return;
+    }
+
+    int index = findArchetype(block);
+    if (index < 0) {
+        Archetype archetype;
+        archetype.stat_block = block;
+        archetypes.append(archetype);
+        index = archetypes.size() - 1;
+    }
+    Archetype& archetype = archetypes[index];
+    archetype.idle.reserve(archetype.all.size() + count);
+    archetype.all.reserve(archetype.all.size() + count);
+
+    for (int i = 0; i < count; i++) {
+        ObjectMeshStaticPtr mesh = ObjectMeshStatic::create(UNIT_MESH);
+        mesh->setMaterialPath(UNIT_MATERIAL, "*");
+        mesh->setName(String::format("Pool_%s_%d", stat_block, archetype.all.size()).get());
+        mesh->setWorldPosition(PARKING_POSITION);
+        pool_root->addChild(mesh);
+        PerfMonitor::get()->count(PerfCounter::NODES_CREATED);
+
+        // Node stays enabled so the component initializes now; surfaces are hidden instead
+        UnitComponent* unit = ComponentSystem::get()->addComponent<UnitComponent>(mesh);
+        unit->stat_block = stat_block;
+        unit->unit_name = UnitDatabase::get()->getBlock(block).name;
+        unit->pooled = true;
+        setVisible(unit, false);
+
+        archetype.idle.append(unit);
+        archetype.all.append(unit);
+    }
+
+    Log::message("UnitPool::reserve() - %d x '%s' (%d pooled)\n", count, stat_block, archetype.all.size());
+}
+
+void UnitPool::reserveFromDatabase() {
+    UnitDatabase* database = UnitDatabase::get();
+    for (int i = 0; i < database->getNumBlocks(); i++) {
+        const StatBlock& block = database->getBlock(i);
+        if (block.pool_size > 0) {
+            reserve(block.id, block.pool_size);
+        }
+    }
+}
+
+UnitComponent* UnitPool::acquire(const char* stat_block, GridPosition at, bool is_player_unit, bool joins_combat) {
+    const int index = findArchetype(UnitDatabase::get()->findBlock(stat_block));
+    if (index < 0) {
+        Log::warning("UnitPool::acquire() - No pool for '%s'\n", stat_block);
+        return nullptr;
+    }
+    if (!grid->isValidPosition(at) || grid->getCell(at.x, at.y)->isOccupied()) {
+        Log::warning("UnitPool::acquire() - Cell (%d, %d) is not free\n", at.x, at.y);
+        return nullptr;
+    }
+
+    // Take the most recently returned unit whose component has initialized
+    Archetype& archetype = archetypes[index];
+    UnitComponent* unit = nullptr;
+    for (int i = archetype.idle.size() - 1; i >= 0; i--) {
+        if (archetype.idle[i]->table_row >= 0) {
+            unit = archetype.idle[i];
+            archetype.idle.removeFast(i);
+            break;
+        }
+    }
+    if (!unit) {
+        Log::warning("UnitPool::acquire() - Pool for '%s' is empty\n", stat_block);
+        return nullptr;
+    }
+
+    CombatantTable::get()->resetState(unit->table_row);
+    unit->pooled = false;
+    unit->setGridPosition(at);
+    if (joins_combat) unit->setFaction(is_player_unit ? Faction::PLAYER : Faction::ENEMY);
+
+    NodePtr node = unit->getNode();
+    node->setName(String::format("%s_%s_%d", is_player_unit ? "Player" : "Enemy",
+        UnitDatabase::get()->getBlock(archetype.stat_block).id, ++spawn_counter).get());
+
+    placeNode(unit, at);
+    grid->setOccupant(at, node);
+    setVisible(unit, true);
+
+    return unit;
+}
+
+bool UnitPool::claim(UnitComponent* unit, GridPosition at) {
+    if (!unit || !unit->pooled || unit->table_row < 0) return false;
+
+    const int index = findArchetype(CombatantTable::get()->stat_block[unit->table_row]);
+    if (index < 0) return false;
+
+    Vector<UnitComponent*>& idle = archetypes[index].idle;
+    for (int i = 0; i < idle.size(); i++) {
+        if (idle[i] != unit) continue;
+
+        idle.removeFast(i);
+        unit->pooled = false;
+        unit->setGridPosition(at);
+        placeNode(unit, at);
+        setVisible(unit, true);
+        return true;
+    }
+    return false;
+}
+
+void UnitPool::release(UnitComponent* unit) {
+    if (!unit || unit->pooled || unit->table_row < 0) return;
+
+    const int index = findArchetype(CombatantTable::get()->stat_block[unit->table_row]);
+    if (index < 0 || !owns(unit)) {
+        Log::warning("UnitPool::release() - %s does not belong to the pool\n", unit->unit_name.get());
+        return;
+    }
+
+    NodePtr node = unit->getNode();
+    GridPosition at = unit->getGridPosition();
+    if (grid->isValidPosition(at) && grid->getCell(at.x, at.y)->occupant == node) {
+        grid->clearOccupant(at);
+    }
+
+    setVisible(unit, false);
+    node->setWorldPosition(PARKING_POSITION);
+    unit->history = nullptr;
+    unit->pooled = true;
+    CombatantTable::get()->resetState(unit->table_row);
+
+    archetypes[index].idle.append(unit);
+}
+
+bool UnitPool::owns(const UnitComponent* unit) const {
+    for (int i = 0; i < archetypes.size(); i++) {
+        const Vector<UnitComponent*>& all = archetypes[i].all;
+        for (int j = 0; j < all.size(); j++) {
+            if (all[j] == unit) return true;
+        }
+    }
+    return false;
+}
+
+void UnitPool::getUnits(Vector<UnitComponent*>& units) const {
+    units.clear();
+    for (int i = 0; i < archetypes.size(); i++) {
+        units.append(archetypes[i].all);
+    }
+}
+
+int UnitPool::getAvailable(const char* stat_block) const {
+    const int index = findArchetype(UnitDatabase::get()->findBlock(stat_block));
+    return index >= 0 ? archetypes[index].idle.size() : 0;
+}
+
+int UnitPool::getTotal() const {
+    int total = 0;
+    for (int i = 0; i < archetypes.size(); i++) {
+        total += archetypes[i].all.size();
+    }
+    return total;
+}
+
+int UnitPool::findArchetype(int stat_block) const {
+    for (int i = 0; i < archetypes.size(); i++) {
+        if (archetypes[i].stat_block == stat_block) return i;
+    }
+    return -1;
+}
+
+void UnitPool::placeNode(UnitComponent* unit, GridPosition at) {
+    dvec3 position = grid_renderer->gridToWorld(at);
+    unit->getNode()->setWorldPosition(dvec3(position.x, position.y, position.z + UNIT_HEIGHT_OFFSET));
+}
+
+void UnitPool::setVisible(UnitComponent* unit, bool visible) {
+    // Surface toggles only: no enable/disable of the node, so the component stays initialized
+    ObjectPtr object = static_cast<Object*>(unit->getNode().get());
+    for (int i = 0; i < object->getNumSurfaces(); i++) {
+        object->setEnabled(visible ? 1 : 0, i);
+    }
+}
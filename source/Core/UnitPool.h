@@ -0,0 +1,67 @@
+// UnitPool.h
+// Pre-created unit nodes per stat block (archetype) for reinforcements and mass encounters
+// reserve() builds hidden ObjectMeshStatic + UnitComponent nodes up front (node creation,
+// material setup and component registration happen at load, not mid-combat). acquire()
+// shows and places an idle unit; release() hides it and returns it to the pool.
+
+#pragma once
+
+#include "../Grid/GridCell.h"
+#include <UnigineVector.h>
+#include <UnigineNode.h>
+
+class GridSystem;
+class GridRenderer;
+class UnitComponent;
+
+class UnitPool {
+public:
+    UnitPool(GridSystem* grid_system, GridRenderer* renderer);
+    ~UnitPool();
+
+    // Pre-create 'count' idle units of a stat block. Components initialize on the next
+    // engine update, so reserve at least one frame before acquiring.
+    void reserve(const char* stat_block, int count);
+
+    // Reserve StatBlock::pool_size units for every database block that asks for a pool
+    void reserveFromDatabase();
+
+    // Take an idle unit of the stat block and place it on 'at' (must be free).
+    // Returns nullptr if the pool is empty - it never creates nodes on demand.
+    // joins_combat: the unit gets its side's faction before it is placed, so an aura it lands
+    // in (Bless) already sees it as an ally or enemy; TurnManager::addUnit follows.
+    UnitComponent* acquire(const char* stat_block, GridPosition at, bool is_player_unit, bool joins_combat);
+
+    // Hide the unit, free its cell and make it available again
+    void release(UnitComponent* unit);
+
+    // Take a specific idle unit back out of the pool and show it on 'at'. For restoring a save
+    // that holds a unit released since: the grid's occupants are restored separately.
+    bool claim(UnitComponent* unit, GridPosition at);
+
+    // Created by this pool (scene-placed units are not, even with a pooled stat block)
+    bool owns(const UnitComponent* unit) const;
+
+    // Every unit of the pool, idle or not
+    void getUnits(Unigine::Vector<UnitComponent*>& units) const;
+
+    int getAvailable(const char* stat_block) const;
+    int getTotal() const;
+
+private:
+    struct Archetype {
+        int stat_block;                         // UnitDatabase block ID
+        Unigine::Vector<UnitComponent*> idle;
+        Unigine::Vector<UnitComponent*> all;
+    };
+
+    GridSystem* grid;
+    GridRenderer* grid_renderer;
+    Unigine::NodePtr pool_root;
+    Unigine::Vector<Archetype> archetypes;
+    int spawn_counter;
+
+    int findArchetype(int stat_block) const;
+    void placeNode(UnitComponent* unit, GridPosition at);
+    void setVisible(UnitComponent* unit, bool visible);
+};
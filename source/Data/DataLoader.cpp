@@ -0,0 +1,37 @@
+// DataLoader.cpp
+#include "DataLoader.h"
+#include <UnigineLog.h>
+
+using namespace Unigine;
+
+JsonPtr DataLoader::loadJson(const char* path) {
+    JsonPtr json = Json::create();
+    if (!json->load(path)) {
+        Log::error("DataLoader::loadJson() - Cannot load '%s'\n", path);
+        return nullptr;
+    }
+    return json;
+}
+
+JsonPtr DataLoader::getChild(const JsonPtr& json, const char* name) {
+    if (!json || !json->isChild(name)) return nullptr;
+    return json->getChild(name);
+}
+
+int DataLoader::readInt(const JsonPtr& json, const char* name, int default_value) {
+    JsonPtr child = getChild(json, name);
+    if (!child || !child->isNumber()) return default_value;
+    return (int)child->getNumber();
+}
+
+const char* DataLoader::readString(const JsonPtr& json, const char* name, const char* default_value) {
+    JsonPtr child = getChild(json, name);
+    if (!child || !child->isString()) return default_value;
+    return child->getString();
+}
+
+bool DataLoader::readBool(const JsonPtr& json, const char* name, bool default_value) {
+    JsonPtr child = getChild(json, name);
+    if (!child || !child->isBool()) return default_value;
+    return child->getBool() != 0;
+}
@@ -0,0 +1,19 @@
+// DataLoader.h
+// Helpers for reading game data files (JSON under data/)
+// Missing fields fall back to defaults so data files only list what differs.
+
+#pragma once
+
+#include <UnigineJson.h>
+
+namespace DataLoader {
+    // Load a JSON file (path relative to data/). Returns nullptr and logs on failure.
+    Unigine::JsonPtr loadJson(const char* path);
+
+    int readInt(const Unigine::JsonPtr& json, const char* name, int default_value);
+    const char* readString(const Unigine::JsonPtr& json, const char* name, const char* default_value);
+    bool readBool(const Unigine::JsonPtr& json, const char* name, bool default_value);
+
+    // Child object/array, or nullptr if absent
+    Unigine::JsonPtr getChild(const Unigine::JsonPtr& json, const char* name);
+}
@@ -0,0 +1,49 @@
+// StringPool.cpp
+#include "StringPool.h"
+#include <cstring>
+
+StringPool::StringPool()
+    : page_used(PAGE_SIZE)
+{
+}
+
+StringPool::~StringPool() {
+    for (int i = 0; i < pages.size(); i++) {
+        delete[] pages[i];
+    }
+}
+
+const char* StringPool::find(const char* text) const {
+    // Linear scan: pools hold at most a few hundred names and are only queried at load/spawn time
+    for (int i = 0; i < strings.size(); i++) {
+        if (strcmp(strings[i], text) == 0) return strings[i];
+    }
+    return nullptr;
+}
+
+const char* StringPool::intern(const char* text) {
+    if (!text) text = "";
+
+    const char* existing = find(text);
+    if (existing) return existing;
+
+    const int length = (int)strlen(text) + 1;
+    char* copy = nullptr;
+    if (length > PAGE_SIZE) {
+        // Oversized string: give it its own page (and start a fresh page for the next one)
+        copy = new char[length];
+        pages.append(copy);
+        page_used = PAGE_SIZE;
+    } else {
+        if (page_used + length > PAGE_SIZE) {
+            pages.append(new char[PAGE_SIZE]);
+            page_used = 0;
+        }
+        copy = pages.last() + page_used;
+        page_used += length;
+    }
+
+    memcpy(copy, text, length);
+    strings.append(copy);
+    return copy;
+}
@@ -0,0 +1,33 @@
+// StringPool.h
+// Interned, immutable strings for data tables (stat block IDs, names, spell names)
+// Each distinct string is stored once in append-only pages, so the returned pointers stay
+// valid for the pool's lifetime and can be compared by address.
+
+#pragma once
+
+#include <UnigineVector.h>
+
+class StringPool {
+public:
+    StringPool();
+    ~StringPool();
+
+    // Pointer to the pooled copy of 'text' (same pointer for equal strings)
+    const char* intern(const char* text);
+
+    // Pooled copy if 'text' was interned before, else nullptr (no allocation)
+    const char* find(const char* text) const;
+
+    int getCount() const { return strings.size(); }
+    int getBytes() const { return pages.size() * PAGE_SIZE; }
+
+private:
+    static const int PAGE_SIZE = 4096;
+
+    Unigine::Vector<char*> pages;
+    int page_used;
+    Unigine::Vector<const char*> strings;
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+};
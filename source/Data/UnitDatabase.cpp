@@ -0,0 +1,174 @@
+// UnitDatabase.cpp
+#include "UnitDatabase.h"
+#include "DataLoader.h"
+#include "../Components/UnitComponent.h"
+#include <UnigineLog.h>
+#include <cstring>
+
+using namespace Unigine;
+
+StatBlock::StatBlock()
+    : id("")
+    , name("")
+    , level(1)
+    , strength(10)
+    , dexterity(10)
+    , constitution(10)
+    , intelligence(10)
+    , wisdom(10)
+    , charisma(10)
+    , max_hp(10)
+    , armor_class(10)
+    , speed(25)
+    , fortitude(0)
+    , reflex(0)
+    , will(0)
+    , perception(0)
+    , attack_bonus(0)
+    , spell_attack(0)
+    , spell_dc(10)
+    , pool_size(0)
+{
+}
+
+int StatBlock::getDefaultSpellAttack() const {
+    int best = intelligence > wisdom ? intelligence : wisdom;
+    if (charisma > best) best = charisma;
+    return level + 2 + (best - 10) / 2;
+}
+
+bool StatBlock::hasSameStats(const StatBlock& other) const {
+    // Names are interned: pointer comparison is enough
+    return name == other.name && level == other.level
+        && strength == other.strength && dexterity == other.dexterity
+        && constitution == other.constitution && intelligence == other.intelligence
+        && wisdom == other.wisdom && charisma == other.charisma
+        && max_hp == other.max_hp && armor_class == other.armor_class && speed == other.speed
+        && fortitude == other.fortitude && reflex == other.reflex && will == other.will
+        && perception == other.perception && attack_bonus == other.attack_bonus
+        && spell_attack == other.spell_attack && spell_dc == other.spell_dc
+        && damage.count == other.damage.count && damage.sides == other.damage.sides
+        && damage.bonus == other.damage.bonus;
+}
+
+UnitDatabase* UnitDatabase::get() {
+    static UnitDatabase database;
+    return &database;
+}
+
+bool UnitDatabase::load(const char* path) {
+    JsonPtr json = DataLoader::loadJson(path);
+    JsonPtr units = DataLoader::getChild(json, "units");
+    if (!units || !units->isArray()) {
+        Log::error("UnitDatabase::load() - '%s' has no \"units\" array\n", path);
+        return false;
+    }
+
+    int loaded = 0;
+    for (int i = 0; i < units->getNumChildren(); i++) {
+        JsonPtr entry = units->getChild(i);
+
+        const char* id = DataLoader::readString(entry, "id", "");
+        if (id[0] == '\0') {
+            Log::warning("UnitDatabase::load() - Unit #%d in '%s' has no id, skipped\n", i, path);
+            continue;
+        }
+        if (findBlock(id) != INVALID_ID) {
+            Log::warning("UnitDatabase::load() - Duplicate unit id '%s' in '%s', skipped\n", id, path);
+            continue;
+        }
+
+        StatBlock block;
+        block.id = strings.intern(id);
+        block.name = strings.intern(DataLoader::readString(entry, "name", id));
+        block.level = DataLoader::readInt(entry, "level", block.level);
+
+        JsonPtr stats = DataLoader::getChild(entry, "stats");
+        block.strength = DataLoader::readInt(stats, "str", block.strength);
+        block.dexterity = DataLoader::readInt(stats, "dex", block.dexterity);
+        block.constitution = DataLoader::readInt(stats, "con", block.constitution);
+        block.intelligence = DataLoader::readInt(stats, "int", block.intelligence);
+        block.wisdom = DataLoader::readInt(stats, "wis", block.wisdom);
+        block.charisma = DataLoader::readInt(stats, "cha", block.charisma);
+
+        block.max_hp = DataLoader::readInt(entry, "hp_max", block.max_hp);
+        block.armor_class = DataLoader::readInt(entry, "ac", block.armor_class);
+        block.speed = DataLoader::readInt(entry, "speed", block.speed);
+
+        JsonPtr saves = DataLoader::getChild(entry, "saves");
+        block.fortitude = DataLoader::readInt(saves, "fort", block.fortitude);
+        block.reflex = DataLoader::readInt(saves, "reflex", block.reflex);
+        block.will = DataLoader::readInt(saves, "will", block.will);
+
+        // Perception defaults to the Wisdom modifier (same rule as UnitComponent)
+        block.perception = DataLoader::readInt(entry, "perception", block.getWisdomMod());
+        block.attack_bonus = DataLoader::readInt(entry, "attack_bonus", block.attack_bonus);
+
+        const char* damage = DataLoader::readString(entry, "weapon_damage", "1d6");
+        if (!DiceExpr::parse(damage, block.damage)) {
+            Log::warning("UnitDatabase::load() - Bad weapon_damage '%s' on '%s'\n", damage, id);
+        }
+
+        block.spell_attack = DataLoader::readInt(entry, "spell_attack", block.getDefaultSpellAttack());
+        block.spell_dc = DataLoader::readInt(entry, "spell_dc", 10 + block.spell_attack);
+
+        block.pool_size = DataLoader::readInt(entry, "pool_size", 0);
+
+        blocks.append(block);
+        loaded++;
+    }
+
+    Log::message("UnitDatabase::load() - %d stat blocks from '%s' (%d total, %d pooled strings)\n",
+        loaded, path, blocks.size(), strings.getCount());
+    return true;
+}
+
+int UnitDatabase::findBlock(const char* id) const {
+    // Interned IDs: if the string was never interned, no block can match
+    const char* interned = strings.find(id);
+    if (!interned) return INVALID_ID;
+
+    for (int i = 0; i < blocks.size(); i++) {
+        if (blocks[i].id == interned) return i;
+    }
+    return INVALID_ID;
+}
+
+int UnitDatabase::registerFromProperties(UnitComponent* unit) {
+    StatBlock block;
+    block.name = strings.intern(unit->unit_name.get());
+    block.level = unit->level;
+    block.strength = unit->strength;
+    block.dexterity = unit->dexterity;
+    block.constitution = unit->constitution;
+    block.intelligence = unit->intelligence;
+    block.wisdom = unit->wisdom;
+    block.charisma = unit->charisma;
+    block.max_hp = unit->max_hp;
+    block.armor_class = unit->armor_class;
+    block.speed = unit->speed;
+    block.fortitude = unit->fortitude_save;
+    block.reflex = unit->reflex_save;
+    block.will = unit->will_save;
+    block.perception = block.getWisdomMod();
+    block.attack_bonus = unit->attack_bonus;
+    block.spell_attack = block.getDefaultSpellAttack();
+    block.spell_dc = 10 + block.spell_attack;
+
+    if (!DiceExpr::parse(unit->weapon_damage.get(), block.damage)) {
+        Log::warning("UnitDatabase::registerFromProperties() - Bad weapon damage '%s' on %s\n",
+            unit->weapon_damage.get(), unit->unit_name.get());
+    }
+
+    return addBlock(block);
+}
+
+int UnitDatabase::addBlock(const StatBlock& block) {
+    // Share anonymous blocks with identical numbers
+    for (int i = 0; i < blocks.size(); i++) {
+        if (blocks[i].id[0] == '\0' && blocks[i].hasSameStats(block)) return i;
+    }
+
+    blocks.append(block);
+    return blocks.size() - 1;
+}
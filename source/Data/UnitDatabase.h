@@ -0,0 +1,87 @@
+// UnitDatabase.h
+// Shared, immutable stat blocks (flyweights) loaded once from data/units/*.json
+// Unit instances keep only a stat block ID plus their mutable state (CombatantTable row),
+// so 500 goblins share one StatBlock. Strings are interned and weapon dice pre-parsed.
+
+#pragma once
+
+#include "StringPool.h"
+#include "../Core/Dice.h"
+#include <UnigineVector.h>
+
+class UnitComponent;
+
+struct StatBlock {
+    const char* id;             // Interned ("goblin_warrior"); "" for anonymous blocks
+    const char* name;           // Interned display name
+    int level;
+
+    // Ability scores
+    int strength;
+    int dexterity;
+    int constitution;
+    int intelligence;
+    int wisdom;
+    int charisma;
+
+    int max_hp;
+    int armor_class;
+    int speed;                  // Feet
+    int fortitude;
+    int reflex;
+    int will;
+    int perception;             // Initiative modifier
+    int attack_bonus;
+    DiceExpr damage;            // Pre-parsed weapon damage
+    int spell_attack;           // Spell attack modifier
+    int spell_dc;               // Spell save DC
+
+    int pool_size;              // Hidden instances UnitPool pre-creates (0 = none)
+
+    StatBlock();
+
+    // Ability modifiers (PF2e: (score - 10) / 2)
+    int getStrengthMod() const { return (strength - 10) / 2; }
+    int getDexterityMod() const { return (dexterity - 10) / 2; }
+    int getConstitutionMod() const { return (constitution - 10) / 2; }
+    int getIntelligenceMod() const { return (intelligence - 10) / 2; }
+    int getWisdomMod() const { return (wisdom - 10) / 2; }
+    int getCharismaMod() const { return (charisma - 10) / 2; }
+
+    // Trained spellcaster default: level + 2 + best mental modifier
+    int getDefaultSpellAttack() const;
+
+    // Same numbers (used to share anonymous blocks between identical hand-placed units)
+    bool hasSameStats(const StatBlock& other) const;
+};
+
+class UnitDatabase {
+public:
+    static const int INVALID_ID = -1;
+
+    // Process-wide catalog (filled in AppSystemLogic::init, before any world loads)
+    static UnitDatabase* get();
+
+    // Append every block of a units file ({"units": [...]}, GDD schema). Returns false on error.
+    bool load(const char* path);
+
+    // Look up a named block (load/spawn time only)
+    int findBlock(const char* id) const;
+
+    // Block for a unit's own PROP_PARAM stats (hand-placed units without a stat_block).
+    // Identical stat lines share one anonymous block.
+    int registerFromProperties(UnitComponent* unit);
+
+    const StatBlock& getBlock(int id) const { return blocks[id]; }
+    int getNumBlocks() const { return blocks.size(); }
+
+    const char* intern(const char* text) { return strings.intern(text); }
+
+private:
+    UnitDatabase() {}
+
+    Unigine::Vector<StatBlock> blocks;
+    StringPool strings;
+
+    int addBlock(const StatBlock& block);
+};
@@ -7,12 +7,53 @@
 
 // System includes
 #include "Grid/GridSystem.h"
+#include "Grid/FogOfWar.h"
 #include "Core/TurnManager.h"
 #include "UI/GridRenderer.h"
 #include "Components/GridConfigComponent.h"
 #include "Input/SelectionSystem.h"
+#include "Input/GridPicker.h"
+#include "UI/HoverPreview.h"
+#include "Components/UnitComponent.h"
+#include "Core/JobSystem.h"
+#include "AI/AIJobQueue.h"
+#include "AI/CombatSnapshot.h"
+#include "Core/CombatHistory.h"
+#include "Core/CombatSerializer.h"
+#include "Core/CombatCommand.h"
+#include "Core/CombatRules.h"
+#include "Core/Replay.h"
+#include "Core/Lockstep.h"
+#include "Core/CombatantTable.h"
+#include "Core/UnitPool.h"
+#include "Core/SceneCommandBuffer.h"
+#include "Core/LoadPipeline.h"
+#include "Core/Arena.h"
+#include "Core/PerfMonitor.h"
+#include "Data/UnitDatabase.h"
+#include "Spells/SpellSystem.h"
+#include <UnigineInput.h>
+#include <UnigineGame.h>
+#include <UnigineConsole.h>
+#include <UnigineStreams.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 // #include "Combat/CombatResolver.h"
-// #include "Spells/SpellSystem.h"
+
+namespace {
+    // Main-thread time world setup may take per frame, and how finely its stages are cut
+    const double LOAD_BUDGET_MS = 4.0;
+    const int LOAD_CELLS_PER_STEP = 64;
+    const int LOAD_UNITS_PER_STEP = 2;
+
+    // Sight radius of every unit (cells)
+    const int FOG_SIGHT_CELLS = 12;
+
+    // lockstep_test defaults
+    const int LOCKSTEP_TEST_PORT = 47800;
+    const int LOCKSTEP_TEST_TURNS = 40;
+}
 
 GameManager::GameManager()
     : grid(nullptr)
@@ -21,7 +62,25 @@ GameManager::GameManager()
     , spells(nullptr)
     , grid_renderer(nullptr)
     , selection(nullptr)
+    , jobs(nullptr)
+    , ai_jobs(nullptr)
+    , scene_commands(nullptr)
+    , history(nullptr)
+    , replay(nullptr)
+    , unit_pool(nullptr)
+    , picker(nullptr)
+    , hover_preview(nullptr)
+    , fog(nullptr)
     , in_combat(false)
+    , loader(nullptr)
+    , grid_config(nullptr)
+    , loading_grid(nullptr)
+    , load_pool_block(0)
+    , load_pool_reserved(0)
+    , hover_current(nullptr)
+    , hover_unit_id(0)
+    , hover_version(0)
+    , hover_valid(false)
 {
 }
 
@@ -40,7 +99,7 @@ void GameManager::init() {
     }
 
     // Get the GridConfigComponent
-    GridConfigComponent* grid_config = Unigine::ComponentSystem::get()->getComponent<GridConfigComponent>(config_node);
+    grid_config = Unigine::ComponentSystem::get()->getComponent<GridConfigComponent>(config_node);
     if (!grid_config) {
         Unigine::Log::error("GameManager::init() - GridConfigComponent not found on GridConfig node!\n");
         return;
@@ -49,45 +108,234 @@ void GameManager::init() {
     Unigine::Log::message("GameManager::init() - Found GridConfig: %dx%d grid, %.2fm cells\n",
         grid_config->grid_width, grid_config->grid_height, grid_config->cell_size);
 
-    // Create grid system with dimensions from config
-    grid = new GridSystem(grid_config->grid_width, grid_config->grid_height);
+    // Worker pool shared by every system that runs work off the main thread
+    jobs = new JobSystem();
+    Unigine::Console::addCommand("job_timings", "Print per-system job timings ('job_timings reset' clears them)",
+        Unigine::MakeCallback(this, &GameManager::consoleJobTimings));
+    Unigine::Console::addCommand("memory_stats", "Print heap vs arena allocations per subsystem ('memory_stats reset' clears them)",
+        Unigine::MakeCallback(this, &GameManager::consoleMemoryStats));
+
+    // Scene changes requested by game logic wait here until postUpdate
+    scene_commands = new SceneCommandBuffer();
+
+    // Everything that scales with the map is built over the next frames (updateLoading)
+    loader = new LoadPipeline();
+    loader->addStage("Grid", 1.0f, [this](float& progress) { return loadGrid(progress); });
+    loader->addStage("Visuals", 3.0f, [this](float& progress) { return loadVisuals(progress); });
+    loader->addStage("Units", 1.0f, [this](float& progress) { return loadUnits(progress); });
+    loader->addStage("Interaction", 0.5f, [this](float& progress) { return loadInteraction(progress); });
+
+    // Create other systems (will be implemented as we build them)
+    // combat = new CombatResolver();
+
+    Unigine::Log::message("GameManager::init() - Complete, loading the world over the next frames\n");
+}
+
+void GameManager::updateLoading() {
+    if (!loader || loader->isComplete()) return;
+
+    if (loader->update(LOAD_BUDGET_MS)) {
+        Unigine::Log::message("GameManager::updateLoading() - Time to interactive: %.2f ms (%d frames)\n",
+            loader->getElapsedMs(), loader->getFrames());
+        loader->logTimings();
+    }
+}
+
+bool GameManager::isLoaded() const {
+    return loader && loader->isComplete();
+}
+
+float GameManager::getLoadProgress() const {
+    return loader ? loader->getProgress() : 0.0f;
+}
+
+const char* GameManager::getLoadStage() const {
+    return loader ? loader->getCurrentStage() : "";
+}
+
+LoadStep GameManager::loadGrid(float& progress) {
+    // Cell arrays are plain data: build them on a worker while frames keep rendering
+    if (!load_job) {
+        const int width = grid_config->grid_width;
+        const int height = grid_config->grid_height;
+        load_job = jobs->submit(jobs->getSystemId("Loading"), [this, width, height]() {
+            loading_grid = new GridSystem(width, height);
+        });
+        return LoadStep::WAIT;
+    }
+    if (!JobSystem::isDone(load_job)) return LoadStep::WAIT;
+    load_job.reset();
+
+    grid = loading_grid;
+    loading_grid = nullptr;
+    progress = 1.0f;
 
     // Create turn manager
     turn_manager = new TurnManager();
 
-    // Create grid renderer with config and visualize the grid
-    grid_renderer = new GridRenderer(grid, grid_config);
-    grid_renderer->createGridVisuals();
+    // Undo history records grid and turn changes as compact deltas
+    history = new CombatHistory(grid, turn_manager);
+    grid->setHistory(history);
+    turn_manager->setHistory(history);
+
+    // Replay capture (seed + commands + per-turn state hashes)
+    replay = new ReplayRecorder();
+    turn_manager->setReplayRecorder(replay);
+    Unigine::Console::addCommand("combat_replay", "Re-simulate a combat replay headlessly and report the first divergent turn",
+        Unigine::MakeCallback(this, &GameManager::consoleReplay));
+    Unigine::Console::addCommand("lockstep_test", "Play the recorded encounter in lockstep over loopback: lockstep_test [turns] [hash_interval] [desync]",
+        Unigine::MakeCallback(this, &GameManager::consoleLockstep));
+
+    // Spells are compiled from data once; casts run the compiled programs
+    spells = new SpellSystem(grid, turn_manager, history);
+    spells->load("spells/wizard_spells.json");
+    spells->load("spells/cleric_spells.json");
+    Unigine::Console::addCommand("spells", "List compiled spells and active spell effects",
+        Unigine::MakeCallback(this, &GameManager::consoleSpells));
+    Unigine::Console::addCommand("spell_cast", "Current unit casts a spell: spell_cast <id> <x> <y> [rank]",
+        Unigine::MakeCallback(this, &GameManager::consoleSpellCast));
+
+    // Fog of war: views move with setOccupant, only the moving unit's cells are recounted
+    fog = new FogOfWar(grid, FOG_SIGHT_CELLS);
+    grid->setFogOfWar(fog);
+    Unigine::Console::addCommand("fog", "Fog of war stats; 'fog player' / 'fog enemy' picks the side shown",
+        Unigine::MakeCallback(this, &GameManager::consoleFog));
+    return LoadStep::DONE;
+}
+
+LoadStep GameManager::loadVisuals(float& progress) {
+    // Create grid renderer with config; per-cell visuals are created a batch per step
+    if (!grid_renderer) {
+        grid_renderer = new GridRenderer(grid, grid_config);
+        grid_renderer->beginGridVisuals();
+    }
+
+    const bool done = grid_renderer->createGridVisualsStep(LOAD_CELLS_PER_STEP);
+    progress = grid_renderer->getVisualsProgress();
+    return done ? LoadStep::DONE : LoadStep::CONTINUE;
+}
+
+LoadStep GameManager::loadUnits(float& progress) {
+    // Pre-create pooled units (pool_size per stat block) so spawning never builds nodes mid-combat
+    UnitDatabase* database = UnitDatabase::get();
+    if (!unit_pool) {
+        unit_pool = new UnitPool(grid, grid_renderer);
+        load_pool_block = 0;
+        load_pool_reserved = 0;
+        Unigine::Console::addCommand("unit_spawn", "Place a pooled unit (joins a combat in progress): unit_spawn <block> <x> <y> [player]",
+            Unigine::MakeCallback(this, &GameManager::consoleUnitSpawn));
+        Unigine::Console::addCommand("unit_despawn", "Return the pooled unit on a cell to its pool: unit_despawn <x> <y>",
+            Unigine::MakeCallback(this, &GameManager::consoleUnitDespawn));
+    }
+
+    // A few nodes per step: each one is a mesh load plus a component
+    while (load_pool_block < database->getNumBlocks()
+           && load_pool_reserved >= database->getBlock(load_pool_block).pool_size) {
+        load_pool_block++;
+        load_pool_reserved = 0;
+    }
+    if (load_pool_block >= database->getNumBlocks()) return LoadStep::DONE;
 
-    // Create selection system
+    const StatBlock& block = database->getBlock(load_pool_block);
+    const int remaining = block.pool_size - load_pool_reserved;
+    const int count = remaining < LOAD_UNITS_PER_STEP ? remaining : LOAD_UNITS_PER_STEP;
+    unit_pool->reserve(block.id, count);
+    load_pool_reserved += count;
+
+    progress = (float)load_pool_block / database->getNumBlocks();
+    return LoadStep::CONTINUE;
+}
+
+LoadStep GameManager::loadInteraction(float& progress) {
+    // Create selection system (hover and clicks resolved analytically against the grid)
+    picker = new GridPicker(grid, grid_config);
     selection = new Unigine::SelectionSystem();
     selection->init();
+    selection->setGridPicker(picker);
+    hover_preview = new HoverPreviewCache(grid, turn_manager, spells);
 
-    // Create other systems (will be implemented as we build them)
-    // combat = new CombatResolver();
-    // spells = new SpellSystem();
+    // Enemy turn planning runs on the job workers, off the fixed-step update
+    ai_jobs = new AIJobQueue(jobs);
 
-    Unigine::Log::message("GameManager::init() - Complete\n");
+    progress = 1.0f;
+    return LoadStep::DONE;
 }
 
 void GameManager::shutdown() {
     Unigine::Log::message("GameManager::shutdown() - Cleaning up game systems...\n");
 
+    // A grid still being built on a worker must finish before anything is torn down
+    if (jobs && load_job) jobs->wait(load_job);
+    load_job.reset();
+    delete loading_grid;
+    loading_grid = nullptr;
+    delete loader;
+    loader = nullptr;
+
+    // Stop AI jobs first (jobs hold snapshots, never live systems)
+    cancelAIJobs();
+    delete ai_jobs;
+    ai_jobs = nullptr;
+
     // Delete systems in reverse order
+    delete hover_preview;
     delete selection;
+    delete picker;
+    if (unit_pool) {
+        Unigine::Console::removeCommand("unit_spawn");
+        Unigine::Console::removeCommand("unit_despawn");
+    }
+    delete unit_pool;
     delete grid_renderer;
-    // delete spells;        // Not created yet
+    if (spells) {
+        Unigine::Console::removeCommand("spells");
+        Unigine::Console::removeCommand("spell_cast");
+    }
+    delete spells;
+    if (fog) {
+        Unigine::Console::removeCommand("fog");
+        grid->setFogOfWar(nullptr);
+    }
+    delete fog;
     // delete combat;        // Not created yet
+    if (replay) {
+        Unigine::Console::removeCommand("combat_replay");
+        Unigine::Console::removeCommand("lockstep_test");
+    }
+    if (turn_manager) turn_manager->setReplayRecorder(nullptr);
+    delete replay;
+    if (turn_manager) turn_manager->setHistory(nullptr);
+    if (grid) grid->setHistory(nullptr);
+    delete history;
     delete turn_manager;
     delete grid;
 
+    delete scene_commands;
+
+    // Workers go last: queued tasks finish before the threads are joined
+    if (jobs) {
+        Unigine::Console::removeCommand("job_timings");
+        Unigine::Console::removeCommand("memory_stats");
+    }
+    delete jobs;
+
     // Reset pointers
+    jobs = nullptr;
+    scene_commands = nullptr;
+    hover_preview = nullptr;
+    hover_current = nullptr;
     selection = nullptr;
+    picker = nullptr;
+    unit_pool = nullptr;
     grid_renderer = nullptr;
     spells = nullptr;
+    fog = nullptr;
     combat = nullptr;
+    history = nullptr;
+    replay = nullptr;
     turn_manager = nullptr;
     grid = nullptr;
+    grid_config = nullptr;
 
     Unigine::Log::message("GameManager::shutdown() - Complete\n");
 }
@@ -97,8 +345,73 @@ void GameManager::update(float dt) {
 
     // Update game logic (called at fixed 60 FPS from AppWorldLogic::updatePhysics)
     // TODO: Update turn system
-    // TODO: Update AI
     // TODO: Update combat state
+
+    // Enemy turns: only capture a snapshot and queue planning here - the search runs
+    // on AI workers and the result is applied in updateJobs()
+    if (turn_manager && turn_manager->isCombatActive() && !turn_manager->isPlayerTurn()) {
+        requestEnemyPlan();
+    }
+}
+
+void GameManager::updateJobs() {
+    // Poll AI futures (called per-frame from AppWorldLogic::update, main thread)
+    const unsigned int version = getStateVersion();
+
+    for (int i = ai_pending.size() - 1; i >= 0; i--) {
+        AIJobPtr job = ai_pending[i];
+
+        // Combat ended or state changed since the snapshot: the plan is stale
+        if (!in_combat || job->state_version != version) {
+            job->cancel();
+            ai_pending.remove(i);
+            continue;
+        }
+
+        if (!job->isReady()) continue;
+
+        EnemyPlan plan = job->result.get();
+        ai_pending.remove(i);
+
+        if (plan.valid) {
+            applyEnemyPlan(plan);
+        } else if (!job->isCancelled()) {
+            // No legal plan: enemy passes its turn
+            Unigine::Log::message("GameManager::updateJobs() - No plan for enemy, ending turn\n");
+            executeCommand(CombatCommand::endTurn(job->snapshot->combatants[job->actor].node_id));
+        }
+        return; // Applying a plan changes state; remaining jobs are re-checked next frame
+    }
+}
+
+void GameManager::postUpdate() {
+    // Nodes move, show and hide only here, in one batch (logic may have recorded them from any thread)
+    if (scene_commands) {
+        const int applied = scene_commands->drain([this](const SceneCommand& command) { applySceneCommand(command); });
+        PerfMonitor::get()->count(PerfCounter::SCENE_COMMANDS, applied);
+    }
+
+    // Rules write the dense combatant table; properties (Editor, world saves) are refreshed once per frame
+    CombatantTable::get()->writeBack();
+
+    // Grid chunks near the camera get the mesh budget; without a camera stream around the grid centre
+    if (isLoaded()) {
+        Unigine::PlayerPtr player = Unigine::Game::getPlayer();
+        if (player) {
+            Unigine::Math::WorldBoundFrustum frustum(player->getProjection(), player->getIWorldTransform());
+            grid_renderer->updateChunkStreaming(player->getWorldPosition(), &frustum);
+        } else {
+            grid_renderer->updateChunkStreaming(grid_renderer->gridToWorld(grid->getWidth() / 2, grid->getHeight() / 2), nullptr);
+        }
+
+        // Cell visuals follow only the cells that changed this frame (fog changes included)
+        updateFogViewers();
+        grid_renderer->updateGridVisuals();
+        grid->clearDirtyCells();
+    }
+
+    // Frame boundary: the main thread's scratch arena starts empty next frame
+    Arena::getThreadScratch().reset();
 }
 
 void GameManager::handleInput() {
@@ -107,28 +420,760 @@ void GameManager::handleInput() {
     // Update selection system (handles mouse picking and unit selection)
     if (selection) {
         selection->update();
+        updateHoverPreview();
+    }
+
+    // Ctrl+Z / Ctrl+Y: take back or replay an action during the player's turn
+    if (in_combat && turn_manager && turn_manager->isPlayerTurn()
+        && Unigine::Input::isKeyPressed(Unigine::Input::KEY_ANY_CTRL)) {
+        if (Unigine::Input::isKeyDown(Unigine::Input::KEY_Z)) {
+            undoAction();
+        } else if (Unigine::Input::isKeyDown(Unigine::Input::KEY_Y)) {
+            redoAction();
+        }
     }
 
     // TODO: Keyboard input
     // TODO: UI button callbacks
 }
 
+void GameManager::updateHoverPreview() {
+    UnitComponent* unit = selection->getSelectedUnit();
+    const bool valid = unit && selection->hasHoveredCell() && hover_preview && grid_renderer;
+    const int unit_id = unit ? unit->getNode()->getID() : 0;
+    const GridPosition cell = valid ? selection->getHoveredCell() : GridPosition();
+    const unsigned int version = getStateVersion();
+
+    // Mouse still and nothing changed: the shown preview is current
+    if (valid == hover_valid && unit_id == hover_unit_id && cell == hover_cell && version == hover_version) return;
+    hover_valid = valid;
+    hover_unit_id = unit_id;
+    hover_cell = cell;
+    hover_version = version;
+
+    hover_current = valid ? hover_preview->get(unit, cell, version) : nullptr;
+    if (!grid_renderer) return;
+
+    if (hover_current && hover_current->reachable) {
+        grid_renderer->setHighlights(hover_current->path, Unigine::Math::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    } else {
+        grid_renderer->clearHighlights();
+    }
+
+    if (hover_current && hover_current->target_node_id) {
+        Unigine::Log::message("Strike preview: %d%% hit, %d%% crit, %.1f avg damage (AC %d, cover +%d, height +%d, effects %+d, MAP %d)\n",
+            (int)(hover_current->odds.hit * 100.0f + 0.5f), (int)(hover_current->odds.critical * 100.0f + 0.5f),
+            hover_current->odds.expected_damage, hover_current->effective_ac,
+            CombatRules::getCoverBonus(hover_current->cover), hover_current->height_bonus,
+            hover_current->effect_bonus, hover_current->map);
+    }
+}
+
 void GameManager::startCombat() {
-    Unigine::Log::message("GameManager::startCombat() - Starting combat encounter\n");
+    if (!isLoaded()) return;
+
+    // Units placed in the world (idle pooled units excluded), sides by node naming convention
+    Unigine::Vector<Unigine::NodePtr> player_units;
+    Unigine::Vector<Unigine::NodePtr> enemy_units;
+    const CombatantTable* table = CombatantTable::get();
+    for (int row = 0; row < table->size(); row++) {
+        UnitComponent* unit = table->component[row];
+        if (unit->pooled || !unit->isAlive()) continue;
+
+        Unigine::NodePtr node = unit->getNode();
+        const bool is_player = !strncmp(node->getName(), "Player_", 7);
+        if (!is_player && strncmp(node->getName(), "Enemy_", 6)) continue;
+
+        // Editor-placed units only know their world position: put them on the grid
+        GridPosition at = grid_renderer->worldToGrid(node->getWorldPosition());
+        if (grid->isValidPosition(at) && !grid->getCell(at.x, at.y)->isOccupied()) {
+            grid->setOccupant(at, node);
+            unit->setGridPosition(at);
+        }
+        (is_player ? player_units : enemy_units).append(node);
+    }
+
+    if (player_units.size() == 0 || enemy_units.size() == 0) {
+        Unigine::Log::warning("GameManager::startCombat() - Need player and enemy units (%d / %d found)\n",
+            player_units.size(), enemy_units.size());
+        return;
+    }
+
+    const unsigned long long seed = (unsigned long long)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    startCombat(player_units, enemy_units, seed);
+}
+
+void GameManager::startCombat(const Unigine::Vector<Unigine::NodePtr>& player_units,
+                              const Unigine::Vector<Unigine::NodePtr>& enemy_units,
+                              unsigned long long seed) {
+    if (!isLoaded()) return;
+
+    Unigine::Log::message("GameManager::startCombat() - Starting combat encounter (seed %llu)\n", seed);
     in_combat = true;
+    cancelAIJobs();
 
-    // TODO: Get actual player and enemy units from the scene
-    // For now, just log that turn manager is ready
-    // turn_manager->startCombat(player_units, enemy_units);
+    // Capture the encounter before initiative is rolled - the replay re-rolls it from the seed
+    CombatSnapshot encounter;
+    encounter.captureEncounter(grid, player_units, enemy_units);
+    replay->begin(seed, encounter);
+
+    turn_manager->setSeed(seed);
+    turn_manager->startCombat(player_units, enemy_units);
+
+    // Nothing is explored yet; viewers are added from the table in postUpdate
+    fog->reset();
+    grid_renderer->setFogOfWar(fog);
 }
 
 void GameManager::endCombat() {
     Unigine::Log::message("GameManager::endCombat() - Ending combat encounter\n");
     in_combat = false;
 
+    cancelAIJobs();
+
     if (turn_manager) {
         turn_manager->endCombat();
     }
+    if (spells) spells->endCombat();
+    if (grid_renderer) grid_renderer->setFogOfWar(nullptr);
+
+    if (replay && replay->isRecording()) {
+        replay->end();
+        saveReplay("last_combat.replay");
+    }
 
     // TODO: Show victory/defeat screen
 }
+
+UnitComponent* GameManager::spawnUnit(const char* stat_block, GridPosition at, bool is_player_unit) {
+    if (!unit_pool) return nullptr;
+
+    const bool joins_combat = in_combat && turn_manager && turn_manager->isCombatActive();
+
+    // Placing a pooled unit is not an undoable step, and moves before it cannot be taken back
+    // through its cell: close the history and keep the placement out of it
+    if (history) history->commit();
+    grid->setHistory(nullptr);
+    UnitComponent* unit = unit_pool->acquire(stat_block, at, is_player_unit, joins_combat);
+    grid->setHistory(history);
+    if (!unit) return nullptr;
+
+    if (joins_combat) {
+        // Replays re-simulate a fixed encounter: a mid-fight arrival ends the recording here
+        if (replay && replay->isRecording()) {
+            Unigine::Log::message("GameManager::spawnUnit() - Reinforcement arrived, replay recording stopped\n");
+            replay->end();
+            saveReplay("last_combat.replay");
+        }
+        turn_manager->addUnit(unit->getNode(), is_player_unit);
+    }
+    return unit;
+}
+
+void GameManager::despawnUnit(UnitComponent* unit) {
+    if (!unit || !unit_pool) return;
+    if (unit->pooled || !unit_pool->owns(unit)) {
+        Unigine::Log::warning("GameManager::despawnUnit() - %s is not an active pooled unit\n", unit->unit_name.get());
+        return;
+    }
+
+    if (in_combat && turn_manager && turn_manager->isCombatActive()) {
+        // Replays re-simulate a fixed encounter: a departure ends the recording here
+        if (replay && replay->isRecording()) {
+            Unigine::Log::message("GameManager::despawnUnit() - Unit left the fight, replay recording stopped\n");
+            replay->end();
+            saveReplay("last_combat.replay");
+        }
+    }
+
+    // Same as spawnUnit: leaving the grid is not undoable (the node goes back to the pool)
+    if (history) history->commit();
+    grid->setHistory(nullptr);
+
+    if (turn_manager) {
+        const bool was_current = turn_manager->getCurrentUnit() == unit;
+        turn_manager->removeUnit(unit->getNode());
+        if (was_current) startNextTurn();
+    }
+    if (spells) spells->removeUnit(unit->getNode()->getID());
+    if (fog) fog->removeViewer(unit->getNode()->getID());
+    unit_pool->release(unit);
+
+    grid->setHistory(history);
+}
+
+unsigned int GameManager::getStateVersion() const {
+    // Both counters only grow, so the sum changes whenever either does
+    unsigned int version = 0;
+    if (grid) version += grid->getVersion();
+    if (turn_manager) version += turn_manager->getStateVersion();
+    return version;
+}
+
+void GameManager::requestEnemyPlan() {
+    if (!ai_jobs || !grid) return;
+
+    // Already planning the current turn?
+    const unsigned int version = getStateVersion();
+    for (int i = 0; i < ai_pending.size(); i++) {
+        if (ai_pending[i]->state_version == version) return;
+    }
+
+    std::shared_ptr<CombatSnapshot> snapshot = std::make_shared<CombatSnapshot>();
+    snapshot->capture(grid, turn_manager, version, fog);
+
+    ai_pending.append(ai_jobs->submitEnemyPlan(snapshot, snapshot->current_index));
+}
+
+void GameManager::applyEnemyPlan(const EnemyPlan& plan) {
+    Unigine::NodePtr unit_node = turn_manager->getCurrentUnitNode();
+    if (!unit_node || unit_node->getID() != plan.actor_node_id) {
+        Unigine::Log::warning("GameManager::applyEnemyPlan() - Plan does not match the current unit, discarding\n");
+        return;
+    }
+
+    // Stride(s) along the planned path
+    if (plan.path.size() > 1) {
+        executeCommand(CombatCommand::stride(plan.actor_node_id, plan.path.last(), plan.stride_actions));
+    }
+
+    // Strikes, until the target falls (or a Stride fell short and it is out of reach)
+    for (int i = 0; i < plan.strikes && turn_manager->canSpendActions(1); i++) {
+        if (!executeCommand(CombatCommand::strike(plan.actor_node_id, plan.target_node_id))) break;
+    }
+
+    executeCommand(CombatCommand::endTurn(plan.actor_node_id));
+}
+
+bool GameManager::canStride(UnitComponent* unit, GridPosition to, int actions) const {
+    const GridCell* destination = grid->isValidPosition(to) ? grid->getCell(to.x, to.y) : nullptr;
+    if (!destination || destination->blocked || destination->isOccupied()) return false;
+
+    CombatantTable* table = CombatantTable::get();
+    const Unigine::NodePtr self = unit->getNode();
+    const int width = grid->getWidth();
+    const int num_cells = width * grid->getHeight();
+
+    Unigine::Vector<unsigned char> mask;
+    Unigine::Vector<int> elevation;
+    mask.resize(num_cells);
+    elevation.resize(num_cells);
+    for (int i = 0; i < num_cells; i++) {
+        const GridCell* cell = grid->getCell(i % width, i / width);
+        bool occupied = false;
+        if (cell->occupant && cell->occupant != self) {
+            const int row = table->findRow(cell->occupant->getID());
+            occupied = row < 0 || table->current_hp[row] > 0;     // The fallen can be stepped over
+        }
+        mask[i] = cell->blocked || occupied ? 1 : 0;
+        elevation[i] = cell->elevation;
+    }
+
+    GridView view;
+    view.width = width;
+    view.height = grid->getHeight();
+    view.blocked = mask.get();
+    view.elevation = elevation.get();
+    return CombatRules::canStride(view, unit->getGridPosition(), to, unit->getStats().speed, actions);
+}
+
+bool GameManager::executeCommand(const CombatCommand& command) {
+    if (!in_combat || !turn_manager || !turn_manager->isCombatActive()) return false;
+
+    Unigine::NodePtr unit_node = turn_manager->getCurrentUnitNode();
+    UnitComponent* unit = turn_manager->getCurrentUnit();
+    if (!unit_node || !unit || unit_node->getID() != command.actor_node_id) {
+        Unigine::Log::warning("GameManager::executeCommand() - Unit #%d is not the current unit\n", command.actor_node_id);
+        return false;
+    }
+
+    switch (command.type) {
+    case CommandType::STRIDE: {
+        if (!turn_manager->canSpendActions(command.action_cost)) return false;
+        if (!canStride(unit, command.destination, command.action_cost)) {
+            Unigine::Log::warning("GameManager::executeCommand() - %s cannot Stride to (%d, %d)\n",
+                unit->unit_name.get(), command.destination.x, command.destination.y);
+            return false;
+        }
+        replay->recordCommand(command);
+
+        history->beginAction("Stride");
+        moveUnit(unit, command.destination);
+        for (int i = 0; i < command.action_cost; i++) {
+            turn_manager->spendActions(1);
+        }
+        history->endAction();
+
+        Unigine::Log::message("%s strides to (%d, %d)\n", unit->unit_name.get(),
+            command.destination.x, command.destination.y);
+        return true;
+    }
+    case CommandType::STRIKE: {
+        CombatantTable* table = CombatantTable::get();
+        const int attacker_row = unit->table_row;
+        const int target_row = table->findRow(command.target_node_id);
+        if (attacker_row < 0 || target_row < 0 || !turn_manager->canSpendActions(1)) return false;
+        UnitComponent* target = table->component[target_row];
+
+        // A living foe within reach (CombatSimulation::validate runs the same checks)
+        const bool hostile = table->faction[target_row] != (unsigned char)Faction::NONE
+            && table->faction[target_row] != table->faction[attacker_row];
+        if (table->current_hp[target_row] <= 0 || !hostile
+            || !CombatRules::isInReach(table->position[attacker_row], table->position[target_row])) {
+            Unigine::Log::warning("GameManager::executeCommand() - %s cannot Strike %s\n",
+                unit->unit_name.get(), target->unit_name.get());
+            return false;
+        }
+        replay->recordCommand(command);
+
+        // Rolls come from the seeded combat RNG, in the order ReplayRunner expects
+        const StatBlock& attacker = table->getStats(attacker_row);
+        const StatBlock& defender = table->getStats(target_row);
+
+        // Cover and height from the battlefield, then spell effects in play (Bless, Prone)
+        const StrikeSituation situation = CombatRules::getStrikeSituation(*grid,
+            table->position[attacker_row], table->position[target_row]);
+        int attack_bonus = attacker.attack_bonus + situation.height_bonus;
+        int armor_class = defender.armor_class + situation.cover_bonus;
+        if (spells) {
+            attack_bonus += spells->getEffects().getModifier(command.actor_node_id, EffectKind::STATUS_ATTACK);
+            armor_class += spells->getEffects().getArmorClassModifier(command.target_node_id);
+        }
+
+        StrikeResult result = CombatRules::resolveStrike(turn_manager->getRandom(),
+            attack_bonus, turn_manager->getCurrentMAP(), armor_class, attacker.damage);
+
+        static const char* degree_names[] = { "critical failure", "failure", "success", "critical success" };
+        Unigine::Log::message("%s strikes %s: %d (d20 %d) vs AC %d - %s\n",
+            unit->unit_name.get(), target->unit_name.get(), result.total, result.natural,
+            armor_class, degree_names[(int)result.degree]);
+
+        history->beginAction("Strike");
+        target->takeDamage(result.damage);
+        turn_manager->spendActions(1, ActionType::STRIKE);
+        history->endAction();
+
+        // The d20 is spent: neither the Strike nor the moves before it can be taken back
+        history->commit();
+        return true;
+    }
+    case CommandType::END_TURN:
+        replay->recordCommand(command);
+        startNextTurn();
+        return true;
+
+    case CommandType::UNDO:
+        if (!history->undo()) return false;
+        replay->recordCommand(command);
+        break;
+
+    case CommandType::REDO:
+        if (!history->redo()) return false;
+        replay->recordCommand(command);
+        break;
+    }
+
+    // Undo/redo: move the nodes of units whose cell changed
+    const CombatantTable* table = CombatantTable::get();
+    const Unigine::Vector<int>& moved = history->getMovedUnits();
+    for (int i = 0; i < moved.size(); i++) {
+        const int row = table->findRow(moved[i]);
+        if (row >= 0) scene_commands->push(SceneCommand::syncUnit(moved[i]));
+    }
+    return true;
+}
+
+void GameManager::cancelAIJobs() {
+    for (int i = 0; i < ai_pending.size(); i++) {
+        ai_pending[i]->cancel();
+    }
+    ai_pending.clear();
+
+    if (ai_jobs) {
+        ai_jobs->cancelAll();
+    }
+}
+
+void GameManager::moveUnit(UnitComponent* unit, GridPosition to) {
+    if (!unit || !grid) return;
+
+    Unigine::NodePtr node = unit->getNode();
+    GridPosition from = unit->getGridPosition();
+
+    grid->clearOccupant(from);
+    grid->setOccupant(to, node);
+
+    history->record(DeltaType::UNIT_POSITION, node->getID(),
+        CombatHistory::packPosition(from), CombatHistory::packPosition(to));
+    unit->setGridPosition(to);
+
+    // The node follows in postUpdate
+    scene_commands->push(SceneCommand::syncUnit(node->getID()));
+}
+
+bool GameManager::undoAction() {
+    if (!history || !turn_manager) return false;
+
+    Unigine::NodePtr unit_node = turn_manager->getCurrentUnitNode();
+    if (!unit_node) return false;
+    return executeCommand(CombatCommand::make(CommandType::UNDO, unit_node->getID()));
+}
+
+bool GameManager::redoAction() {
+    if (!history || !turn_manager) return false;
+
+    Unigine::NodePtr unit_node = turn_manager->getCurrentUnitNode();
+    if (!unit_node) return false;
+    return executeCommand(CombatCommand::make(CommandType::REDO, unit_node->getID()));
+}
+
+void GameManager::updateFogViewers() {
+    if (!fog) return;
+
+    // Moves already went through GridSystem::setOccupant; this catches units joining, leaving,
+    // dying and changing side. Unchanged viewers are a hash lookup each.
+    const CombatantTable* table = CombatantTable::get();
+    for (int row = 0; row < table->size(); row++) {
+        const bool sees = table->faction[row] != (unsigned char)Faction::NONE
+            && table->current_hp[row] > 0 && !table->component[row]->pooled;
+        if (sees) {
+            fog->setViewer(table->node_id[row], table->faction[row], table->position[row]);
+        } else {
+            fog->removeViewer(table->node_id[row]);
+        }
+    }
+
+    // Units whose row is gone (node deleted)
+    for (int i = fog->getNumViewers() - 1; i >= 0; i--) {
+        const int node = fog->getViewerNode(i);
+        if (table->findRow(node) < 0) fog->removeViewer(node);
+    }
+}
+
+void GameManager::startNextTurn() {
+    turn_manager->startNextTurn();
+
+    // "Until the start of the caster's next turn": effects outlast every other unit's turn
+    UnitComponent* current = turn_manager->getCurrentUnit();
+    if (spells && current) spells->startTurn(current->getNode()->getID());
+}
+
+void GameManager::syncUnitNode(UnitComponent* unit) {
+    Unigine::NodePtr node = unit->getNode();
+    if (!node || !grid_renderer) return;
+
+    // Keep the node's height above the cell it currently stands on (capsule pivots are not at the feet)
+    Unigine::Math::dvec3 current = node->getWorldPosition();
+    double height = current.z - grid_renderer->gridToWorld(grid_renderer->worldToGrid(current)).z;
+    Unigine::Math::dvec3 target = grid_renderer->gridToWorld(unit->getGridPosition());
+    node->setWorldPosition(Unigine::Math::dvec3(target.x, target.y, target.z + height));
+}
+
+void GameManager::applySceneCommand(const SceneCommand& command) {
+    switch (command.type) {
+    case SceneCommandType::SYNC_UNIT: {
+        const CombatantTable* table = CombatantTable::get();
+        const int row = table->findRow(command.node_id);
+        if (row >= 0) syncUnitNode(table->component[row]);
+        break;
+    }
+    case SceneCommandType::MOVE_NODE: {
+        Unigine::NodePtr node = Unigine::World::getNodeByID(command.node_id);
+        if (node) node->setWorldPosition(command.position);
+        break;
+    }
+    case SceneCommandType::ENABLE_NODE: {
+        Unigine::NodePtr node = Unigine::World::getNodeByID(command.node_id);
+        if (node) node->setEnabled(command.enabled);
+        break;
+    }
+    case SceneCommandType::HIGHLIGHT_CELL:
+        if (grid_renderer) grid_renderer->highlightCell(GridPosition(command.x, command.y), command.color);
+        break;
+
+    case SceneCommandType::UNHIGHLIGHT_CELL:
+        if (grid_renderer) grid_renderer->unhighlightCell(GridPosition(command.x, command.y));
+        break;
+
+    case SceneCommandType::CLEAR_HIGHLIGHTS:
+        if (grid_renderer) grid_renderer->clearHighlights();
+        break;
+    }
+}
+
+bool GameManager::saveState(const Unigine::StreamPtr& stream) {
+    if (!isLoaded()) return false;
+
+    // Commit any open action so the saved state is consistent
+    if (history) history->endAction();
+    return CombatSerializer::save(stream, grid, turn_manager, spells, unit_pool);
+}
+
+bool GameManager::restoreState(const Unigine::StreamPtr& stream) {
+    if (!isLoaded()) return false;
+
+    // Plans, undo steps and the replay being recorded refer to the state being replaced
+    cancelAIJobs();
+    if (replay) replay->end();
+
+    // Restoring writes thousands of cells: do not record them as undo deltas
+    grid->setHistory(nullptr);
+    bool ok = CombatSerializer::restore(stream, grid, turn_manager, spells, unit_pool);
+    grid->setHistory(history);
+    if (history) history->beginTurn();
+
+    if (!ok) return false;
+
+    in_combat = turn_manager->isCombatActive();
+
+    // Move unit nodes to their restored cells
+    for (int i = 0; i < turn_manager->getInitiativeCount(); i++) {
+        UnitComponent* unit = turn_manager->getInitiativeEntry(i).unit_component;
+        if (unit) syncUnitNode(unit);
+    }
+    return true;
+}
+
+void GameManager::saveReplay(const char* path) {
+    Unigine::FilePtr file = Unigine::File::create();
+    if (!file->open(path, "wb")) {
+        Unigine::Log::warning("GameManager::saveReplay() - Cannot open '%s'\n", path);
+        return;
+    }
+
+    const ReplayLog& log = replay->getLog();
+    log.save(file);
+    file->close();
+
+    Unigine::Log::message("GameManager::saveReplay() - Saved '%s' (%d commands, %d turns)\n",
+        path, log.commands.size(), log.checkpoints.size());
+}
+
+void GameManager::consoleReplay(int argc, char** argv) {
+    // combat_replay           - verify the combat being recorded (or the last one)
+    // combat_replay <file>    - verify a saved replay
+    ReplayLog loaded;
+    const ReplayLog* log = &replay->getLog();
+
+    if (argc > 1) {
+        Unigine::FilePtr file = Unigine::File::create();
+        if (!file->open(argv[1], "rb") || !loaded.load(file)) {
+            Unigine::Log::warning("GameManager::consoleReplay() - Cannot load replay '%s'\n", argv[1]);
+            return;
+        }
+        file->close();
+        log = &loaded;
+    }
+
+    ReplayReport report;
+    ReplayRunner::run(*log, report);
+
+    if (report.completed) {
+        Unigine::Log::message("combat_replay: OK - %d turns, %d commands matched in %.2f ms\n",
+            report.turns_checked, log->commands.size(), report.elapsed_ms);
+    } else if (report.expected_hash != report.actual_hash) {
+        Unigine::Log::message("combat_replay: DIVERGED at turn %d (expected %016llx, got %016llx) after %.2f ms\n",
+            report.first_divergent_turn, report.expected_hash, report.actual_hash, report.elapsed_ms);
+    } else {
+        Unigine::Log::message("combat_replay: FAILED at turn %d - %s (%d of %d turns checked)\n",
+            report.first_divergent_turn, report.error, report.turns_checked, log->checkpoints.size());
+    }
+}
+
+void GameManager::consoleLockstep(int argc, char** argv) {
+    // lockstep_test [turns] [hash_interval] [desync] - the encounter being recorded (or the last one)
+    const ReplayLog& log = replay->getLog();
+    if (log.encounter.combatants.size() == 0) {
+        Unigine::Log::warning("GameManager::consoleLockstep() - No encounter recorded yet, start a combat first\n");
+        return;
+    }
+
+    const int turns = argc > 1 ? atoi(argv[1]) : LOCKSTEP_TEST_TURNS;
+    const int hash_interval = argc > 2 ? atoi(argv[2]) : 1;
+    const bool desync = argc > 3 && !strcmp(argv[3], "desync");
+
+    LockstepTestReport report;
+    LockstepSelfTest::run(log.encounter, log.seed, turns > 0 ? turns : LOCKSTEP_TEST_TURNS, hash_interval,
+        desync, LOCKSTEP_TEST_PORT, report);
+
+    const int bytes_per_turn = report.turns > 0 ? (report.bytes_up + report.bytes_down) / (2 * report.turns) : 0;
+    if (report.completed) {
+        Unigine::Log::message("lockstep_test: OK - %d turns, %d commands, %d hashes matched, final %016llx in %.2f ms\n",
+            report.turns, report.commands, report.hashes, report.final_hash[0], report.elapsed_ms);
+    } else if (report.desync_turn > 0) {
+        Unigine::Log::message("lockstep_test: DESYNC detected at turn %d (final %016llx vs %016llx)\n",
+            report.desync_turn, report.final_hash[0], report.final_hash[1]);
+    } else {
+        Unigine::Log::message("lockstep_test: FAILED after %d turns - %s\n", report.turns, report.error);
+    }
+    Unigine::Log::message("lockstep_test: %d bytes up, %d bytes down (%d bytes per client per turn)\n",
+        report.bytes_up, report.bytes_down, bytes_per_turn);
+}
+
+void GameManager::consoleJobTimings(int argc, char** argv) {
+    if (!jobs) return;
+
+    if (argc > 1 && !strcmp(argv[1], "reset")) {
+        jobs->resetTimings();
+        Unigine::Log::message("job_timings: reset\n");
+        return;
+    }
+
+    std::vector<JobTiming> timings;
+    jobs->getTimings(timings);
+
+    Unigine::Log::message("job_timings: %d workers\n", jobs->getWorkerCount());
+    for (size_t i = 0; i < timings.size(); i++) {
+        const JobTiming& timing = timings[i];
+        if (timing.tasks == 0) continue;
+        Unigine::Log::message("  %-12s %6d tasks  %9.2f ms total  %7.3f ms avg  %7.3f ms max\n",
+            timing.system.c_str(), timing.tasks, timing.total_ms, timing.total_ms / timing.tasks, timing.max_ms);
+    }
+}
+
+void GameManager::consoleMemoryStats(int argc, char** argv) {
+    if (argc > 1 && !strcmp(argv[1], "reset")) {
+        MemoryStats::reset();
+        Unigine::Log::message("memory_stats: reset\n");
+        return;
+    }
+
+    Unigine::Log::message("memory_stats: %-8s %10s %12s %10s %12s\n", "system", "heap", "heap bytes", "arena", "arena bytes");
+    for (int i = 0; i < (int)MemorySystem::COUNT; i++) {
+        const MemoryStats::Counters counters = MemoryStats::get((MemorySystem)i);
+        Unigine::Log::message("              %-8s %10lld %12lld %10lld %12lld\n", MemoryStats::getName((MemorySystem)i),
+            counters.heap_allocations, counters.heap_bytes, counters.arena_allocations, counters.arena_bytes);
+    }
+
+    const Arena& scratch = Arena::getThreadScratch();
+    Unigine::Log::message("memory_stats: main scratch %zu KB high water, %zu KB in %d blocks\n",
+        scratch.getHighWater() / 1024, scratch.getCapacity() / 1024, scratch.getBlockCount());
+}
+
+void GameManager::consoleSpells(int argc, char** argv) {
+    if (!spells) return;
+
+    static const char* targeting_names[] = { "self", "creatures", "burst", "emanation" };
+    Unigine::Log::message("spells: %d compiled, %d instructions\n", spells->getNumSpells(), spells->getNumInstructions());
+    for (int i = 0; i < spells->getNumSpells(); i++) {
+        const SpellProgram& program = spells->getSpell(i);
+        Unigine::Log::message("  %-18s rank %d  %d actions  %-9s %3d ft  %d ops%s\n", program.id, program.rank,
+            program.actions, targeting_names[(int)program.targeting], program.range_feet, program.num_instructions,
+            program.sustained ? "  sustained" : "");
+    }
+
+    const AuraTracker& auras = spells->getAuras();
+    Unigine::Log::message("spells: %d auras (%d enter/leave events, %d membership tests)\n",
+        auras.getNumAuras(), auras.getEventCount(), auras.getTestCount());
+    for (int i = 0; i < auras.getNumAuras(); i++) {
+        const Aura& aura = auras.getAura(i);
+        Unigine::Log::message("  %s from #%d at (%d, %d), %d ft, %d inside, %d rounds\n", spells->getSpell(aura.spell).id,
+            aura.source, aura.origin.x, aura.origin.y, aura.radius_feet, aura.members.size(), aura.rounds);
+    }
+
+    const Unigine::Vector<ActiveEffect>& effects = spells->getEffects().getEffects();
+    Unigine::Log::message("spells: %d active effects\n", effects.size());
+    for (int i = 0; i < effects.size(); i++) {
+        const ActiveEffect& effect = effects[i];
+        Unigine::Log::message("  #%d %s %+d from #%d (%s), %d rounds\n", effect.target, EffectTable::getName(effect.kind),
+            effect.value, effect.source, effect.spell >= 0 ? spells->getSpell(effect.spell).id : "-", effect.rounds);
+    }
+}
+
+void GameManager::consoleSpellCast(int argc, char** argv) {
+    if (!spells || !in_combat || !turn_manager || !turn_manager->isCombatActive()) {
+        Unigine::Log::warning("spell_cast: no combat in progress\n");
+        return;
+    }
+    if (argc < 4) {
+        Unigine::Log::message("usage: spell_cast <id> <x> <y> [rank]\n");
+        return;
+    }
+
+    const int spell = spells->findSpell(argv[1]);
+    UnitComponent* caster = turn_manager->getCurrentUnit();
+    if (spell == SpellSystem::INVALID_ID || !caster) {
+        Unigine::Log::warning("spell_cast: unknown spell '%s'\n", argv[1]);
+        return;
+    }
+
+    // Chosen-creature spells target the unit on the cell; areas are aimed at it
+    const GridPosition aim(atoi(argv[2]), atoi(argv[3]));
+    Unigine::Vector<int> targets;
+    const GridCell* cell = grid->isValidPosition(aim) ? grid->getCell(aim) : nullptr;
+    if (cell && cell->occupant) targets.append(cell->occupant->getID());
+
+    // Casts are not replay commands yet: the dice they consume would desync the recording
+    if (replay && replay->isRecording()) {
+        Unigine::Log::message("spell_cast: replay recording stopped\n");
+        replay->end();
+        saveReplay("last_combat.replay");
+    }
+
+    const int rank = argc > 4 ? atoi(argv[4]) : 0;
+    if (spells->isSustaining(caster->getNode()->getID(), spell)) {
+        spells->sustain(caster->table_row, spell, aim, targets);
+    } else {
+        spells->cast(caster->table_row, spell, rank, aim, targets);
+    }
+}
+
+void GameManager::consoleFog(int argc, char** argv) {
+    if (!fog) return;
+
+    if (argc > 1) {
+        const bool enemy = !strcmp(argv[1], "enemy");
+        fog->setDisplayFaction((int)(enemy ? Faction::ENEMY : Faction::PLAYER));
+    }
+
+    Unigine::Log::message("fog: showing %s, %d viewers, sight %d cells\n",
+        fog->getDisplayFaction() == (int)Faction::ENEMY ? "enemy" : "player", fog->getNumViewers(), fog->getSightCells());
+    Unigine::Log::message("fog: %d views computed, %d cell counts changed\n", fog->getViewUpdates(), fog->getCellUpdates());
+
+    const char* names[FogOfWar::NUM_FACTIONS] = { "none", "player", "enemy" };
+    for (int faction = (int)Faction::PLAYER; faction < FogOfWar::NUM_FACTIONS; faction++) {
+        int visible = 0;
+        int explored = 0;
+        for (int y = 0; y < grid->getHeight(); y++) {
+            for (int x = 0; x < grid->getWidth(); x++) {
+                if (fog->isVisible(faction, x, y)) visible++;
+                if (fog->isExplored(faction, x, y)) explored++;
+            }
+        }
+        Unigine::Log::message("  %s: %d cells visible, %d explored\n", names[faction], visible, explored);
+    }
+}
+
+void GameManager::consoleUnitSpawn(int argc, char** argv) {
+    if (argc < 4) {
+        Unigine::Log::message("usage: unit_spawn <block> <x> <y> [player]\n");
+        return;
+    }
+
+    const GridPosition at(atoi(argv[2]), atoi(argv[3]));
+    const bool is_player_unit = argc > 4 && !strcmp(argv[4], "player");
+    UnitComponent* unit = spawnUnit(argv[1], at, is_player_unit);
+    if (!unit) return;      // UnitPool::acquire logged why
+
+    Unigine::Log::message("unit_spawn: %s at (%d, %d)%s\n", unit->getNode()->getName(), at.x, at.y,
+        in_combat ? ", joined the combat" : "");
+}
+
+void GameManager::consoleUnitDespawn(int argc, char** argv) {
+    if (argc < 3) {
+        Unigine::Log::message("usage: unit_despawn <x> <y>\n");
+        return;
+    }
+
+    const GridPosition at(atoi(argv[1]), atoi(argv[2]));
+    const GridCell* cell = grid->isValidPosition(at) ? grid->getCell(at) : nullptr;
+    UnitComponent* unit = cell && cell->occupant
+        ? Unigine::ComponentSystem::get()->getComponent<UnitComponent>(cell->occupant) : nullptr;
+    if (!unit) {
+        Unigine::Log::warning("unit_despawn: no unit on (%d, %d)\n", at.x, at.y);
+        return;
+    }
+
+    Unigine::Log::message("unit_despawn: %s\n", unit->getNode()->getName());
+    despawnUnit(unit);
+}
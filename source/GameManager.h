@@ -4,26 +4,58 @@
 
 #pragma once
 #include "Input/SelectionSystem.h"
+#include <UnigineVector.h>
+#include <UnigineStreams.h>
+#include <memory>
 
 // Forward declarations (full includes in .cpp)
 class GridSystem;
+class FogOfWar;
 class TurnManager;
 class CombatResolver;
 class SpellSystem;
 class GridRenderer;
+class JobSystem;
+class AIJobQueue;
+class SceneCommandBuffer;
+class CombatHistory;
+class UnitComponent;
+class ReplayRecorder;
+class UnitPool;
+class GridPicker;
+class HoverPreviewCache;
+class LoadPipeline;
+class GridConfigComponent;
+struct JobTask;
+struct HoverPreview;
+struct AIJob;
+struct EnemyPlan;
+struct CombatCommand;
+struct SceneCommand;
+enum class LoadStep;
 
 class GameManager {
 public:
     GameManager();
     ~GameManager();
 
-    // Lifecycle
+    // Lifecycle: init() only finds the config and queues the world setup; the grid, its
+    // visuals and the unit pool are built time-sliced by updateLoading() over the next frames
     void init();
     void shutdown();
 
+    // Loading progress (gameplay, input and saves wait until isLoaded())
+    void updateLoading();         // Called first in AppWorldLogic::update
+    bool isLoaded() const;
+    float getLoadProgress() const;              // 0..1
+    const char* getLoadStage() const;           // "" when loaded
+    const LoadPipeline* getLoadPipeline() const { return loader; }  // Per-stage timings
+
     // Update loops
     void update(float dt);        // Game logic (called from AppWorldLogic::updatePhysics)
     void handleInput();           // Input handling (called from AppWorldLogic::update)
+    void updateJobs();            // Apply finished background jobs (called from AppWorldLogic::update)
+    void postUpdate();            // Engine boundary: push game state to nodes/properties (AppWorldLogic::postUpdate)
 
     // Systems (public for access from UI, debug, Components)
     GridSystem* grid;
@@ -32,15 +64,120 @@ public:
     SpellSystem* spells;
     GridRenderer* grid_renderer;
     Unigine::SelectionSystem* selection;
+    JobSystem* jobs;              // Shared worker pool (AI, batched grid queries)
+    AIJobQueue* ai_jobs;
+    SceneCommandBuffer* scene_commands;  // Visual intents from game logic, applied in postUpdate
+    CombatHistory* history;
+    ReplayRecorder* replay;
+    UnitPool* unit_pool;
+    GridPicker* picker;
+    HoverPreviewCache* hover_preview;
+    FogOfWar* fog;                // Per-faction visibility; the batched grid shows the player's during combat
 
     // Game state
     bool isInCombat() const { return in_combat; }
     void startCombat();
     void endCombat();
 
+    // Start an encounter with a fixed RNG seed; the seed, units and every command are
+    // recorded so the fight can be re-simulated with ReplayRunner
+    void startCombat(const Unigine::Vector<Unigine::NodePtr>& player_units,
+                     const Unigine::Vector<Unigine::NodePtr>& enemy_units,
+                     unsigned long long seed);
+
+    // Reinforcements and summons: take a pre-created unit from the pool and place it on 'at'.
+    // During combat the unit joins the initiative order. Returns nullptr if none is idle.
+    UnitComponent* spawnUnit(const char* stat_block, GridPosition at, bool is_player_unit);
+    void despawnUnit(UnitComponent* unit);
+
+    // Perform a player or AI decision for the current unit (recorded for replay).
+    // Returns false if the command is not legal right now.
+    bool executeCommand(const CombatCommand& command);
+
+    // Combined grid + turn state version (changes whenever combat state changes)
+    unsigned int getStateVersion() const;
+
+    // World save/restore (called from AppWorldLogic::save/restore)
+    bool saveState(const Unigine::StreamPtr& stream);
+    bool restoreState(const Unigine::StreamPtr& stream);
+
+    // Move a unit between cells (grid occupancy, unit position and scene node), recorded for undo
+    void moveUnit(UnitComponent* unit, GridPosition to);
+
+    // Preview for the selected unit and the hovered cell (nullptr if none); valid for this frame
+    const HoverPreview* getHoverPreview() const { return hover_current; }
+
+    // Take back / replay actions within the current turn
+    bool undoAction();
+    bool redoAction();
+
 private:
     bool in_combat;
 
+    // Time-sliced world setup (stages run from updateLoading)
+    LoadPipeline* loader;
+    GridConfigComponent* grid_config;
+    std::shared_ptr<JobTask> load_job;          // Grid construction on a worker
+    GridSystem* loading_grid;                   // Written by load_job, adopted by loadGrid
+    int load_pool_block;                        // Unit pool: database block being reserved
+    int load_pool_reserved;                     // Units of that block created so far
+    LoadStep loadGrid(float& progress);
+    LoadStep loadVisuals(float& progress);
+    LoadStep loadUnits(float& progress);
+    LoadStep loadInteraction(float& progress);
+
+    // Hover feedback (path highlight, strike odds), refreshed only when its key changes
+    const HoverPreview* hover_current;
+    int hover_unit_id;
+    GridPosition hover_cell;
+    unsigned int hover_version;
+    bool hover_valid;
+    void updateHoverPreview();
+
+    // Enemy turn planning (runs on ai_jobs workers, applied in updateJobs)
+    Unigine::Vector<std::shared_ptr<AIJob>> ai_pending;
+    void requestEnemyPlan();
+    void applyEnemyPlan(const EnemyPlan& plan);
+
+    // Stride legality on the live grid: the same rules as CombatSimulation::validate (living
+    // units and non-combat occupants block, the destination must be empty)
+    bool canStride(UnitComponent* unit, GridPosition to, int actions) const;
+    void cancelAIJobs();
+
+    // Fog viewers follow the combatant table: every living unit with a faction sees (postUpdate)
+    void updateFogViewers();
+    void consoleFog(int argc, char** argv);
+
+    // TurnManager::startNextTurn, then the new unit's spell durations count down
+    void startNextTurn();
+
+    // Place a unit's scene node on its grid cell (keeps the node's height above the cell)
+    void syncUnitNode(UnitComponent* unit);
+
+    // Apply one recorded visual intent (postUpdate only)
+    void applySceneCommand(const SceneCommand& command);
+
+    // Replays: written when combat ends, verified headlessly with the combat_replay command
+    void saveReplay(const char* path);
+    void consoleReplay(int argc, char** argv);
+
+    // Lockstep self-test: the recorded encounter played by two scripted clients over loopback
+    void consoleLockstep(int argc, char** argv);
+
+    // Per-system job timings: job_timings prints them, job_timings reset clears them
+    void consoleJobTimings(int argc, char** argv);
+
+    // Per-subsystem heap vs arena allocation counters (memory_stats [reset])
+    void consoleMemoryStats(int argc, char** argv);
+
+    // Spell catalog and effects (spells), debug casting for the current unit (spell_cast)
+    void consoleSpells(int argc, char** argv);
+    void consoleSpellCast(int argc, char** argv);
+
+    // Pool reinforcements: unit_spawn <block> <x> <y> [player], unit_despawn <x> <y>
+    void consoleUnitSpawn(int argc, char** argv);
+    void consoleUnitDespawn(int argc, char** argv);
+
     // Prevent copying
     GameManager(const GameManager&) = delete;
     GameManager& operator=(const GameManager&) = delete;
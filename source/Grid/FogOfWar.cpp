@@ -0,0 +1,219 @@
+// FogOfWar.cpp
+#include "FogOfWar.h"
+#include "GridSystem.h"
+
+using namespace Unigine;
+
+FogOfWar::FogOfWar(GridSystem* grid_system, int sight)
+    : grid(grid_system)
+    , width(grid_system->getWidth())
+    , height(grid_system->getHeight())
+    , sight_cells(sight)
+    , display_faction(1)
+    , view_updates(0)
+    , cell_updates(0)
+{
+    const int num_cells = width * height;
+    for (int f = 0; f < NUM_FACTIONS; f++) {
+        layers[f].count.resize(num_cells);
+        layers[f].explored.resize((num_cells + 31) / 32);
+        for (int i = 0; i < num_cells; i++) {
+            layers[f].count[i] = 0;
+        }
+        for (int i = 0; i < layers[f].explored.size(); i++) {
+            layers[f].explored[i] = 0;
+        }
+    }
+}
+
+void FogOfWar::setViewer(int node, int faction, GridPosition pos) {
+    if (faction <= 0 || faction >= NUM_FACTIONS) {
+        removeViewer(node);
+        return;
+    }
+
+    HashMap<int, int>::Iterator it = viewer_by_node.find(node);
+    if (it != viewer_by_node.end()) {
+        const Viewer& viewer = viewers[it->data];
+        if (viewer.faction != faction || viewer.origin.x != pos.x || viewer.origin.y != pos.y) {
+            updateViewer(it->data, faction, pos);
+        }
+        return;
+    }
+
+    Viewer viewer;
+    viewer.node = node;
+    viewer.faction = faction;
+    viewer.origin = pos;
+    viewers.append(viewer);
+    viewer_by_node.append(node, viewers.size() - 1);
+
+    Viewer& added = viewers.last();
+    computeView(pos, added.cells);
+    addView(faction, added.cells);
+}
+
+void FogOfWar::removeViewer(int node) {
+    HashMap<int, int>::Iterator it = viewer_by_node.find(node);
+    if (it == viewer_by_node.end()) return;
+
+    const int index = it->data;
+    releaseView(viewers[index].faction, viewers[index].cells);
+    viewer_by_node.remove(node);
+
+    // Swap the last viewer in
+    const int last = viewers.size() - 1;
+    if (index != last) {
+        viewers[index] = viewers[last];
+        viewer_by_node[viewers[index].node] = index;
+    }
+    viewers.removeFast(last);
+}
+
+bool FogOfWar::hasViewer(int node) const {
+    HashMap<int, int>::ConstIterator it = viewer_by_node.find(node);
+    return it != viewer_by_node.end();
+}
+
+void FogOfWar::onUnitMoved(int node, GridPosition pos) {
+    HashMap<int, int>::Iterator it = viewer_by_node.find(node);
+    if (it != viewer_by_node.end()) updateViewer(it->data, viewers[it->data].faction, pos);
+}
+
+void FogOfWar::reset() {
+    while (viewers.size() > 0) {
+        removeViewer(viewers.last().node);
+    }
+
+    // Explored cells of the displayed faction go dark again
+    const Layer& shown = layers[display_faction];
+    const int num_cells = width * height;
+    for (int cell = 0; cell < num_cells; cell++) {
+        if ((shown.explored[cell >> 5] >> (cell & 31)) & 1) grid->markCellDirty(cell % width, cell / width);
+    }
+    for (int f = 0; f < NUM_FACTIONS; f++) {
+        for (int i = 0; i < layers[f].explored.size(); i++) {
+            layers[f].explored[i] = 0;
+        }
+    }
+}
+
+bool FogOfWar::isVisible(int faction, int x, int y) const {
+    if (faction <= 0 || faction >= NUM_FACTIONS || x < 0 || y < 0 || x >= width || y >= height) return false;
+    return layers[faction].count[y * width + x] > 0;
+}
+
+bool FogOfWar::isExplored(int faction, int x, int y) const {
+    if (faction <= 0 || faction >= NUM_FACTIONS || x < 0 || y < 0 || x >= width || y >= height) return false;
+    const int cell = y * width + x;
+    return (layers[faction].explored[cell >> 5] >> (cell & 31)) & 1;
+}
+
+int FogOfWar::getViewerCount(int faction, int x, int y) const {
+    if (faction <= 0 || faction >= NUM_FACTIONS || x < 0 || y < 0 || x >= width || y >= height) return 0;
+    return layers[faction].count[y * width + x];
+}
+
+void FogOfWar::copyVisible(int faction, Vector<unsigned char>& out) const {
+    const int num_cells = width * height;
+    out.resize(num_cells);
+    const bool valid = faction > 0 && faction < NUM_FACTIONS;
+    for (int i = 0; i < num_cells; i++) {
+        out[i] = valid && layers[faction].count[i] > 0 ? 1 : 0;
+    }
+}
+
+void FogOfWar::setDisplayFaction(int faction) {
+    if (faction <= 0 || faction >= NUM_FACTIONS || faction == display_faction) return;
+    display_faction = faction;
+
+    // Every cell may look different from the other side
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            grid->markCellDirty(x, y);
+        }
+    }
+}
+
+void FogOfWar::computeView(GridPosition origin, Vector<int>& out) {
+    out.clear();
+    view_updates++;
+    if (origin.x < 0 || origin.y < 0 || origin.x >= width || origin.y >= height) return;   // Off the grid: sees nothing
+
+    // Disc of radius sight_cells (+half a cell, so the edge is not a lone spike)
+    const int radius_sq = sight_cells * sight_cells + sight_cells;
+    const int y_min = origin.y - sight_cells > 0 ? origin.y - sight_cells : 0;
+    const int y_max = origin.y + sight_cells < height - 1 ? origin.y + sight_cells : height - 1;
+    const int x_min = origin.x - sight_cells > 0 ? origin.x - sight_cells : 0;
+    const int x_max = origin.x + sight_cells < width - 1 ? origin.x + sight_cells : width - 1;
+
+    for (int y = y_min; y <= y_max; y++) {
+        const int dy = y - origin.y;
+        for (int x = x_min; x <= x_max; x++) {
+            const int dx = x - origin.x;
+            if (dx * dx + dy * dy > radius_sq) continue;
+            if (hasLineOfSight(origin.x, origin.y, x, y)) out.append(y * width + x);
+        }
+    }
+}
+
+bool FogOfWar::hasLineOfSight(int x0, int y0, int x1, int y1) const {
+    // Bresenham between cell centres; a blocked cell is seen but hides what is behind it
+    const int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    const int dy = y1 > y0 ? y1 - y0 : y0 - y1;
+    const int step_x = x0 < x1 ? 1 : -1;
+    const int step_y = y0 < y1 ? 1 : -1;
+    int error = dx - dy;
+    int x = x0;
+    int y = y0;
+
+    for (;;) {
+        const int error2 = error * 2;
+        if (error2 > -dy) {
+            error -= dy;
+            x += step_x;
+        }
+        if (error2 < dx) {
+            error += dx;
+            y += step_y;
+        }
+        if (x == x1 && y == y1) return true;
+        if (grid->getCell(x, y)->blocked) return false;
+    }
+}
+
+void FogOfWar::addView(int faction, const Vector<int>& cells) {
+    Layer& layer = layers[faction];
+    const bool shown = faction == display_faction;
+    for (int i = 0; i < cells.size(); i++) {
+        const int cell = cells[i];
+        if (layer.count[cell]++ == 0 && shown) grid->markCellDirty(cell % width, cell / width);
+        layer.explored[cell >> 5] |= 1u << (cell & 31);
+    }
+    cell_updates += cells.size();
+}
+
+void FogOfWar::releaseView(int faction, const Vector<int>& cells) {
+    Layer& layer = layers[faction];
+    const bool shown = faction == display_faction;
+    for (int i = 0; i < cells.size(); i++) {
+        const int cell = cells[i];
+        if (--layer.count[cell] == 0 && shown) grid->markCellDirty(cell % width, cell / width);
+    }
+    cell_updates += cells.size();
+}
+
+void FogOfWar::updateViewer(int index, int faction, GridPosition pos) {
+    // New view first: cells seen from both places never drop to zero, so they are not redrawn
+    computeView(pos, scratch);
+    addView(faction, scratch);
+
+    Viewer& viewer = viewers[index];
+    releaseView(viewer.faction, viewer.cells);
+    viewer.faction = faction;
+    viewer.origin = pos;
+
+    // clear() keeps capacity, so a unit moving every turn stops allocating after its first move
+    viewer.cells.clear();
+    viewer.cells.append(scratch);
+}
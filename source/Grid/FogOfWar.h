@@ -0,0 +1,84 @@
+// FogOfWar.h
+// Per-faction visibility over the grid: a visible layer (reference counts) and an explored layer
+// Each viewer keeps the list of cells it sees. A viewer that moves adds its new view, then
+// releases its old one, so a cell's count is the number of the faction's units seeing it and
+// only the moving unit's two fields of view are touched. Cells of the displayed faction whose
+// visible/explored state flips are marked dirty in GridSystem for the renderer.
+// Sight is blocked by impassable terrain (lines of cells between centres); units do not block
+// it. Terrain does not change during combat, so views are not recomputed on setBlocked.
+
+#pragma once
+
+#include "GridCell.h"
+#include <UnigineVector.h>
+#include <UnigineHashMap.h>
+
+class GridSystem;
+
+class FogOfWar {
+public:
+    static const int NUM_FACTIONS = 3;      // Indexed by Faction (CombatantTable.h); NONE never sees
+
+    FogOfWar(GridSystem* grid_system, int sight_cells);
+
+    // Add or move a viewer. Cheap when nothing changed (per-frame sync calls it for every unit).
+    void setViewer(int node, int faction, GridPosition pos);
+    void removeViewer(int node);
+    bool hasViewer(int node) const;
+
+    // GridSystem::setOccupant hook: moves the unit's view if it is a viewer
+    void onUnitMoved(int node, GridPosition pos);
+
+    // Drop every viewer and forget what was explored (new encounter)
+    void reset();
+
+    bool isVisible(int faction, int x, int y) const;
+    bool isExplored(int faction, int x, int y) const;
+    int getViewerCount(int faction, int x, int y) const;   // Units of the faction seeing the cell
+
+    // Whole layers (index = y * width + x), for snapshots
+    void copyVisible(int faction, Unigine::Vector<unsigned char>& out) const;
+
+    // Faction whose changes are reported to GridSystem's dirty cells (what the renderer shows)
+    void setDisplayFaction(int faction);
+    int getDisplayFaction() const { return display_faction; }
+
+    int getSightCells() const { return sight_cells; }
+    int getNumViewers() const { return viewers.size(); }
+    int getViewerNode(int index) const { return viewers[index].node; }
+
+    // Cost tracking: fields of view computed and reference counts changed since creation
+    int getViewUpdates() const { return view_updates; }
+    int getCellUpdates() const { return cell_updates; }
+
+private:
+    struct Viewer {
+        int node;
+        int faction;
+        GridPosition origin;
+        Unigine::Vector<int> cells;     // Cell indices in view
+    };
+
+    struct Layer {
+        Unigine::Vector<unsigned short> count;      // Viewers per cell
+        Unigine::Vector<unsigned int> explored;     // One bit per cell
+    };
+
+    GridSystem* grid;
+    int width;
+    int height;
+    int sight_cells;
+    int display_faction;
+    Layer layers[NUM_FACTIONS];
+    Unigine::Vector<Viewer> viewers;
+    Unigine::HashMap<int, int> viewer_by_node;
+    Unigine::Vector<int> scratch;       // New view while the old one is still counted
+    int view_updates;
+    int cell_updates;
+
+    void computeView(GridPosition origin, Unigine::Vector<int>& out);
+    bool hasLineOfSight(int x0, int y0, int x1, int y1) const;
+    void addView(int faction, const Unigine::Vector<int>& cells);
+    void releaseView(int faction, const Unigine::Vector<int>& cells);
+    void updateViewer(int index, int faction, GridPosition pos);
+};
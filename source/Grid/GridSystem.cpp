@@ -1,5 +1,8 @@
 // GridSystem.cpp
 #include "GridSystem.h"
+#include "../Core/CombatHistory.h"
+#include "../Spells/AuraTracker.h"
+#include "FogOfWar.h"
 #include <UnigineLog.h>
 #include <UnigineNode.h>
 #include <cmath>
@@ -7,17 +10,24 @@
 GridSystem::GridSystem(int width, int height)
     : grid_width(width)
     , grid_height(height)
+    , version(0)
+    , history(nullptr)
+    , auras(nullptr)
+    , fog(nullptr)
 {
     Unigine::Log::message("GridSystem::GridSystem() - Creating %dx%d grid\n", width, height);
 
     // Allocate cells (flat array for cache efficiency)
     cells.resize(width * height);
+    cell_dirty.resize(width * height);
+    dirty_cells.reserve(64);
 
     // Initialize cells
     for (int y = 0; y < grid_height; y++) {
         for (int x = 0; x < grid_width; x++) {
             int index = getIndex(x, y);
             cells[index] = GridCell(GridPosition(x, y, 0)); // All start at ground level
+            cell_dirty[index] = 0;
         }
     }
 
@@ -32,6 +42,19 @@ int GridSystem::getIndex(int x, int y) const {
     return y * grid_width + x;
 }
 
+void GridSystem::markDirty(int index) {
+    if (cell_dirty[index]) return;
+    cell_dirty[index] = 1;
+    dirty_cells.append(index);
+}
+
+void GridSystem::clearDirtyCells() {
+    for (int i = 0; i < dirty_cells.size(); i++) {
+        cell_dirty[dirty_cells[i]] = 0;
+    }
+    dirty_cells.clear();
+}
+
 GridCell* GridSystem::getCell(int x, int y) {
     if (!isValidPosition(x, y)) {
         return nullptr;
@@ -43,6 +66,13 @@ GridCell* GridSystem::getCell(GridPosition pos) {
     return getCell(pos.x, pos.y);
 }
 
+const GridCell* GridSystem::getCell(int x, int y) const {
+    if (!isValidPosition(x, y)) {
+        return nullptr;
+    }
+    return &cells[getIndex(x, y)];
+}
+
 bool GridSystem::isValidPosition(int x, int y) const {
     return x >= 0 && x < grid_width && y >= 0 && y < grid_height;
 }
@@ -65,29 +95,49 @@ bool GridSystem::isBlocked(GridPosition pos) const {
 void GridSystem::setElevation(int x, int y, int elevation) {
     GridCell* cell = getCell(x, y);
     if (cell) {
+        if (history) history->record(DeltaType::CELL_ELEVATION, getIndex(x, y), cell->elevation, elevation);
         cell->elevation = elevation;
         cell->position.z = elevation;
+        markDirty(getIndex(x, y));
+        version++;
     }
 }
 
 void GridSystem::setBlocked(int x, int y, bool blocked) {
     GridCell* cell = getCell(x, y);
     if (cell) {
+        if (history) history->record(DeltaType::CELL_BLOCKED, getIndex(x, y), cell->blocked, blocked);
         cell->blocked = blocked;
+        markDirty(getIndex(x, y));
+        version++;
     }
 }
 
 void GridSystem::setOccupant(GridPosition pos, Unigine::NodePtr unit) {
     GridCell* cell = getCell(pos);
     if (cell) {
+        if (history) {
+            history->record(DeltaType::CELL_OCCUPANT, getIndex(pos.x, pos.y),
+                cell->occupant ? cell->occupant->getID() : 0, unit ? unit->getID() : 0);
+        }
         cell->occupant = unit;
+        markDirty(getIndex(pos.x, pos.y));
+        version++;
+
+        if (auras && unit) auras->onUnitMoved(unit->getID(), pos);
+        if (fog && unit) fog->onUnitMoved(unit->getID(), pos);
     }
 }
 
 void GridSystem::clearOccupant(GridPosition pos) {
     GridCell* cell = getCell(pos);
     if (cell) {
+        if (history && cell->occupant) {
+            history->record(DeltaType::CELL_OCCUPANT, getIndex(pos.x, pos.y), cell->occupant->getID(), 0);
+        }
         cell->occupant = nullptr;
+        markDirty(getIndex(pos.x, pos.y));
+        version++;
     }
 }
 
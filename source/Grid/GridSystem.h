@@ -11,6 +11,10 @@ namespace Unigine {
     class Node;
 }
 
+class CombatHistory;
+class AuraTracker;
+class FogOfWar;
+
 class GridSystem {
 public:
     GridSystem(int width, int height);
@@ -19,6 +23,7 @@ public:
     // Grid queries
     GridCell* getCell(int x, int y);
     GridCell* getCell(GridPosition pos);
+    const GridCell* getCell(int x, int y) const;
     bool isValidPosition(int x, int y) const;
     bool isValidPosition(GridPosition pos) const;
     bool isBlocked(GridPosition pos) const;
@@ -37,11 +42,40 @@ public:
     int getDistance(GridPosition a, GridPosition b) const;
     int getElevationDifference(GridPosition a, GridPosition b) const;
 
+    // State version: bumped on every modification (used to detect stale AI plans, caches)
+    unsigned int getVersion() const { return version; }
+
+    // Cells changed (elevation, blocked, occupant) since the last clearDirtyCells(), each listed once.
+    // Consumed once per frame (GameManager::postUpdate) so visuals cost O(changed cells).
+    const Unigine::Vector<int>& getDirtyCells() const { return dirty_cells; }  // y * width + x
+    void clearDirtyCells();
+
+    // List a cell for redraw when only its look changed (fog of war); does not bump the version
+    void markCellDirty(int x, int y) { markDirty(getIndex(x, y)); }
+
+    // Optional undo recorder (nullptr = not recording)
+    void setHistory(CombatHistory* recorder) { history = recorder; }
+
+    // Optional aura membership tracker, told about every unit placed by setOccupant (nullptr = none)
+    void setAuraTracker(AuraTracker* tracker) { auras = tracker; }
+
+    // Optional fog of war, told about every unit placed by setOccupant (nullptr = none)
+    void setFogOfWar(FogOfWar* fog_of_war) { fog = fog_of_war; }
+
 private:
     int grid_width;
     int grid_height;
+    unsigned int version;
+    CombatHistory* history;
+    AuraTracker* auras;
+    FogOfWar* fog;
     Unigine::Vector<GridCell> cells; // Flat array: index = y * width + x
+    Unigine::Vector<int> dirty_cells;
+    Unigine::Vector<unsigned char> cell_dirty; // 1 = already in dirty_cells
 
     // Helper: convert 2D coords to 1D index
     int getIndex(int x, int y) const;
+
+    // Helper: add a cell to the dirty list (once per frame)
+    void markDirty(int index);
 };
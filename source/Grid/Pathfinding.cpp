@@ -0,0 +1,200 @@
+// Pathfinding.cpp
+#include "Pathfinding.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Arena.h"
+#include "../Core/PerfMonitor.h"
+#include <queue>
+#include <vector>
+#include <climits>
+
+namespace {
+    // Search state: cell index * 2 + diagonal parity (0 = next diagonal costs 5ft, 1 = costs 10ft)
+    struct OpenNode {
+        int cost;
+        int state;
+
+        bool operator>(const OpenNode& other) const { return cost > other.cost; }
+    };
+
+    typedef std::priority_queue<OpenNode, ArenaVector<OpenNode>, std::greater<OpenNode> > OpenQueue;
+
+    const int NEIGHBOR_DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int NEIGHBOR_DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+    // Search buffers live in the calling thread's scratch arena (callers hold an Arena::Scope)
+    ArenaAllocator<int> scratchInts() {
+        return ArenaAllocator<int>(&Arena::getThreadScratch(), MemorySystem::PATHING);
+    }
+
+    // Dijkstra over (cell, parity) states. Stops expanding beyond max_feet, or once
+    // goal_index is settled (goal_index = -1 searches everything in range).
+    void search(const GridView& view, int start_index, int goal_index, int max_feet,
+                ArenaVector<int>& best_cost, ArenaVector<int>& parent_state)
+    {
+        const int num_states = view.width * view.height * 2;
+        best_cost.assign(num_states, INT_MAX);
+        parent_state.assign(num_states, -1);
+
+        ArenaVector<OpenNode> open_nodes(ArenaAllocator<OpenNode>(&Arena::getThreadScratch(), MemorySystem::PATHING));
+        open_nodes.reserve(num_states / 4 + 8);
+        OpenQueue open(std::greater<OpenNode>(), std::move(open_nodes));
+        best_cost[start_index * 2] = 0;
+        open.push({ 0, start_index * 2 });
+
+        while (!open.empty()) {
+            OpenNode current = open.top();
+            open.pop();
+
+            if (current.cost > best_cost[current.state]) continue; // Stale entry
+
+            const int cell = current.state / 2;
+            const int parity = current.state % 2;
+            if (cell == goal_index) return;
+
+            const int x = cell % view.width;
+            const int y = cell / view.width;
+            const int elevation = view.elevation[cell];
+
+            for (int i = 0; i < 8; i++) {
+                const int nx = x + NEIGHBOR_DX[i];
+                const int ny = y + NEIGHBOR_DY[i];
+                if (!view.isValid(nx, ny)) continue;
+
+                const int next = view.getIndex(nx, ny);
+                if (view.blocked[next]) continue;
+                if (view.elevation[next] > elevation) continue; // Upward movement requires Climb
+
+                const bool diagonal = i >= 4;
+                if (diagonal) {
+                    // No corner cutting past impassable cells
+                    if (view.blocked[view.getIndex(nx, y)] || view.blocked[view.getIndex(x, ny)]) continue;
+                }
+
+                const int step = (diagonal && parity == 1) ? Pathfinding::SQUARE_FEET * 2 : Pathfinding::SQUARE_FEET;
+                const int next_parity = diagonal ? 1 - parity : parity;
+                const int next_cost = current.cost + step;
+                if (next_cost > max_feet) continue;
+
+                const int next_state = next * 2 + next_parity;
+                if (next_cost < best_cost[next_state]) {
+                    best_cost[next_state] = next_cost;
+                    parent_state[next_state] = current.state;
+                    open.push({ next_cost, next_state });
+                }
+            }
+        }
+    }
+
+    // Cheaper of the two parity states for a cell
+    int bestState(const ArenaVector<int>& best_cost, int cell) {
+        return best_cost[cell * 2] <= best_cost[cell * 2 + 1] ? cell * 2 : cell * 2 + 1;
+    }
+}
+
+void Pathfinding::computeReachable(const GridView& view, GridPosition start, int max_feet,
+                                   Unigine::Vector<ReachableCell>& out_cells)
+{
+    out_cells.clear();
+    if (!view.isValid(start.x, start.y)) return;
+
+    // Searches on job workers are part of their job's time (AI_WORKERS): only the main
+    // thread's count against the pathing budget
+    PerfScope perf(PerfSystem::PATHING, !JobSystem::isWorkerThread());
+    PerfMonitor::get()->count(PerfCounter::PATHS_COMPUTED);
+
+    Arena::Scope scratch(Arena::getThreadScratch());
+    ArenaVector<int> best_cost(scratchInts());
+    ArenaVector<int> parent_state(scratchInts());
+    search(view, view.getIndex(start.x, start.y), -1, max_feet, best_cost, parent_state);
+
+    const int num_cells = view.width * view.height;
+    for (int cell = 0; cell < num_cells; cell++) {
+        const int state = bestState(best_cost, cell);
+        if (best_cost[state] == INT_MAX) continue;
+
+        const int parent = parent_state[state];
+        out_cells.append(ReachableCell(cell, best_cost[state], parent >= 0 ? parent / 2 : -1));
+    }
+}
+
+void Pathfinding::computeReachableBatch(JobSystem* jobs, const GridView& view, const Unigine::Vector<GridPosition>& starts,
+                                        int max_feet, Unigine::Vector<Unigine::Vector<ReachableCell>>& out_cells)
+{
+    out_cells.resize(starts.size());
+
+    // Each search only reads the view and writes its own result slot
+    auto body = [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            computeReachable(view, starts[i], max_feet, out_cells[i]);
+        }
+    };
+
+    if (jobs) {
+        jobs->parallelFor(jobs->getSystemId("Pathfinding"), 0, starts.size(), 1, body);
+    } else {
+        body(0, starts.size());
+    }
+}
+
+bool Pathfinding::findPath(const GridView& view, GridPosition start, GridPosition goal,
+                           Unigine::Vector<GridPosition>& out_path, int* out_cost)
+{
+    out_path.clear();
+    if (!view.isValid(start.x, start.y) || !view.isValid(goal.x, goal.y)) return false;
+
+    PerfScope perf(PerfSystem::PATHING, !JobSystem::isWorkerThread());
+    PerfMonitor::get()->count(PerfCounter::PATHS_COMPUTED);
+
+    const int start_index = view.getIndex(start.x, start.y);
+    const int goal_index = view.getIndex(goal.x, goal.y);
+
+    Arena::Scope scratch(Arena::getThreadScratch());
+    ArenaVector<int> best_cost(scratchInts());
+    ArenaVector<int> parent_state(scratchInts());
+    search(view, start_index, goal_index, INT_MAX, best_cost, parent_state);
+
+    const int goal_state = bestState(best_cost, goal_index);
+    if (best_cost[goal_state] == INT_MAX) return false;
+
+    // Walk parent states back to the start, then reverse
+    for (int state = goal_state; state >= 0; state = parent_state[state]) {
+        const int cell = state / 2;
+        out_path.append(GridPosition(cell % view.width, cell / view.width, view.elevation[cell]));
+    }
+    for (int i = 0, j = out_path.size() - 1; i < j; i++, j--) {
+        GridPosition temp = out_path[i];
+        out_path[i] = out_path[j];
+        out_path[j] = temp;
+    }
+
+    if (out_cost) *out_cost = best_cost[goal_state];
+    return true;
+}
+
+void Pathfinding::buildPath(const GridView& view, const Unigine::Vector<ReachableCell>& cells,
+                            int goal_index, Unigine::Vector<GridPosition>& out_path)
+{
+    out_path.clear();
+
+    // Index the result by cell for parent lookups
+    Arena::Scope scratch(Arena::getThreadScratch());
+    ArenaVector<int> slot(view.width * view.height, -1, scratchInts());
+    for (int i = 0; i < cells.size(); i++) {
+        slot[cells[i].index] = i;
+    }
+
+    for (int cell = goal_index; cell >= 0 && slot[cell] >= 0; cell = cells[slot[cell]].parent) {
+        out_path.append(GridPosition(cell % view.width, cell / view.width, view.elevation[cell]));
+    }
+    for (int i = 0, j = out_path.size() - 1; i < j; i++, j--) {
+        GridPosition temp = out_path[i];
+        out_path[i] = out_path[j];
+        out_path[j] = temp;
+    }
+}
+
+int Pathfinding::getStrideCount(int cost_feet, int speed_feet) {
+    if (cost_feet <= 0) return 0;
+    if (speed_feet <= 0) return INT_MAX;
+    return (cost_feet + speed_feet - 1) / speed_feet;
+}
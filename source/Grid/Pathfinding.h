@@ -0,0 +1,59 @@
+// Pathfinding.h
+// Stride reachability and shortest paths with PF2e movement rules
+// Works on plain per-cell arrays (GridView) so it can run off the main thread
+
+#pragma once
+
+#include "GridCell.h"
+#include <UnigineVector.h>
+
+class JobSystem;
+
+// Read-only view over flat per-cell arrays (index = y * width + x)
+struct GridView {
+    int width;
+    int height;
+    const unsigned char* blocked;   // 1 = impassable for Stride (terrain or occupant)
+    const int* elevation;           // Elevation level per cell
+
+    GridView() : width(0), height(0), blocked(nullptr), elevation(nullptr) {}
+
+    bool isValid(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    int getIndex(int x, int y) const { return y * width + x; }
+};
+
+// A cell reached by a Stride search
+struct ReachableCell {
+    int index;      // Cell index (y * width + x)
+    int cost;       // Cheapest movement cost in feet
+    int parent;     // Previous cell index on the cheapest path (-1 for the start cell)
+
+    ReachableCell() : index(-1), cost(0), parent(-1) {}
+    ReachableCell(int _index, int _cost, int _parent) : index(_index), cost(_cost), parent(_parent) {}
+};
+
+namespace Pathfinding {
+    const int SQUARE_FEET = 5;      // One square of movement
+
+    // All cells reachable from start within max_feet of movement.
+    // Rules: 5-5-10 diagonals, free descent, no upward movement (requires Climb).
+    // The start cell is always included with cost 0.
+    void computeReachable(const GridView& view, GridPosition start, int max_feet,
+                          Unigine::Vector<ReachableCell>& out_cells);
+
+    // computeReachable() for many start cells at once (threat maps, AI lookahead), one search
+    // per start spread over the job workers. out_cells[i] belongs to starts[i]. Sequential if jobs is nullptr.
+    void computeReachableBatch(JobSystem* jobs, const GridView& view, const Unigine::Vector<GridPosition>& starts,
+                               int max_feet, Unigine::Vector<Unigine::Vector<ReachableCell>>& out_cells);
+
+    // Cheapest path from start to goal (inclusive). Returns false if unreachable.
+    bool findPath(const GridView& view, GridPosition start, GridPosition goal,
+                  Unigine::Vector<GridPosition>& out_path, int* out_cost = nullptr);
+
+    // Rebuild a path (start..goal) from a computeReachable() result
+    void buildPath(const GridView& view, const Unigine::Vector<ReachableCell>& cells,
+                   int goal_index, Unigine::Vector<GridPosition>& out_path);
+
+    // Number of Stride actions needed to cover cost_feet at the given Speed
+    int getStrideCount(int cost_feet, int speed_feet);
+}
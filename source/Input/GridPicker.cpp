@@ -0,0 +1,129 @@
+// GridPicker.cpp
+#include "GridPicker.h"
+#include "../Components/GridConfigComponent.h"
+#include "../Components/UnitComponent.h"
+#include <UnigineComponentSystem.h>
+#include <cmath>
+#include <cfloat>
+
+using namespace Unigine;
+using namespace Unigine::Math;
+
+GridPicker::GridPicker(GridSystem* grid_system, GridConfigComponent* grid_config)
+    : grid(grid_system)
+    , config(grid_config)
+{
+}
+
+double GridPicker::getCellTop(int x, int y) const {
+    const GridCell* cell = grid->getCell(x, y);
+    return (cell ? cell->elevation : 0) * (double)config->elevation_height + config->tile_height_offset;
+}
+
+GridPickResult GridPicker::pick(const dvec3& origin, const vec3& direction, double max_distance) const {
+    GridPickResult result;
+
+    const double cell_size = config->cell_size;
+    if (cell_size <= 0.0) return result;
+
+    // Grid space: cell (x, y) covers [x, x + 1) x [y, y + 1) (gridToWorld puts cell centres on multiples of cell_size)
+    const double ox = origin.x / cell_size + 0.5;
+    const double oy = origin.y / cell_size + 0.5;
+    const double dx = direction.x / cell_size;
+    const double dy = direction.y / cell_size;
+    const double dz = direction.z;
+
+    const double length = sqrt((double)direction.x * direction.x + (double)direction.y * direction.y + (double)direction.z * direction.z);
+    if (length <= 0.0) return result;
+    double t_max = max_distance / length;
+
+    // Clip the ray to the grid rectangle (slab test in x and y)
+    double t_min = 0.0;
+    const double lo[2] = { 0.0, 0.0 };
+    const double hi[2] = { (double)grid->getWidth(), (double)grid->getHeight() };
+    const double o[2] = { ox, oy };
+    const double d[2] = { dx, dy };
+    for (int axis = 0; axis < 2; axis++) {
+        if (fabs(d[axis]) < 1e-12) {
+            if (o[axis] < lo[axis] || o[axis] >= hi[axis]) return result;
+            continue;
+        }
+        double t0 = (lo[axis] - o[axis]) / d[axis];
+        double t1 = (hi[axis] - o[axis]) / d[axis];
+        if (t0 > t1) { double tmp = t0; t0 = t1; t1 = tmp; }
+        if (t0 > t_min) t_min = t0;
+        if (t1 < t_max) t_max = t1;
+    }
+    if (t_min > t_max) return result;
+
+    // Starting cell, clamped to the grid: at the far boundary the entry point floors to width / height
+    const double start_x = ox + dx * t_min;
+    const double start_y = oy + dy * t_min;
+    int x = (int)floor(start_x);
+    int y = (int)floor(start_y);
+    if (x >= grid->getWidth()) x = grid->getWidth() - 1;
+    if (y >= grid->getHeight()) y = grid->getHeight() - 1;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+
+    // DDA setup (Amanatides & Woo): ray parameter at the next x / y cell boundary
+    const int step_x = dx > 0.0 ? 1 : -1;
+    const int step_y = dy > 0.0 ? 1 : -1;
+    const double delta_x = fabs(dx) > 1e-12 ? fabs(1.0 / dx) : DBL_MAX;
+    const double delta_y = fabs(dy) > 1e-12 ? fabs(1.0 / dy) : DBL_MAX;
+    double next_x = fabs(dx) > 1e-12 ? ((dx > 0.0 ? x + 1 : x) - ox) / dx : DBL_MAX;
+    double next_y = fabs(dy) > 1e-12 ? ((dy > 0.0 ? y + 1 : y) - oy) / dy : DBL_MAX;
+
+    double t_enter = t_min;
+    const int max_steps = grid->getWidth() + grid->getHeight() + 2;
+
+    for (int step = 0; step < max_steps; step++) {
+        const double t_exit = next_x < next_y ? (next_x < t_max ? next_x : t_max) : (next_y < t_max ? next_y : t_max);
+        const double top = getCellTop(x, y);
+        const double z_enter = origin.z + dz * t_enter;
+        const double z_exit = origin.z + dz * t_exit;
+
+        double t_hit = -1.0;
+        if (z_enter <= top) {
+            // Entered below the top: the ray hits the side of a raised cell
+            t_hit = t_enter;
+        } else if (z_exit <= top && dz < 0.0) {
+            // Crosses the top surface inside this cell
+            t_hit = (top - origin.z) / dz;
+        }
+
+        if (t_hit >= 0.0) {
+            result.hit = true;
+            result.cell = GridPosition(x, y, grid->getCell(x, y)->elevation);
+            result.point = origin + dvec3(direction.x * t_hit, direction.y * t_hit, direction.z * t_hit);
+            result.distance = t_hit * length;
+            return result;
+        }
+
+        if (t_exit >= t_max) break;
+
+        // Advance to the neighbouring cell across the nearer boundary
+        t_enter = t_exit;
+        if (next_x < next_y) {
+            x += step_x;
+            next_x += delta_x;
+        } else {
+            y += step_y;
+            next_y += delta_y;
+        }
+        if (!grid->isValidPosition(x, y)) break;
+    }
+
+    return result;
+}
+
+UnitComponent* GridPicker::pickUnit(const dvec3& origin, const vec3& direction, double max_distance) const {
+    GridPickResult result = pick(origin, direction, max_distance);
+    return result.hit ? getUnitAt(result.cell) : nullptr;
+}
+
+UnitComponent* GridPicker::getUnitAt(GridPosition pos) const {
+    const GridCell* cell = grid->getCell(pos.x, pos.y);
+    if (!cell || !cell->occupant) return nullptr;
+    return ComponentSystem::get()->getComponent<UnitComponent>(cell->occupant);
+}
@@ -0,0 +1,45 @@
+// GridPicker.h
+// Analytic mouse picking against the grid (no physics, no collision geometry)
+// Inverts GridRenderer::gridToWorld: the camera ray is marched cell by cell with a 2D DDA
+// through the elevation heightfield, and the first cell top (or raised cell side) it meets
+// is the hovered cell. Units are resolved through cell occupancy.
+
+#pragma once
+
+#include "../Grid/GridSystem.h"
+#include <UnigineMathLib.h>
+
+class GridConfigComponent;
+class UnitComponent;
+
+struct GridPickResult {
+    bool hit;
+    GridPosition cell;
+    Unigine::Math::dvec3 point;     // Where the ray meets the cell
+    double distance;                // World units from the ray origin to point
+
+    GridPickResult() : hit(false), distance(0.0) {}
+};
+
+class GridPicker {
+public:
+    GridPicker(GridSystem* grid_system, GridConfigComponent* grid_config);
+
+    // March a world-space ray; 'direction' need not be normalized
+    GridPickResult pick(const Unigine::Math::dvec3& origin, const Unigine::Math::vec3& direction,
+                        double max_distance = 1000.0) const;
+
+    // Unit standing on the picked cell (nullptr if none)
+    UnitComponent* pickUnit(const Unigine::Math::dvec3& origin, const Unigine::Math::vec3& direction,
+                            double max_distance = 1000.0) const;
+
+    // Unit occupying a cell (nullptr if empty)
+    UnitComponent* getUnitAt(GridPosition pos) const;
+
+private:
+    GridSystem* grid;
+    GridConfigComponent* config;
+
+    // Height of a cell's top surface (tiles are drawn tile_height_offset above the elevation)
+    double getCellTop(int x, int y) const;
+};
@@ -1,4 +1,5 @@
 #include "SelectionSystem.h"
+#include "GridPicker.h"
 #include <UnigineGame.h>
 #include <UnigineInput.h>
 #include <UnigineWorld.h>
@@ -17,6 +18,8 @@ SelectionSystem::SelectionSystem()
 	: selectedUnit(nullptr)
 	, selectionIndicator(nullptr)
 	, previousMouseButtonState(false)
+	, picker(nullptr)
+	, hoveredCellValid(false)
 {
 }
 
@@ -38,6 +41,7 @@ void SelectionSystem::init()
 
 void SelectionSystem::update()
 {
+	updateHoveredCell();
 	handleMouseInput();
 	updateIndicatorPosition();
 }
@@ -108,8 +112,40 @@ void SelectionSystem::updateIndicatorPosition()
 	}
 }
 
+void SelectionSystem::updateHoveredCell()
+{
+	hoveredCellValid = false;
+
+	PlayerPtr player = Game::getPlayer();
+	if (!picker || !player)
+	{
+		return;
+	}
+
+	// Camera ray through the mouse, marched through the grid heightfield (no physics)
+	ivec2 mouse = Input::getMousePosition();
+	GridPickResult result = picker->pick(player->getWorldPosition(), player->getDirectionFromMainWindow(mouse.x, mouse.y));
+	if (result.hit)
+	{
+		hoveredCell = result.cell;
+		hoveredCellValid = true;
+	}
+}
+
 UnitComponent* SelectionSystem::raycastForUnit()
 {
+	// Grid picking: the unit is whoever occupies the hovered cell
+	if (picker && hoveredCellValid)
+	{
+		UnitComponent* unit = picker->getUnitAt(hoveredCell);
+		if (unit)
+		{
+			return unit;
+		}
+	}
+
+	// Units not registered on the grid yet (before combat starts): physics raycast, clicks only
+
 	// Get the active camera/player
 	PlayerPtr player = Game::getPlayer();
 	if (!player)
@@ -5,6 +5,9 @@
 #include <UnigineGame.h>
 #include <UnigineObjects.h>
 #include "../Components/UnitComponent.h"
+#include "../Grid/GridCell.h"
+
+class GridPicker;
 
 namespace Unigine
 {
@@ -29,6 +32,13 @@ namespace Unigine
 		// Clear current selection
 		void clearSelection();
 
+		// Analytic grid picking (nullptr = physics raycast fallback, no hover cell)
+		void setGridPicker(GridPicker* grid_picker) { picker = grid_picker; }
+
+		// Cell under the mouse this frame (updated every update() when a picker is set)
+		bool hasHoveredCell() const { return hoveredCellValid; }
+		GridPosition getHoveredCell() const { return hoveredCell; }
+
 	private:
 		// Currently selected unit
 		UnitComponent* selectedUnit;
@@ -39,6 +49,14 @@ namespace Unigine
 		// Previous mouse button state for one-shot detection
 		bool previousMouseButtonState;
 
+		// Grid picking
+		GridPicker* picker;
+		GridPosition hoveredCell;
+		bool hoveredCellValid;
+
+		// Pick the hovered cell from the mouse ray
+		void updateHoveredCell();
+
 		// Create the visual selection indicator
 		void createSelectionIndicator();
 
@@ -0,0 +1,177 @@
+// AuraTracker.cpp
+#include "AuraTracker.h"
+#include "../Grid/GridSystem.h"
+#include "../Core/CombatantTable.h"
+#include "../Components/UnitComponent.h"
+
+namespace {
+    const int FEET_PER_CELL = 5;
+
+    int findMember(const Unigine::Vector<int>& members, int node) {
+        for (int i = 0; i < members.size(); i++) {
+            if (members[i] == node) return i;
+        }
+        return -1;
+    }
+}
+
+AuraTracker::AuraTracker(GridSystem* grid_system, EffectTable* effect_table)
+    : grid(grid_system)
+    , effects(effect_table)
+    , events(0)
+    , tests(0)
+{
+}
+
+void AuraTracker::addAura(int source, int spell, GridPosition origin, int radius_feet, SpellFilter filter,
+                          unsigned char faction, EffectKind kind, int value, int rounds)
+{
+    for (int i = 0; i < auras.size(); i++) {
+        Aura& existing = auras[i];
+        if (existing.source == source && existing.spell == spell && existing.kind == kind) {
+            existing.rounds = rounds;
+            return;
+        }
+    }
+
+    Aura aura;
+    aura.source = source;
+    aura.spell = spell;
+    aura.origin = origin;
+    aura.radius_feet = radius_feet;
+    aura.filter = filter;
+    aura.faction = faction;
+    aura.kind = kind;
+    aura.value = value;
+    aura.rounds = rounds;
+    auras.append(aura);
+
+    rescan(auras.last());
+}
+
+void AuraTracker::removeSpell(int source, int spell) {
+    for (int i = auras.size() - 1; i >= 0; i--) {
+        if (auras[i].source == source && auras[i].spell == spell) removeAura(i);
+    }
+}
+
+void AuraTracker::clear() {
+    for (int i = auras.size() - 1; i >= 0; i--) {
+        removeAura(i);
+    }
+}
+
+void AuraTracker::restore(const Aura& aura) {
+    auras.append(aura);
+}
+
+void AuraTracker::removeUnit(int node) {
+    for (int i = auras.size() - 1; i >= 0; i--) {
+        Aura& aura = auras[i];
+        if (aura.source == node) {
+            removeAura(i);
+            continue;
+        }
+        const int member = findMember(aura.members, node);
+        if (member >= 0) leave(aura, member);
+    }
+}
+
+int AuraTracker::startTurn(int source) {
+    int ended = 0;
+    for (int i = auras.size() - 1; i >= 0; i--) {
+        Aura& aura = auras[i];
+        if (aura.source != source || aura.rounds == 0) continue;
+        if (--aura.rounds == 0) {
+            removeAura(i);
+            ended++;
+        }
+    }
+    return ended;
+}
+
+void AuraTracker::onUnitMoved(int node, GridPosition pos) {
+    for (int i = 0; i < auras.size(); i++) {
+        Aura& aura = auras[i];
+
+        // The origin moved: the whole area is re-evaluated around it
+        if (aura.source == node) {
+            aura.origin = pos;
+            rescan(aura);
+            continue;
+        }
+
+        const bool inside = accepts(aura, node, pos);
+        const int member = findMember(aura.members, node);
+        if (inside && member < 0) enter(aura, node);
+        else if (!inside && member >= 0) leave(aura, member);
+    }
+}
+
+bool AuraTracker::isInside(int node, int source, int spell) const {
+    for (int i = 0; i < auras.size(); i++) {
+        const Aura& aura = auras[i];
+        if (aura.source == source && aura.spell == spell && findMember(aura.members, node) >= 0) return true;
+    }
+    return false;
+}
+
+bool AuraTracker::accepts(const Aura& aura, int node, GridPosition pos) {
+    tests++;
+    if (grid->getDistance(aura.origin, pos) > aura.radius_feet) return false;
+
+    const CombatantTable* table = CombatantTable::get();
+    const int row = table->findRow(node);
+    if (row < 0 || table->component[row]->pooled) return false;
+    return matchesFilter(aura.filter, aura.faction, table->faction[row]);
+}
+
+void AuraTracker::enter(Aura& aura, int node) {
+    aura.members.append(node);
+    events++;
+
+    ActiveEffect effect;
+    effect.target = node;
+    effect.source = aura.source;
+    effect.spell = aura.spell;
+    effect.kind = aura.kind;
+    effect.value = aura.value;
+    effect.rounds = 0;      // Lasts while inside; the aura's own rounds end it
+    effects->add(effect);
+}
+
+void AuraTracker::leave(Aura& aura, int member_index) {
+    effects->remove(aura.members[member_index], aura.source, aura.spell, aura.kind);
+    aura.members.removeFast(member_index);
+    events++;
+}
+
+void AuraTracker::rescan(Aura& aura) {
+    // Only the cells within the radius: cost follows the aura's area, not the unit count
+    const int reach = aura.radius_feet / FEET_PER_CELL;
+    scan.clear();
+    for (int y = aura.origin.y - reach; y <= aura.origin.y + reach; y++) {
+        for (int x = aura.origin.x - reach; x <= aura.origin.x + reach; x++) {
+            const GridCell* cell = grid->getCell(x, y);
+            if (!cell || !cell->occupant) continue;
+
+            const int node = cell->occupant->getID();
+            if (accepts(aura, node, GridPosition(x, y))) scan.append(node);
+        }
+    }
+
+    for (int i = aura.members.size() - 1; i >= 0; i--) {
+        if (findMember(scan, aura.members[i]) < 0) leave(aura, i);
+    }
+    for (int i = 0; i < scan.size(); i++) {
+        if (findMember(aura.members, scan[i]) < 0) enter(aura, scan[i]);
+    }
+}
+
+void AuraTracker::removeAura(int index) {
+    Aura& aura = auras[index];
+    for (int i = aura.members.size() - 1; i >= 0; i--) {
+        leave(aura, i);
+    }
+    auras.remove(index);
+}
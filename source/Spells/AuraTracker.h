@@ -0,0 +1,88 @@
+// AuraTracker.h
+// Incremental membership for emanation auras (Bless) that move with their caster
+// Membership changes only when a unit is placed by GridSystem::setOccupant: a moved unit is
+// tested against each aura, a moved aura origin rescans the cells within its radius. Entering
+// and leaving add and remove the aura's effect in the EffectTable, so rules queries stay plain
+// lookups and an aura-heavy fight costs O(moves), not O(auras x units) per query.
+
+#pragma once
+
+#include "EffectTable.h"
+#include "SpellProgram.h"
+#include "../Grid/GridCell.h"
+#include <UnigineVector.h>
+
+class GridSystem;
+
+struct Aura {
+    int source;                 // Node ID of the origin unit (the caster)
+    int spell;                  // SpellSystem spell index
+    GridPosition origin;
+    int radius_feet;
+    SpellFilter filter;
+    unsigned char faction;      // Source faction when cast (Faction)
+    EffectKind kind;            // Effect granted while inside
+    int value;
+    int rounds;                 // Remaining source turns, 0 = until removed
+    Unigine::Vector<int> members;   // Node IDs inside
+
+    Aura()
+        : source(0)
+        , spell(-1)
+        , radius_feet(0)
+        , filter(SpellFilter::ANY)
+        , faction(0)
+        , kind(EffectKind::STATUS_ATTACK)
+        , value(0)
+        , rounds(0)
+    {}
+};
+
+class AuraTracker {
+public:
+    AuraTracker(GridSystem* grid_system, EffectTable* effect_table);
+
+    // Start an aura at the source's cell (an existing aura of the same spell and effect is
+    // refreshed instead). Units already inside enter immediately.
+    void addAura(int source, int spell, GridPosition origin, int radius_feet, SpellFilter filter,
+                 unsigned char faction, EffectKind kind, int value, int rounds);
+
+    // End auras (every member leaves)
+    void removeSpell(int source, int spell);
+    void clear();
+
+    // Append a saved aura as-is, members included (CombatSerializer). Their effects are
+    // restored with the EffectTable, so nothing is entered or rescanned.
+    void restore(const Aura& aura);
+
+    // A unit left the grid: it leaves every aura and its own auras end
+    void removeUnit(int node);
+
+    // Count down auras of 'source'. Returns the number that ended.
+    int startTurn(int source);
+
+    // GridSystem::setOccupant hook
+    void onUnitMoved(int node, GridPosition pos);
+
+    bool isInside(int node, int source, int spell) const;
+    int getNumAuras() const { return auras.size(); }
+    const Aura& getAura(int index) const { return auras[index]; }
+
+    // Enter/leave events and membership tests since creation (cost tracking)
+    int getEventCount() const { return events; }
+    int getTestCount() const { return tests; }
+
+private:
+    GridSystem* grid;
+    EffectTable* effects;
+    Unigine::Vector<Aura> auras;
+    Unigine::Vector<int> scan;      // Rescan scratch (members found at the new origin)
+    int events;
+    int tests;
+
+    bool accepts(const Aura& aura, int node, GridPosition pos);
+    void enter(Aura& aura, int node);
+    void leave(Aura& aura, int member_index);
+    void rescan(Aura& aura);
+    void removeAura(int index);
+};
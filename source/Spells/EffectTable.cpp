@@ -0,0 +1,107 @@
+// EffectTable.cpp
+#include "EffectTable.h"
+
+namespace {
+    const int OFF_GUARD_PENALTY = -2;
+}
+
+void EffectTable::add(const ActiveEffect& effect) {
+    for (int i = 0; i < effects.size(); i++) {
+        ActiveEffect& existing = effects[i];
+        if (existing.target == effect.target && existing.source == effect.source &&
+            existing.spell == effect.spell && existing.kind == effect.kind) {
+            existing = effect;
+            return;
+        }
+    }
+    effects.append(effect);
+}
+
+int EffectTable::removeSpell(int source, int spell) {
+    int removed = 0;
+    for (int i = effects.size() - 1; i >= 0; i--) {
+        if (effects[i].source == source && effects[i].spell == spell) {
+            effects.removeFast(i);
+            removed++;
+        }
+    }
+    return removed;
+}
+
+void EffectTable::removeUnit(int node) {
+    for (int i = effects.size() - 1; i >= 0; i--) {
+        if (effects[i].target == node || effects[i].source == node) effects.removeFast(i);
+    }
+}
+
+void EffectTable::removeKind(int target, EffectKind kind) {
+    for (int i = effects.size() - 1; i >= 0; i--) {
+        if (effects[i].target == target && effects[i].kind == kind) effects.removeFast(i);
+    }
+}
+
+void EffectTable::remove(int target, int source, int spell, EffectKind kind) {
+    for (int i = 0; i < effects.size(); i++) {
+        const ActiveEffect& effect = effects[i];
+        if (effect.target == target && effect.source == source && effect.spell == spell && effect.kind == kind) {
+            effects.removeFast(i);
+            return;
+        }
+    }
+}
+
+bool EffectTable::has(int target, EffectKind kind) const {
+    for (int i = 0; i < effects.size(); i++) {
+        if (effects[i].target == target && effects[i].kind == kind) return true;
+    }
+    return false;
+}
+
+bool EffectTable::hasSpell(int source, int spell, EffectKind kind) const {
+    for (int i = 0; i < effects.size(); i++) {
+        if (effects[i].source == source && effects[i].spell == spell && effects[i].kind == kind) return true;
+    }
+    return false;
+}
+
+int EffectTable::getModifier(int target, EffectKind kind) const {
+    int bonus = 0;
+    int penalty = 0;
+    for (int i = 0; i < effects.size(); i++) {
+        const ActiveEffect& effect = effects[i];
+        if (effect.target != target || effect.kind != kind) continue;
+        if (effect.value > bonus) bonus = effect.value;
+        if (effect.value < penalty) penalty = effect.value;
+    }
+    return bonus + penalty;
+}
+
+int EffectTable::getArmorClassModifier(int target) const {
+    const bool off_guard = has(target, EffectKind::OFF_GUARD) || has(target, EffectKind::PRONE);
+    return getModifier(target, EffectKind::STATUS_AC) + (off_guard ? OFF_GUARD_PENALTY : 0);
+}
+
+int EffectTable::startTurn(int source) {
+    int expired = 0;
+    for (int i = effects.size() - 1; i >= 0; i--) {
+        ActiveEffect& effect = effects[i];
+        if (effect.source != source || effect.rounds == 0) continue;
+        if (--effect.rounds == 0) {
+            effects.removeFast(i);
+            expired++;
+        }
+    }
+    return expired;
+}
+
+const char* EffectTable::getName(EffectKind kind) {
+    switch (kind) {
+    case EffectKind::PRONE: return "prone";
+    case EffectKind::OFF_GUARD: return "off_guard";
+    case EffectKind::INVISIBLE: return "invisible";
+    case EffectKind::STATUS_ATTACK: return "status_attack";
+    case EffectKind::STATUS_AC: return "status_ac";
+    case EffectKind::SUSTAINED: return "sustained";
+    default: return "unknown";
+    }
+}
@@ -0,0 +1,76 @@
+// EffectTable.h
+// Active spell effects on units: conditions (Prone, Invisible) and status modifiers (Bless)
+// One flat list of small records; rules query it by node ID. Durations count down at the
+// start of the source's turn, so an effect cast with 1 round lasts through every other unit's
+// next turn (PF2e durations are measured from the caster's turns).
+
+#pragma once
+
+#include <UnigineVector.h>
+
+enum class EffectKind : unsigned char {
+    PRONE,          // Off-guard, must Stand
+    OFF_GUARD,      // -2 circumstance penalty to AC
+    INVISIBLE,      // Undetected/hidden to enemies
+    STATUS_ATTACK,  // Status bonus/penalty to attack rolls (Bless +1)
+    STATUS_AC,      // Status bonus/penalty to AC
+    SUSTAINED,      // Marker on the caster: a sustained spell is active (value unused)
+    COUNT
+};
+
+struct ActiveEffect {
+    int target;             // Node ID the effect is on
+    int source;             // Node ID of the caster
+    int spell;              // SpellSystem spell index (-1 = not from a spell)
+    EffectKind kind;
+    int value;              // Modifier (0 for plain conditions)
+    int rounds;             // Remaining source turns, 0 = until removed
+
+    ActiveEffect()
+        : target(0)
+        , source(0)
+        , spell(-1)
+        , kind(EffectKind::PRONE)
+        , value(0)
+        , rounds(0)
+    {}
+};
+
+class EffectTable {
+public:
+    // Add or refresh: the same kind from the same spell and source on a target is replaced
+    void add(const ActiveEffect& effect);
+
+    // Remove every effect of a spell cast by source (dismiss, sustain lapsed). Returns the count.
+    int removeSpell(int source, int spell);
+
+    // Remove everything on or from a unit (death, despawn)
+    void removeUnit(int node);
+
+    // Remove one kind of effect from a target (e.g. Stand removes PRONE)
+    void removeKind(int target, EffectKind kind);
+
+    // Remove the effect one spell of 'source' put on 'target' (left an aura)
+    void remove(int target, int source, int spell, EffectKind kind);
+
+    void clear() { effects.clear(); }
+
+    bool has(int target, EffectKind kind) const;
+    bool hasSpell(int source, int spell, EffectKind kind) const;
+
+    // Same-type bonuses do not stack (PF2e): highest bonus plus lowest penalty
+    int getModifier(int target, EffectKind kind) const;
+
+    // AC penalty from off-guard sources (Prone, Off-Guard)
+    int getArmorClassModifier(int target) const;
+
+    // Count down effects cast by 'source' and drop the expired ones. Returns the number expired.
+    int startTurn(int source);
+
+    const Unigine::Vector<ActiveEffect>& getEffects() const { return effects; }
+
+    static const char* getName(EffectKind kind);
+
+private:
+    Unigine::Vector<ActiveEffect> effects;
+};
@@ -0,0 +1,361 @@
+// SpellProgram.cpp
+#include "SpellProgram.h"
+#include "../Core/CombatRules.h"
+#include "../Data/DataLoader.h"
+#include "../Data/StringPool.h"
+#include <UnigineLog.h>
+#include <cstring>
+
+using namespace Unigine;
+
+namespace {
+    const int DEFAULT_ACTIONS = 2;
+
+    unsigned char degreeBit(DegreeOfSuccess degree) {
+        return (unsigned char)(1 << (int)degree);
+    }
+
+    // Outcome names in data are from the side that rolls: the caster for attacks, the target for saves
+    bool parseOutcome(const char* name, bool target_rolls, unsigned char& out_bit) {
+        DegreeOfSuccess degree;
+        if (!strcmp(name, "critical_failure")) degree = DegreeOfSuccess::CRITICAL_FAILURE;
+        else if (!strcmp(name, "failure")) degree = DegreeOfSuccess::FAILURE;
+        else if (!strcmp(name, "success")) degree = DegreeOfSuccess::SUCCESS;
+        else if (!strcmp(name, "critical_success")) degree = DegreeOfSuccess::CRITICAL_SUCCESS;
+        else return false;
+
+        if (target_rolls) degree = (DegreeOfSuccess)(3 - (int)degree);
+        out_bit = degreeBit(degree);
+        return true;
+    }
+
+    bool parseEffect(const char* name, EffectKind& out_kind) {
+        for (int i = 0; i < (int)EffectKind::COUNT; i++) {
+            if (!strcmp(name, EffectTable::getName((EffectKind)i))) {
+                out_kind = (EffectKind)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseSave(const char* name, SpellSave& out_save) {
+        if (!strcmp(name, "fortitude") || !strcmp(name, "fort")) out_save = SpellSave::FORTITUDE;
+        else if (!strcmp(name, "reflex")) out_save = SpellSave::REFLEX;
+        else if (!strcmp(name, "will")) out_save = SpellSave::WILL;
+        else return false;
+        return true;
+    }
+}
+
+SpellProgram::SpellProgram()
+    : id("")
+    , name("")
+    , damage_type("")
+    , rank(0)
+    , actions(DEFAULT_ACTIONS)
+    , range_feet(0)
+    , targeting(SpellTargeting::CREATURES)
+    , filter(SpellFilter::ANY)
+    , max_targets(1)
+    , radius_feet(0)
+    , sustained(false)
+    , aura(false)
+    , duration(0)
+    , first_instruction(0)
+    , num_instructions(0)
+{
+}
+
+DiceExpr SpellInstruction::getDice(int base_rank, int cast_rank) const {
+    DiceExpr result = dice;
+    if (heighten_interval == 0) return result;
+
+    // Cantrips heighten from rank 1
+    const int from = base_rank > 1 ? base_rank : 1;
+    const int steps = cast_rank > from ? (cast_rank - from) / heighten_interval : 0;
+    result.count += heighten_dice.count * steps;
+    result.bonus += heighten_dice.bonus * steps;
+    return result;
+}
+
+void SpellTargetBatch::clear() {
+    row.clear();
+    node.clear();
+    armor_class.clear();
+    for (int i = 0; i < (int)SpellSave::COUNT; i++) save[i].clear();
+    natural.clear();
+    margin.clear();
+    degree.clear();
+    hp_delta.clear();
+    effects.clear();
+}
+
+int SpellTargetBatch::add(int table_row, int node_id, int ac, int fortitude, int reflex, int will) {
+    row.append(table_row);
+    node.append(node_id);
+    armor_class.append(ac);
+    save[(int)SpellSave::FORTITUDE].append(fortitude);
+    save[(int)SpellSave::REFLEX].append(reflex);
+    save[(int)SpellSave::WILL].append(will);
+    natural.append(0);
+    margin.append(0);
+    degree.append((unsigned char)DegreeOfSuccess::SUCCESS);    // No check: full effect
+    hp_delta.append(0);
+    return node.size() - 1;
+}
+
+bool SpellCompiler::compile(const JsonPtr& json, StringPool& strings, SpellProgram& out_program,
+                            Vector<SpellInstruction>& code)
+{
+    const char* id = DataLoader::readString(json, "id", "");
+    if (id[0] == '\0') return false;
+
+    SpellProgram program;
+    program.id = strings.intern(id);
+    program.name = strings.intern(DataLoader::readString(json, "name", id));
+    program.rank = DataLoader::readInt(json, "rank", program.rank);
+    program.actions = DataLoader::readInt(json, "actions", program.actions);
+    program.range_feet = DataLoader::readInt(json, "range", program.range_feet);
+    program.sustained = DataLoader::readBool(json, "sustained", false);
+    program.duration = DataLoader::readInt(json, "duration", program.duration);
+
+    // Targeting: an area, the caster, or a number of chosen creatures
+    JsonPtr area = DataLoader::getChild(json, "area");
+    if (area) {
+        const char* type = DataLoader::readString(area, "type", "burst");
+        if (!strcmp(type, "burst")) program.targeting = SpellTargeting::BURST;
+        else if (!strcmp(type, "emanation")) program.targeting = SpellTargeting::EMANATION;
+        else {
+            Log::warning("SpellCompiler::compile() - '%s': unknown area type '%s'\n", id, type);
+            return false;
+        }
+        program.radius_feet = DataLoader::readInt(area, "radius", 5);
+    } else if (!strcmp(DataLoader::readString(json, "target", ""), "self")) {
+        program.targeting = SpellTargeting::SELF;
+    } else {
+        program.max_targets = DataLoader::readInt(json, "targets", 1);
+    }
+
+    // Auras apply their effects through AuraTracker membership, so they cannot have a check
+    program.aura = DataLoader::readBool(json, "aura", false);
+    if (program.aura && (program.targeting != SpellTargeting::EMANATION ||
+                         DataLoader::getChild(json, "save") || DataLoader::readBool(json, "attack", false))) {
+        Log::warning("SpellCompiler::compile() - '%s': an aura must be an emanation without a check\n", id);
+        return false;
+    }
+
+    const char* affects = DataLoader::readString(json, "affects", "any");
+    if (!strcmp(affects, "allies")) program.filter = SpellFilter::ALLIES;
+    else if (!strcmp(affects, "enemies")) program.filter = SpellFilter::ENEMIES;
+
+    // Heightening applies to the spell's main dice (damage, else healing)
+    unsigned char heighten_interval = 0;
+    DiceExpr heighten_dice;
+    JsonPtr heightening = DataLoader::getChild(json, "heightening");
+    if (heightening) {
+        const char* type = DataLoader::readString(heightening, "type", "interval");
+        heighten_interval = (unsigned char)(strcmp(type, "per_rank") == 0 ? 1 : DataLoader::readInt(heightening, "interval", 1));
+        if (!DiceExpr::parse(DataLoader::readString(heightening, "dice", ""), heighten_dice)) {
+            Log::warning("SpellCompiler::compile() - '%s': heightening needs \"dice\"\n", id);
+            return false;
+        }
+    }
+
+    Vector<SpellInstruction> ops;
+
+    // Check: spell attack or saving throw (at most one)
+    const bool attack = DataLoader::readBool(json, "attack", false);
+    JsonPtr save = DataLoader::getChild(json, "save");
+    if (attack && save) {
+        Log::warning("SpellCompiler::compile() - '%s': both an attack and a save\n", id);
+        return false;
+    }
+    JsonPtr damage = DataLoader::getChild(json, "damage");
+    bool basic_save = false;
+
+    if (attack) {
+        SpellInstruction check;
+        check.op = SpellOp::ROLL_ATTACK;
+        ops.append(check);
+    } else if (save) {
+        SpellSave save_type;
+        const char* type = DataLoader::readString(save, "type", "");
+        if (!parseSave(type, save_type)) {
+            Log::warning("SpellCompiler::compile() - '%s': unknown save '%s'\n", id, type);
+            return false;
+        }
+        SpellInstruction check;
+        check.op = SpellOp::ROLL_SAVE;
+        check.arg = (unsigned char)save_type;
+        ops.append(check);
+
+        // Damage with a save is a basic save unless the data says otherwise
+        basic_save = DataLoader::readBool(save, "basic", damage != nullptr);
+    }
+
+    bool heightened = false;
+    if (damage) {
+        SpellInstruction op;
+        op.op = SpellOp::DAMAGE;
+        op.arg = basic_save ? 1 : 0;
+        op.degrees = basic_save ? SpellDegree::ANY : SpellDegree::HIT;
+        const char* dice = DataLoader::readString(damage, "dice", "");
+        if (!DiceExpr::parse(dice, op.dice)) {
+            Log::warning("SpellCompiler::compile() - '%s': bad damage dice '%s'\n", id, dice);
+            return false;
+        }
+        op.heighten_interval = heighten_interval;
+        op.heighten_dice = heighten_dice;
+        heightened = heighten_interval > 0;
+        program.damage_type = strings.intern(DataLoader::readString(damage, "type", ""));
+        ops.append(op);
+    }
+
+    JsonPtr healing = DataLoader::getChild(json, "healing");
+    if (healing) {
+        SpellInstruction op;
+        op.op = SpellOp::HEAL;
+        const char* dice = DataLoader::readString(healing, "dice", "");
+        if (!DiceExpr::parse(dice, op.dice)) {
+            Log::warning("SpellCompiler::compile() - '%s': bad healing dice '%s'\n", id, dice);
+            return false;
+        }
+        if (!heightened) {
+            op.heighten_interval = heighten_interval;
+            op.heighten_dice = heighten_dice;
+            heightened = heighten_interval > 0;
+        }
+        ops.append(op);
+    }
+
+    if (heighten_interval > 0 && !heightened) {
+        Log::warning("SpellCompiler::compile() - '%s': heightening without damage or healing\n", id);
+    }
+
+    // Conditions and modifiers; by default on a failed save / hit, or always without a check
+    const unsigned char default_degrees = attack || save ? SpellDegree::HIT : SpellDegree::ANY;
+    JsonPtr effects = DataLoader::getChild(json, "effects");
+    for (int i = 0; effects && effects->isArray() && i < effects->getNumChildren(); i++) {
+        JsonPtr entry = effects->getChild(i);
+
+        SpellInstruction op;
+        op.op = SpellOp::APPLY_EFFECT;
+        EffectKind kind;
+        const char* name = DataLoader::readString(entry, "effect", "");
+        if (!parseEffect(name, kind)) {
+            Log::warning("SpellCompiler::compile() - '%s': unknown effect '%s'\n", id, name);
+            return false;
+        }
+        op.arg = (unsigned char)kind;
+        op.value = DataLoader::readInt(entry, "value", 0);
+        op.duration = DataLoader::readInt(entry, "duration", program.duration);
+        op.degrees = default_degrees;
+
+        JsonPtr on = DataLoader::getChild(entry, "on");
+        if (on && on->isArray()) {
+            op.degrees = 0;
+            for (int j = 0; j < on->getNumChildren(); j++) {
+                unsigned char bit = 0;
+                JsonPtr outcome = on->getChild(j);
+                if (!outcome->isString() || !parseOutcome(outcome->getString(), save != nullptr, bit)) {
+                    Log::warning("SpellCompiler::compile() - '%s': bad outcome in effect '%s'\n", id, name);
+                    return false;
+                }
+                op.degrees |= bit;
+            }
+        }
+        ops.append(op);
+    }
+
+    if (ops.size() == 0) {
+        Log::warning("SpellCompiler::compile() - '%s' has no effect\n", id);
+        return false;
+    }
+
+    program.first_instruction = code.size();
+    program.num_instructions = ops.size();
+    for (int i = 0; i < ops.size(); i++) {
+        code.append(ops[i]);
+    }
+
+    out_program = program;
+    return true;
+}
+
+void SpellInterpreter::execute(const SpellProgram& program, const SpellInstruction* code, int spell_index,
+                               const SpellCaster& caster, int cast_rank, CombatRandom& rng, SpellTargetBatch& batch)
+{
+    const int count = batch.size();
+    unsigned char* degree = batch.degree.get();
+    int* natural = batch.natural.get();
+    int* margin = batch.margin.get();
+    int* hp_delta = batch.hp_delta.get();
+
+    for (int pc = 0; pc < program.num_instructions; pc++) {
+        const SpellInstruction& op = code[program.first_instruction + pc];
+
+        switch (op.op) {
+        case SpellOp::ROLL_ATTACK: {
+            const int bonus = caster.spell_attack + caster.attack_modifier;
+            const int* armor_class = batch.armor_class.get();
+            rng.rollDice(20, natural, count);
+            for (int i = 0; i < count; i++) {
+                margin[i] = natural[i] + bonus - armor_class[i];
+            }
+            CombatRules::getDegreesOfSuccess(margin, natural, count, degree);
+            break;
+        }
+        case SpellOp::ROLL_SAVE: {
+            // The target rolls; the degree is stored from the spell's side
+            const int* bonus = batch.save[op.arg].get();
+            rng.rollDice(20, natural, count);
+            for (int i = 0; i < count; i++) {
+                margin[i] = natural[i] + bonus[i] - caster.spell_dc;
+            }
+            CombatRules::getDegreesOfSuccess(margin, natural, count, degree);
+            for (int i = 0; i < count; i++) {
+                degree[i] = (unsigned char)((int)DegreeOfSuccess::CRITICAL_SUCCESS - degree[i]);
+            }
+            break;
+        }
+        case SpellOp::DAMAGE: {
+            // One roll for every target (PF2e area damage). Critical doubles the dice, not the
+            // modifier (GDD rule, as DiceExpr::rollCritical); basic saves halve on a success.
+            const DiceExpr dice = op.getDice(program.rank, cast_rank);
+            const int rolled = DiceExpr(dice.count, dice.sides).roll(rng);
+            const int full = rolled + dice.bonus > 0 ? rolled + dice.bonus : 0;
+            const int critical = rolled * 2 + dice.bonus > 0 ? rolled * 2 + dice.bonus : 0;
+
+            int by_degree[4] = { 0, 0, full, critical };
+            if (op.arg) by_degree[(int)DegreeOfSuccess::FAILURE] = full / 2;
+
+            for (int i = 0; i < count; i++) {
+                if (op.degrees & (1 << degree[i])) hp_delta[i] -= by_degree[degree[i]];
+            }
+            break;
+        }
+        case SpellOp::HEAL: {
+            const int amount = op.getDice(program.rank, cast_rank).roll(rng);
+            for (int i = 0; i < count; i++) {
+                if (op.degrees & (1 << degree[i])) hp_delta[i] += amount;
+            }
+            break;
+        }
+        case SpellOp::APPLY_EFFECT: {
+            ActiveEffect effect;
+            effect.source = caster.node;
+            effect.spell = spell_index;
+            effect.kind = (EffectKind)op.arg;
+            effect.value = op.value;
+            effect.rounds = op.duration;
+            for (int i = 0; i < count; i++) {
+                if (!(op.degrees & (1 << degree[i]))) continue;
+                effect.target = batch.node[i];
+                batch.effects.append(effect);
+            }
+            break;
+        }
+        }
+    }
+}
@@ -0,0 +1,151 @@
+// SpellProgram.h
+// Spells compiled from data into compact effect programs, and the interpreter that runs them
+// A program is a short list of instructions (check, damage, healing, effects) stored in one
+// flat code array; each instruction runs over the whole target batch before the next starts,
+// so an AoE over many targets is one tight loop per instruction. Adding a spell is a data
+// change only. Interpretation is a pure function of its inputs and the CombatRandom stream.
+
+#pragma once
+
+#include "EffectTable.h"
+#include "../Core/CombatRandom.h"
+#include "../Core/Dice.h"
+#include <UnigineVector.h>
+#include <UnigineJson.h>
+
+class StringPool;
+
+enum class SpellTargeting : unsigned char {
+    SELF,           // The caster
+    CREATURES,      // Up to max_targets chosen creatures within range
+    BURST,          // Every creature within radius of a cell within range
+    EMANATION       // Every creature within radius of the caster (caster included)
+};
+
+// Which creatures an area or target list accepts, relative to the caster's faction
+enum class SpellFilter : unsigned char {
+    ANY,
+    ALLIES,
+    ENEMIES
+};
+
+// Does a creature of target_faction pass the filter of a caster of caster_faction (Faction values)
+inline bool matchesFilter(SpellFilter filter, unsigned char caster_faction, unsigned char target_faction) {
+    switch (filter) {
+    case SpellFilter::ALLIES: return target_faction == caster_faction;
+    case SpellFilter::ENEMIES: return target_faction != caster_faction && target_faction != 0;   // 0 = Faction::NONE
+    default: return true;
+    }
+}
+
+enum class SpellOp : unsigned char {
+    ROLL_ATTACK,    // Spell attack per target vs AC -> degree
+    ROLL_SAVE,      // Target save vs spell DC -> degree (stored from the spell's side)
+    DAMAGE,         // One damage roll, scaled per target by degree (basic save or attack)
+    HEAL,           // One healing roll, applied to every target
+    APPLY_EFFECT    // Condition / modifier on targets whose degree is in the mask
+};
+
+enum class SpellSave : unsigned char {
+    FORTITUDE,
+    REFLEX,
+    WILL,
+    COUNT
+};
+
+// Degree masks (bit = DegreeOfSuccess of the spell against the target)
+namespace SpellDegree {
+    const unsigned char CRITICAL_FAILURE = 1 << 0;
+    const unsigned char FAILURE = 1 << 1;
+    const unsigned char SUCCESS = 1 << 2;
+    const unsigned char CRITICAL_SUCCESS = 1 << 3;
+    const unsigned char ANY = 0x0f;
+    const unsigned char HIT = SUCCESS | CRITICAL_SUCCESS;
+}
+
+struct SpellInstruction {
+    SpellOp op;
+    unsigned char arg;          // ROLL_SAVE: SpellSave; APPLY_EFFECT: EffectKind; DAMAGE: 1 = basic save scaling
+    unsigned char degrees;      // SpellDegree mask the instruction applies to
+    unsigned char heighten_interval;  // Ranks per heightening step (0 = none)
+    int value;                  // APPLY_EFFECT: modifier
+    int duration;               // APPLY_EFFECT: rounds (0 = until removed)
+    DiceExpr dice;              // DAMAGE / HEAL
+    DiceExpr heighten_dice;     // Added once per heightening step
+
+    SpellInstruction()
+        : op(SpellOp::DAMAGE)
+        , arg(0)
+        , degrees(SpellDegree::ANY)
+        , heighten_interval(0)
+        , value(0)
+        , duration(0)
+    {}
+
+    // Dice at a cast rank (base rank = the spell's own rank)
+    DiceExpr getDice(int base_rank, int cast_rank) const;
+};
+
+struct SpellProgram {
+    const char* id;             // Interned
+    const char* name;           // Interned
+    const char* damage_type;    // Interned ("" = none), for the log
+    int rank;                   // 0 = cantrip (auto-heightened to half the caster's level)
+    int actions;
+    int range_feet;             // 0 = touch / self
+    SpellTargeting targeting;
+    SpellFilter filter;
+    int max_targets;            // CREATURES only
+    int radius_feet;            // BURST / EMANATION
+    bool sustained;             // Can be Sustained for another application (Spiritual Weapon)
+    bool aura;                  // Emanation that moves with the caster (effects follow membership)
+    int duration;               // Rounds a sustained spell lasts
+
+    int first_instruction;      // Into SpellSystem's code array
+    int num_instructions;
+
+    SpellProgram();
+};
+
+// Per-target columns for one cast (index = target). The caller fills the defences, the
+// interpreter fills degree, hp_delta and effects. Columns keep their capacity across casts.
+struct SpellTargetBatch {
+    Unigine::Vector<int> row;                   // CombatantTable row (for the commit pass)
+    Unigine::Vector<int> node;
+    Unigine::Vector<int> armor_class;
+    Unigine::Vector<int> save[(int)SpellSave::COUNT];
+    Unigine::Vector<int> natural;               // d20 faces of the check (scratch)
+    Unigine::Vector<int> margin;                // Check total - DC (scratch)
+    Unigine::Vector<unsigned char> degree;      // DegreeOfSuccess of the spell
+    Unigine::Vector<int> hp_delta;              // Negative = damage, positive = healing
+    Unigine::Vector<ActiveEffect> effects;      // To add to the EffectTable (target, kind, value, rounds)
+
+    int size() const { return node.size(); }
+    void clear();
+    int add(int table_row, int node_id, int ac, int fortitude, int reflex, int will);
+};
+
+// The caster's side of a cast
+struct SpellCaster {
+    int node;
+    int spell_attack;
+    int spell_dc;
+    int attack_modifier;        // Status modifiers on the caster (Bless)
+
+    SpellCaster() : node(0), spell_attack(0), spell_dc(10), attack_modifier(0) {}
+};
+
+namespace SpellCompiler {
+    // Compile one spell object (GDD spell schema, see data/spells) and append its code.
+    // Strings go to 'strings'. Returns false (and appends nothing) on malformed data.
+    bool compile(const Unigine::JsonPtr& json, StringPool& strings, SpellProgram& out_program,
+                 Unigine::Vector<SpellInstruction>& code);
+}
+
+namespace SpellInterpreter {
+    // Run a program over the batch. cast_rank is the slot rank (heightening).
+    // Rolls come from rng in a fixed order: every target's d20 (in batch order) drawn in one
+    // block per check, then one roll per DAMAGE/HEAL.
+    void execute(const SpellProgram& program, const SpellInstruction* code, int spell_index,
+                 const SpellCaster& caster, int cast_rank, CombatRandom& rng, SpellTargetBatch& batch);
+}
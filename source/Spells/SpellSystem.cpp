@@ -0,0 +1,337 @@
+// SpellSystem.cpp
+#include "SpellSystem.h"
+#include "../Grid/GridSystem.h"
+#include "../Core/TurnManager.h"
+#include "../Core/CombatHistory.h"
+#include "../Core/CombatantTable.h"
+#include "../Core/CombatRules.h"
+#include "../Components/UnitComponent.h"
+#include "../Data/DataLoader.h"
+#include <UnigineLog.h>
+#include <UnigineString.h>
+
+using namespace Unigine;
+
+namespace {
+    const int SUSTAIN_ACTIONS = 1;
+    const int TOUCH_RANGE_FEET = 5;
+
+    const char* degree_names[] = { "critical failure", "failure", "success", "critical success" };
+}
+
+SpellSystem::SpellSystem(GridSystem* grid_system, TurnManager* turn_mgr, CombatHistory* recorder)
+    : grid(grid_system)
+    , turn_manager(turn_mgr)
+    , history(recorder)
+    , auras(grid_system, &effects)
+{
+    programs.reserve(16);
+    code.reserve(64);
+    grid->setAuraTracker(&auras);
+}
+
+SpellSystem::~SpellSystem() {
+    grid->setAuraTracker(nullptr);
+}
+
+bool SpellSystem::load(const char* path) {
+    JsonPtr json = DataLoader::loadJson(path);
+    JsonPtr spells = DataLoader::getChild(json, "spells");
+    if (!spells || !spells->isArray()) {
+        Log::error("SpellSystem::load() - '%s' has no \"spells\" array\n", path);
+        return false;
+    }
+
+    int loaded = 0;
+    for (int i = 0; i < spells->getNumChildren(); i++) {
+        JsonPtr entry = spells->getChild(i);
+
+        const char* id = DataLoader::readString(entry, "id", "");
+        if (id[0] == '\0') {
+            Log::warning("SpellSystem::load() - Spell #%d in '%s' has no id, skipped\n", i, path);
+            continue;
+        }
+        if (findSpell(id) != INVALID_ID) {
+            Log::warning("SpellSystem::load() - Duplicate spell id '%s' in '%s', skipped\n", id, path);
+            continue;
+        }
+
+        SpellProgram program;
+        if (!SpellCompiler::compile(entry, strings, program, code)) {
+            Log::warning("SpellSystem::load() - Spell '%s' in '%s' did not compile, skipped\n", id, path);
+            continue;
+        }
+        programs.append(program);
+        loaded++;
+    }
+
+    Log::message("SpellSystem::load() - %d spells from '%s' (%d total, %d instructions)\n",
+        loaded, path, programs.size(), code.size());
+    return true;
+}
+
+int SpellSystem::findSpell(const char* id) const {
+    const char* interned = strings.find(id);
+    if (!interned) return INVALID_ID;
+
+    for (int i = 0; i < programs.size(); i++) {
+        if (programs[i].id == interned) return i;
+    }
+    return INVALID_ID;
+}
+
+int SpellSystem::getDefaultRank(int spell, int caster_row) const {
+    const SpellProgram& program = programs[spell];
+    if (program.rank > 0) return program.rank;
+
+    const int level = CombatantTable::get()->getStats(caster_row).level;
+    return (level + 1) / 2;
+}
+
+bool SpellSystem::cast(int caster_row, int spell, int rank, GridPosition aim, const Vector<int>& targets) {
+    if (spell < 0 || spell >= programs.size()) return false;
+    return resolve(caster_row, spell, rank > 0 ? rank : getDefaultRank(spell, caster_row), false, aim, targets);
+}
+
+bool SpellSystem::sustain(int caster_row, int spell, GridPosition aim, const Vector<int>& targets) {
+    if (spell < 0 || spell >= programs.size()) return false;
+
+    const int caster_node = CombatantTable::get()->node_id[caster_row];
+    if (!isSustaining(caster_node, spell)) {
+        Log::warning("SpellSystem::sustain() - '%s' is not active\n", programs[spell].name);
+        return false;
+    }
+
+    // The marker holds the rank the spell was cast at
+    int rank = programs[spell].rank;
+    const Vector<ActiveEffect>& active = effects.getEffects();
+    for (int i = 0; i < active.size(); i++) {
+        if (active[i].source == caster_node && active[i].spell == spell && active[i].kind == EffectKind::SUSTAINED) {
+            rank = active[i].value;
+            break;
+        }
+    }
+    return resolve(caster_row, spell, rank, true, aim, targets);
+}
+
+bool SpellSystem::isSustaining(int caster_node, int spell) const {
+    return effects.hasSpell(caster_node, spell, EffectKind::SUSTAINED);
+}
+
+void SpellSystem::startTurn(int node) {
+    const int expired = effects.startTurn(node) + auras.startTurn(node);
+    if (expired > 0) {
+        Log::message("SpellSystem::startTurn() - %d spell effects from #%d expired\n", expired, node);
+    }
+}
+
+void SpellSystem::removeUnit(int node) {
+    auras.removeUnit(node);
+    effects.removeUnit(node);
+}
+
+void SpellSystem::endCombat() {
+    auras.clear();
+    effects.clear();
+}
+
+void SpellSystem::restoreEffects(const Vector<ActiveEffect>& saved_effects, const Vector<Aura>& saved_auras) {
+    endCombat();
+    for (int i = 0; i < saved_effects.size(); i++) {
+        effects.add(saved_effects[i]);
+    }
+    for (int i = 0; i < saved_auras.size(); i++) {
+        auras.restore(saved_auras[i]);
+    }
+}
+
+void SpellSystem::commitBatch(const SpellProgram& program, int caster_row, int rank, bool has_check) {
+    // One pass over the batch writing the table's HP column directly (what takeDamage/heal do
+    // per unit), then a single summary line instead of one log message per target
+    CombatantTable* table = CombatantTable::get();
+    const int* rows = batch.row.get();
+    const int* hp_delta = batch.hp_delta.get();
+    const unsigned char* degree = batch.degree.get();
+
+    int degrees[4] = { 0, 0, 0, 0 };
+    int damage = 0;
+    int healing = 0;
+    int defeated = 0;
+    for (int i = 0; i < batch.size(); i++) {
+        degrees[degree[i]]++;
+        if (hp_delta[i] == 0) continue;
+
+        const int row = rows[i];
+        const int max_hp = table->getStats(row).max_hp;
+        const int hp_before = table->current_hp[row];
+        int hp = hp_before + hp_delta[i];
+        if (hp < 0) hp = 0;
+        if (hp > max_hp) hp = max_hp;
+        if (hp == hp_before) continue;
+
+        table->current_hp[row] = hp;
+        table->markDirty(row);
+        if (history) history->record(DeltaType::UNIT_HP, batch.node[i], hp_before, hp);
+
+        if (hp < hp_before) {
+            damage += hp_before - hp;
+            if (hp == 0) defeated++;
+        } else {
+            healing += hp - hp_before;
+        }
+    }
+
+    String summary = String::format("%s casts %s (rank %d) on %d target%s",
+        table->component[caster_row]->unit_name.get(), program.name, rank, batch.size(), batch.size() == 1 ? "" : "s");
+    const char* separator = ":";
+    for (int d = (int)DegreeOfSuccess::CRITICAL_SUCCESS; has_check && d >= 0; d--) {
+        if (degrees[d] == 0) continue;
+        summary += String::format("%s %d %s", separator, degrees[d], degree_names[d]);
+        separator = ",";
+    }
+    if (damage > 0) summary += String::format("; %d %s damage", damage, program.damage_type[0] ? program.damage_type : "total");
+    if (healing > 0) summary += String::format("; %d HP healed", healing);
+    if (defeated > 0) summary += String::format("; %d defeated", defeated);
+    Log::message("%s\n", summary.get());
+}
+
+bool SpellSystem::acceptsTarget(const SpellProgram& program, int caster_row, int row) const {
+    const CombatantTable* table = CombatantTable::get();
+    if (table->current_hp[row] <= 0 || table->component[row]->pooled) return false;
+
+    return matchesFilter(program.filter, table->faction[caster_row], table->faction[row]);
+}
+
+void SpellSystem::addTarget(int row) {
+    const CombatantTable* table = CombatantTable::get();
+    const StatBlock& stats = table->getStats(row);
+    const int node = table->node_id[row];
+    batch.add(row, node, stats.armor_class + effects.getArmorClassModifier(node),
+        stats.fortitude, stats.reflex, stats.will);
+}
+
+bool SpellSystem::gatherTargets(const SpellProgram& program, int caster_row, GridPosition aim,
+                                const Vector<int>& targets)
+{
+    const CombatantTable* table = CombatantTable::get();
+    const GridPosition caster_pos = table->position[caster_row];
+    const int range = program.range_feet > 0 ? program.range_feet : TOUCH_RANGE_FEET;
+    batch.clear();
+
+    switch (program.targeting) {
+    case SpellTargeting::SELF:
+        addTarget(caster_row);
+        return true;
+
+    case SpellTargeting::CREATURES: {
+        if (targets.size() == 0 || targets.size() > program.max_targets) {
+            Log::warning("SpellSystem::cast() - '%s' takes 1-%d targets, got %d\n",
+                program.name, program.max_targets, targets.size());
+            return false;
+        }
+        for (int i = 0; i < targets.size(); i++) {
+            const int row = table->findRow(targets[i]);
+            if (row < 0 || !acceptsTarget(program, caster_row, row)) {
+                Log::warning("SpellSystem::cast() - #%d is not a valid target for '%s'\n", targets[i], program.name);
+                return false;
+            }
+            if (grid->getDistance(caster_pos, table->position[row]) > range) {
+                Log::warning("SpellSystem::cast() - #%d is out of range for '%s'\n", targets[i], program.name);
+                return false;
+            }
+            bool duplicate = false;
+            for (int j = 0; j < i; j++) duplicate |= targets[j] == targets[i];
+            if (!duplicate) addTarget(row);
+        }
+        return true;
+    }
+    case SpellTargeting::BURST:
+    case SpellTargeting::EMANATION: {
+        GridPosition center = caster_pos;
+        if (program.targeting == SpellTargeting::BURST) {
+            if (!grid->isValidPosition(aim) || grid->getDistance(caster_pos, aim) > range) {
+                Log::warning("SpellSystem::cast() - '%s' aimed out of range\n", program.name);
+                return false;
+            }
+            center = aim;
+        }
+
+        // One pass over the table: every creature in the area that the spell affects
+        for (int row = 0; row < table->size(); row++) {
+            if (grid->getDistance(center, table->position[row]) > program.radius_feet) continue;
+            if (acceptsTarget(program, caster_row, row)) addTarget(row);
+        }
+        return true;
+    }
+    }
+    return false;
+}
+
+bool SpellSystem::resolve(int caster_row, int spell, int rank, bool sustaining, GridPosition aim,
+                          const Vector<int>& targets)
+{
+    CombatantTable* table = CombatantTable::get();
+    if (caster_row < 0 || caster_row >= table->size()) return false;
+
+    const SpellProgram& program = programs[spell];
+    const int actions = sustaining ? SUSTAIN_ACTIONS : program.actions;
+    if (!turn_manager->canSpendActions(actions)) {
+        Log::warning("SpellSystem::cast() - '%s' needs %d actions\n", program.name, actions);
+        return false;
+    }
+    if (!gatherTargets(program, caster_row, aim, targets)) return false;
+
+    const SpellInstruction* program_code = code.get() + program.first_instruction;
+    const bool attack_roll = program.num_instructions > 0 && program_code[0].op == SpellOp::ROLL_ATTACK;
+
+    const StatBlock& stats = table->getStats(caster_row);
+    SpellCaster caster;
+    caster.node = table->node_id[caster_row];
+    caster.spell_attack = stats.spell_attack;
+    caster.spell_dc = stats.spell_dc;
+    caster.attack_modifier = effects.getModifier(caster.node, EffectKind::STATUS_ATTACK) +
+        (attack_roll ? turn_manager->getCurrentMAP() : 0);
+
+    SpellInterpreter::execute(program, code.get(), spell, caster, rank, turn_manager->getRandom(), batch);
+
+    // Commit: HP and actions are recorded as one step (closed to undo once the cast is done)
+    if (history) history->beginAction(program.name);
+
+    const bool has_check = attack_roll || (program.num_instructions > 0 && program_code[0].op == SpellOp::ROLL_SAVE);
+    commitBatch(program, caster_row, rank, has_check);
+
+    if (program.aura && !sustaining) {
+        // Effects follow membership: units inside now enter, later moves update incrementally
+        for (int pc = 0; pc < program.num_instructions; pc++) {
+            const SpellInstruction& op = program_code[pc];
+            if (op.op != SpellOp::APPLY_EFFECT) continue;
+            auras.addAura(caster.node, spell, table->position[caster_row], program.radius_feet, program.filter,
+                table->faction[caster_row], (EffectKind)op.arg, op.value, program.duration);
+        }
+    } else {
+        for (int i = 0; i < batch.effects.size(); i++) {
+            effects.add(batch.effects[i]);
+        }
+    }
+
+    // Sustaining does not extend the spell's duration
+    if (program.sustained && !sustaining) {
+        ActiveEffect marker;
+        marker.target = caster.node;
+        marker.source = caster.node;
+        marker.spell = spell;
+        marker.kind = EffectKind::SUSTAINED;
+        marker.value = rank;
+        marker.rounds = program.duration;
+        effects.add(marker);
+    }
+
+    turn_manager->spendActions(actions, attack_roll ? ActionType::SPELL_ATTACK : ActionType::SPELL_SAVE);
+    if (history) {
+        history->endAction();
+        // Effects and auras are not undo deltas, and checks and damage have been rolled:
+        // a cast cannot be taken back
+        history->commit();
+    }
+    return true;
+}
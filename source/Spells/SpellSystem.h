@@ -0,0 +1,92 @@
+// SpellSystem.h
+// Spell catalog compiled from data/spells/*.json, casting, and the spell effects in play
+// Casting gathers the targets into one SpellTargetBatch, runs the spell's program over it
+// (SpellInterpreter) and commits HP changes and effects in one pass with one combat-log line.
+// Aura spells (Bless) hand their effects to the AuraTracker, which follows unit moves.
+// Not yet part of replays or lockstep play (Lockstep.h): casts are not CombatCommands. A cast
+// is an undo barrier, like a Strike, so its rolls and effects are never taken back.
+
+#pragma once
+
+#include "SpellProgram.h"
+#include "EffectTable.h"
+#include "AuraTracker.h"
+#include "../Data/StringPool.h"
+#include "../Grid/GridCell.h"
+#include <UnigineVector.h>
+
+class GridSystem;
+class TurnManager;
+class CombatHistory;
+
+class SpellSystem {
+public:
+    static const int INVALID_ID = -1;
+
+    SpellSystem(GridSystem* grid_system, TurnManager* turn_mgr, CombatHistory* recorder);
+    ~SpellSystem();
+
+    // Compile every spell of a spells file ({"spells": [...]}, GDD schema). Returns false on error.
+    bool load(const char* path);
+
+    int findSpell(const char* id) const;
+    const SpellProgram& getSpell(int spell) const { return programs[spell]; }
+    int getNumSpells() const { return programs.size(); }
+    int getNumInstructions() const { return code.size(); }
+
+    // Slot rank used when none is given: the spell's rank; cantrips at half the caster's level
+    int getDefaultRank(int spell, int caster_row) const;
+
+    // Cast for the unit in CombatantTable row caster_row. 'aim' is the burst centre, 'targets'
+    // the chosen node IDs for CREATURES spells. rank <= 0 = getDefaultRank. Checks range,
+    // targets and actions; returns false (nothing rolled or spent) if the cast is not legal.
+    bool cast(int caster_row, int spell, int rank, GridPosition aim, const Unigine::Vector<int>& targets);
+
+    // Sustain an active sustained spell (1 action): its program runs again on new targets
+    bool sustain(int caster_row, int spell, GridPosition aim, const Unigine::Vector<int>& targets);
+    bool isSustaining(int caster_node, int spell) const;
+
+    // Durations count down at the start of the caster's turn
+    void startTurn(int node);
+
+    // Unit left the fight: drop its effects, its auras and the ones it was sustaining
+    void removeUnit(int node);
+
+    // Combat over: every effect and aura ends
+    void endCombat();
+
+    // Replace every effect and aura with saved ones (CombatSerializer::restore)
+    void restoreEffects(const Unigine::Vector<ActiveEffect>& saved_effects, const Unigine::Vector<Aura>& saved_auras);
+
+    const EffectTable& getEffects() const { return effects; }
+    EffectTable& getEffects() { return effects; }
+    const AuraTracker& getAuras() const { return auras; }
+
+private:
+    GridSystem* grid;
+    TurnManager* turn_manager;
+    CombatHistory* history;
+
+    Unigine::Vector<SpellProgram> programs;
+    Unigine::Vector<SpellInstruction> code;    // All programs' instructions, back to back
+    StringPool strings;
+
+    EffectTable effects;
+    AuraTracker auras;                         // Emanations following their caster (registered with the grid)
+    SpellTargetBatch batch;                    // Reused by every cast
+
+    // Fill 'batch' with the spell's targets. Returns false if the targets are not legal.
+    bool gatherTargets(const SpellProgram& program, int caster_row, GridPosition aim,
+                       const Unigine::Vector<int>& targets);
+    bool acceptsTarget(const SpellProgram& program, int caster_row, int row) const;
+    void addTarget(int row);
+
+    // Apply the batch's HP deltas to the table in one pass and log one summary line
+    void commitBatch(const SpellProgram& program, int caster_row, int rank, bool has_check);
+
+    bool resolve(int caster_row, int spell, int rank, bool sustaining, GridPosition aim,
+                 const Unigine::Vector<int>& targets);
+
+    SpellSystem(const SpellSystem&) = delete;
+    SpellSystem& operator=(const SpellSystem&) = delete;
+};
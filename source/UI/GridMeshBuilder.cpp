@@ -0,0 +1,137 @@
+// GridMeshBuilder.cpp
+#include "GridMeshBuilder.h"
+
+GridMeshParams::GridMeshParams()
+    : cell_size(1.0f)
+    , elevation_height(1.0f)
+    , tile_size(0.9f)
+    , height_offset(0.1f)
+    , fog(nullptr)
+    , fog_brightness(0.4f)
+{
+    for (int i = 0; i < (int)GridPaletteEntry::COUNT; i++) {
+        palette[i][0] = palette[i][1] = palette[i][2] = 1.0f;
+        palette[i][3] = 1.0f;
+    }
+}
+
+namespace GridMeshBuilder {
+
+GridPaletteEntry getPaletteEntry(const GridCell& cell) {
+    if (cell.blocked) return GridPaletteEntry::BLOCKED;
+    if (cell.isOccupied()) return GridPaletteEntry::OCCUPIED;
+    return GridPaletteEntry::TILE;
+}
+
+int getNumChunks(int cells, int chunk_size) {
+    if (chunk_size <= 0) return cells > 0 ? 1 : 0;
+    return (cells + chunk_size - 1) / chunk_size;
+}
+
+void buildChunk(const GridSystem& grid, int x0, int y0, int width, int height, int block,
+                const GridMeshParams& params, GridChunkMesh& out) {
+    // Clamp to the grid
+    if (x0 + width > grid.getWidth()) width = grid.getWidth() - x0;
+    if (y0 + height > grid.getHeight()) height = grid.getHeight() - y0;
+    if (width < 0) width = 0;
+    if (height < 0) height = 0;
+    if (block < 1) block = 1;
+
+    out.x0 = x0;
+    out.y0 = y0;
+    out.width = width;
+    out.height = height;
+    out.block = block;
+    out.quads_x = (width + block - 1) / block;
+
+    const int quads_y = (height + block - 1) / block;
+    const int num_quads = out.quads_x * quads_y;
+    out.positions.resize(num_quads * 4 * 3);
+    out.colors.resize(num_quads * 4 * 4);
+    out.indices.resize(num_quads * 6);
+
+    int* index = out.indices.get();
+    int vertex = 0;
+
+    for (int y = y0; y < y0 + height; y += block) {
+        for (int x = x0; x < x0 + width; x += block) {
+            writeCell(grid, x, y, params, out);
+
+            *index++ = vertex;
+            *index++ = vertex + 1;
+            *index++ = vertex + 2;
+            *index++ = vertex;
+            *index++ = vertex + 2;
+            *index++ = vertex + 3;
+            vertex += 4;
+        }
+    }
+}
+
+bool writeCell(const GridSystem& grid, int x, int y, const GridMeshParams& params, GridChunkMesh& chunk) {
+    if (!chunk.contains(x, y)) return false;
+
+    // Block containing the cell (clipped at the chunk edge)
+    const int bx = x - (x - chunk.x0) % chunk.block;
+    const int by = y - (y - chunk.y0) % chunk.block;
+    const int bw = bx + chunk.block <= chunk.x0 + chunk.width ? chunk.block : chunk.x0 + chunk.width - bx;
+    const int bh = by + chunk.block <= chunk.y0 + chunk.height ? chunk.block : chunk.y0 + chunk.height - by;
+
+    int elevation = grid.getCell(bx, by)->elevation;
+    GridPaletteEntry entry = GridPaletteEntry::TILE;
+    bool visible = !params.fog;
+    bool explored = !params.fog;
+    const int faction = params.fog ? params.fog->getDisplayFaction() : 0;
+    for (int cy = by; cy < by + bh; cy++) {
+        for (int cx = bx; cx < bx + bw; cx++) {
+            const GridCell* cell = grid.getCell(cx, cy);
+            if (cell->elevation > elevation) elevation = cell->elevation;
+
+            const bool cell_visible = !params.fog || params.fog->isVisible(faction, cx, cy);
+            visible = visible || cell_visible;
+            explored = explored || cell_visible || params.fog->isExplored(faction, cx, cy);
+
+            // Blocked > occupied > tile. Occupants count only on cells the faction sees, so a
+            // coarse block does not show a unit hidden in one of its fogged cells.
+            GridPaletteEntry cell_entry = getPaletteEntry(*cell);
+            if (!cell_visible && cell_entry == GridPaletteEntry::OCCUPIED) cell_entry = GridPaletteEntry::TILE;
+            if (cell_entry == GridPaletteEntry::BLOCKED || entry == GridPaletteEntry::TILE) entry = cell_entry;
+        }
+    }
+
+    float scale = 1.0f;
+    if (!explored) {
+        entry = GridPaletteEntry::UNEXPLORED;
+    } else if (!visible) {
+        scale = params.fog_brightness;
+    }
+
+    // Quad spans the block minus the usual gap between tiles, centred on the block
+    const float gap = params.cell_size - params.tile_size;
+    const float half_x = (bw * params.cell_size - gap) * 0.5f;
+    const float half_y = (bh * params.cell_size - gap) * 0.5f;
+    const float cx = (bx - chunk.x0 + (bw - 1) * 0.5f) * params.cell_size;
+    const float cy = (by - chunk.y0 + (bh - 1) * 0.5f) * params.cell_size;
+    const float cz = elevation * params.elevation_height + params.height_offset;
+
+    // Corners counter-clockwise seen from above
+    const float corner_x[4] = { -half_x, half_x, half_x, -half_x };
+    const float corner_y[4] = { -half_y, -half_y, half_y, half_y };
+    const float* rgba = params.palette[(int)entry];
+
+    const int vertex = chunk.getCellVertex(x, y);
+    float* position = chunk.positions.get() + vertex * 3;
+    float* color = chunk.colors.get() + vertex * 4;
+    for (int c = 0; c < 4; c++) {
+        *position++ = cx + corner_x[c];
+        *position++ = cy + corner_y[c];
+        *position++ = cz;
+        *color++ = rgba[0] * scale;
+        *color++ = rgba[1] * scale;
+        *color++ = rgba[2] * scale;
+        *color++ = rgba[3];
+    }
+    return true;
+}
+
+} // namespace GridMeshBuilder
@@ -0,0 +1,72 @@
+// GridMeshBuilder.h
+// CPU-side vertex builder for the batched grid (no engine calls, usable headless)
+// One flat quad per cell, grouped into rectangular chunks. Colours come from a small
+// palette indexed by cell state, so the renderer needs one shared material per chunk
+// instead of a node and an inherited material per cell.
+
+#pragma once
+
+#include "../Grid/GridSystem.h"
+#include "../Grid/FogOfWar.h"
+#include <UnigineVector.h>
+
+// Cell state -> palette entry
+enum class GridPaletteEntry {
+    TILE,       // Walkable, empty
+    BLOCKED,    // Impassable terrain
+    OCCUPIED,   // Unit standing on the cell
+    UNEXPLORED, // Fog of war: never seen by the displayed faction
+    COUNT
+};
+
+struct GridMeshParams {
+    float cell_size;
+    float elevation_height;
+    float tile_size;        // Quad edge length (cell_size * tile_coverage)
+    float height_offset;    // Above the cell's elevation
+    float palette[(int)GridPaletteEntry::COUNT][4];  // RGBA per entry
+
+    // Fog of war (nullptr = everything visible). Explored cells out of sight keep their terrain
+    // colour scaled by fog_brightness and never show occupants.
+    const FogOfWar* fog;
+    float fog_brightness;
+
+    GridMeshParams();
+};
+
+// Vertex data of one chunk. Each quad covers block x block cells (1 = full detail, larger = far LOD);
+// cell (x, y) is drawn by the quad at vertices [getCellVertex(x, y), +4).
+struct GridChunkMesh {
+    int x0, y0;             // First cell of the chunk
+    int width, height;      // Cells in the chunk
+    int block;              // Cells per quad edge
+    int quads_x;            // Quads per row
+
+    Unigine::Vector<float> positions;   // xyz per vertex, chunk-local (relative to cell x0, y0)
+    Unigine::Vector<float> colors;      // rgba per vertex
+    Unigine::Vector<int> indices;       // Two triangles per quad
+
+    GridChunkMesh() : x0(0), y0(0), width(0), height(0), block(1), quads_x(0) {}
+
+    int getNumVertex() const { return positions.size() / 3; }
+    int getCellVertex(int x, int y) const { return (((y - y0) / block) * quads_x + (x - x0) / block) * 4; }
+    bool contains(int x, int y) const { return x >= x0 && x < x0 + width && y >= y0 && y < y0 + height; }
+};
+
+namespace GridMeshBuilder {
+    GridPaletteEntry getPaletteEntry(const GridCell& cell);
+
+    // Number of chunks along each axis for a chunk edge of 'chunk_size' cells
+    int getNumChunks(int cells, int chunk_size);
+
+    // Fill 'out' with the quads of cells [x0, x0 + width) x [y0, y0 + height), one quad per
+    // block x block cells. Reuses capacity.
+    void buildChunk(const GridSystem& grid, int x0, int y0, int width, int height, int block,
+                    const GridMeshParams& params, GridChunkMesh& out);
+
+    // Rewrite the quad drawing cell (x, y) from the current grid state: highest elevation and
+    // most restrictive state of its block (occupants of visible cells only), fogged only if no
+    // cell of the block is visible.
+    // Returns false if the cell is outside the chunk.
+    bool writeCell(const GridSystem& grid, int x, int y, const GridMeshParams& params, GridChunkMesh& chunk);
+}
@@ -1,5 +1,6 @@
 // GridRenderer.cpp
 #include "GridRenderer.h"
+#include "../Core/PerfMonitor.h"
 #include <UnigineLog.h>
 #include <UnigineWorld.h>
 #include <UnigineObjects.h>
@@ -8,14 +9,27 @@
 #include <UnigineGUID.h>
 
 #include "UnigineNodes.h"
+#include <cmath>
+#include <algorithm>
 
 using namespace Unigine;
 using namespace Unigine::Math;
 
+namespace {
+    // Chunk boxes for culling extend this many elevation levels up (conservative, no per-chunk scan)
+    const int CHUNK_BOX_LEVELS = 16;
+}
+
 GridRenderer::GridRenderer(GridSystem* grid_system, GridConfigComponent* grid_config)
     : grid(grid_system)
     , config(grid_config)
     , visible(true)
+    , visuals_next_cell(0)
+    , chunk_size(0)
+    , chunks_x(0)
+    , streaming_frame(0)
+    , highlight_generation(0)
+    , highlight_capacity(0)
 {
     Log::message("GridRenderer::GridRenderer() - Created with config: cell_size=%.2fm, coverage=%.0f%%\n",
         config->cell_size, config->tile_coverage * 100.0f);
@@ -26,11 +40,17 @@ GridRenderer::~GridRenderer() {
 }
 
 void GridRenderer::createGridVisuals() {
-    Log::message("GridRenderer::createGridVisuals() - Creating grid visuals for %dx%d grid\n",
+    beginGridVisuals();
+    createGridVisualsStep(grid->getWidth() * grid->getHeight());
+}
+
+void GridRenderer::beginGridVisuals() {
+    Log::message("GridRenderer::beginGridVisuals() - Creating grid visuals for %dx%d grid\n",
         grid->getWidth(), grid->getHeight());
 
     // Create root node to hold all grid visuals
     grid_root = NodeDummy::create();
+    PerfMonitor::get()->count(PerfCounter::NODES_CREATED);
     grid_root->setName("GridRoot");
     grid_root->setWorldPosition(dvec3(0, 0, 0));
     grid_root->setEnabled(true);
@@ -40,42 +60,78 @@ void GridRenderer::createGridVisuals() {
     World::getRootNodes(root_nodes);
     if (root_nodes.size() > 0) {
         root_nodes[0]->addChild(grid_root);
-        Log::message("GridRenderer::createGridVisuals() - Added grid_root as child of world root: %s\n",
+        Log::message("GridRenderer::beginGridVisuals() - Added grid_root as child of world root: %s\n",
             root_nodes[0]->getName());
     } else {
-        Log::error("GridRenderer::createGridVisuals() - No world root nodes found!\n");
+        Log::error("GridRenderer::beginGridVisuals() - No world root nodes found!\n");
     }
 
-    Log::message("GridRenderer::createGridVisuals() - Created grid_root (ID: %d, Enabled: %d)\n",
+    Log::message("GridRenderer::beginGridVisuals() - Created grid_root (ID: %d, Enabled: %d)\n",
         grid_root->getID(), grid_root->isEnabled());
-    Log::message("GridRenderer::createGridVisuals() - grid_root parent: %s, isWorld: %d\n",
+    Log::message("GridRenderer::beginGridVisuals() - grid_root parent: %s, isWorld: %d\n",
         grid_root->getParent() ? grid_root->getParent()->getName() : "NULL",
         grid_root->isWorld());
 
-    // Reserve space for cell nodes
+    // Persistent highlight overlay (both grid modes)
+    createHighlightMesh();
+
+    if (config->batched_grid) {
+        // Chunk layout and a fixed pool of meshes: nothing scales with the map here
+        createChunkMeshes();
+        visuals_next_cell = grid->getWidth() * grid->getHeight();
+        return;
+    }
+
+    // Reserve space for cell nodes (created by createGridVisualsStep)
     cell_nodes.reserve(grid->getWidth() * grid->getHeight());
+    visuals_next_cell = 0;
+}
 
-    // Create visual for each grid cell
-    for (int y = 0; y < grid->getHeight(); y++) {
-        for (int x = 0; x < grid->getWidth(); x++) {
-            GridCell* cell = grid->getCell(x, y);
-            if (cell) {
-                NodePtr cell_node = createCellMesh(x, y, cell->elevation);
-                cell_nodes.append(cell_node);
-            }
+bool GridRenderer::createGridVisualsStep(int max_cells) {
+    const int num_cells = grid->getWidth() * grid->getHeight();
+    if (visuals_next_cell >= num_cells) return true;
+
+    // Create visuals for the next cells in row order
+    const int end = visuals_next_cell + max_cells < num_cells ? visuals_next_cell + max_cells : num_cells;
+    for (; visuals_next_cell < end; visuals_next_cell++) {
+        const int x = visuals_next_cell % grid->getWidth();
+        const int y = visuals_next_cell / grid->getWidth();
+        GridCell* cell = grid->getCell(x, y);
+        if (cell) {
+            NodePtr cell_node = createCellMesh(x, y, cell->elevation);
+            cell_nodes.append(cell_node);
         }
     }
+    if (visuals_next_cell < num_cells) return false;
 
-    Log::message("GridRenderer::createGridVisuals() - Created %d cell visuals\n", cell_nodes.size());
-    Log::message("GridRenderer::createGridVisuals() - GridRoot has %d children\n", grid_root->getNumChildren());
+    Log::message("GridRenderer::createGridVisualsStep() - Created %d cell visuals\n", cell_nodes.size());
+    Log::message("GridRenderer::createGridVisualsStep() - GridRoot has %d children\n", grid_root->getNumChildren());
+    return true;
 }
 
-void GridRenderer::destroyGridVisuals() {
-    // Clear highlights
-    clearHighlights();
+float GridRenderer::getVisualsProgress() const {
+    const int num_cells = grid->getWidth() * grid->getHeight();
+    return num_cells > 0 ? (float)visuals_next_cell / num_cells : 1.0f;
+}
 
-    // Clear cell nodes
+void GridRenderer::destroyGridVisuals() {
+    // Drop the highlight overlay (deleted with grid_root)
+    highlight_mesh.clear();
+    highlight_material.clear();
+    highlight_slots.clear();
+    highlight_slot_of_cell.clear();
+    highlight_stamp.clear();
+    highlight_capacity = 0;
+
+    // Clear cell nodes and chunks
     cell_nodes.clear();
+    visuals_next_cell = 0;
+    chunk_slots.clear();
+    chunks.clear();
+    chunk_order.clear();
+    dirty_slots.clear();
+    render_stats = GridRenderStats();
+    tile_material.clear();
 
     // Delete root node (this will delete all children)
     if (grid_root) {
@@ -86,37 +142,174 @@ void GridRenderer::destroyGridVisuals() {
     Log::message("GridRenderer::destroyGridVisuals() - Destroyed grid visuals\n");
 }
 
+void GridRenderer::setFogOfWar(const FogOfWar* fog) {
+    if (mesh_params.fog == fog) return;
+    mesh_params.fog = fog;
+
+    // Per-cell node grids have no vertex colours and ignore the fog
+    if (chunks.size() == 0) return;
+    for (int y = 0; y < grid->getHeight(); y++) {
+        for (int x = 0; x < grid->getWidth(); x++) {
+            grid->markCellDirty(x, y);
+        }
+    }
+}
+
 void GridRenderer::updateGridVisuals() {
-    // TODO: Update cell colors based on grid state (blocked, occupied, etc.)
+    // Only cells GridSystem reported as changed since last frame
+    const Vector<int>& dirty = grid->getDirtyCells();
+    if (dirty.size() == 0 || !grid_root) return;
+
+    bool highlights_changed = false;
+
+    for (int i = 0; i < dirty.size(); i++) {
+        const int x = dirty[i] % grid->getWidth();
+        const int y = dirty[i] / grid->getWidth();
+
+        if (chunks.size() > 0) {
+            // Chunks without a slot are built from the current grid when they next get one
+            const int slot_index = chunks[(y / chunk_size) * chunks_x + x / chunk_size].slot;
+            if (slot_index >= 0) {
+                ChunkSlot& slot = chunk_slots[slot_index];
+                const int vertex = slot.data.getCellVertex(x, y);
+                const float old_z = slot.data.positions[vertex * 3 + 2];
+
+                GridMeshBuilder::writeCell(*grid, x, y, mesh_params, slot.data);
+
+                // Push just the four vertices of the quad drawing this cell
+                const float* position = slot.data.positions.get() + vertex * 3;
+                const float* color = slot.data.colors.get() + vertex * 4;
+                for (int c = 0; c < 4; c++) {
+                    slot.mesh->setVertex(vertex + c, vec3(position[0], position[1], position[2]));
+                    slot.mesh->setColor(vertex + c, vec4(color[0], color[1], color[2], color[3]));
+                    position += 3;
+                    color += 4;
+                }
+
+                if (!slot.dirty) {
+                    slot.dirty = true;
+                    dirty_slots.append(slot_index);
+                }
+                if (slot.data.positions[vertex * 3 + 2] != old_z) slot.bounds_dirty = true;
+            }
+        } else if (dirty[i] < cell_nodes.size() && cell_nodes[dirty[i]]) {
+            // Per-cell nodes only follow elevation
+            const GridCell* cell = grid->getCell(x, y);
+            cell_nodes[dirty[i]]->setWorldPosition(gridToWorld(x, y, cell->elevation) + dvec3(0, 0, config->tile_height_offset));
+        }
+
+        // Highlight quad on a cell that changed height
+        const int slot = highlight_mesh ? highlight_slot_of_cell[dirty[i]] : -1;
+        if (slot >= 0) {
+            writeHighlightSlot(slot);
+            highlights_changed = true;
+        }
+    }
+
+    for (int i = 0; i < dirty_slots.size(); i++) {
+        ChunkSlot& slot = chunk_slots[dirty_slots[i]];
+        if (slot.bounds_dirty) slot.mesh->updateBounds();
+        slot.mesh->flushVertex();
+        slot.dirty = false;
+        slot.bounds_dirty = false;
+    }
+    dirty_slots.clear();
+
+    if (highlights_changed) highlight_mesh->flushVertex();
 }
 
 void GridRenderer::highlightCell(GridPosition pos, vec4 color) {
-    if (!grid->isValidPosition(pos)) return;
+    if (setHighlightSlot(pos, color)) highlight_mesh->flushVertex();
+}
 
-    // Use config highlight color if no color specified (vec4(0,0,0,0))
-    vec4 use_color = (color.x == 0 && color.y == 0 && color.z == 0 && color.w == 0)
-        ? config->highlight_color
-        : color;
+bool GridRenderer::setHighlightSlot(GridPosition pos, const vec4& color) {
+    if (!grid->isValidPosition(pos) || !highlight_mesh) return false;
+
+    const int cell = pos.y * grid->getWidth() + pos.x;
+    const vec4 use_color = resolveHighlightColor(color);
 
-    NodePtr highlight = createHighlightMesh(pos, use_color);
-    if (highlight) {
-        highlight_nodes.append(highlight);
+    int slot = highlight_slot_of_cell[cell];
+    if (slot >= 0) {
+        // Already lit: recolour in place
+        HighlightSlot& existing = highlight_slots[slot];
+        if (existing.color.x == use_color.x && existing.color.y == use_color.y
+            && existing.color.z == use_color.z && existing.color.w == use_color.w) return false;
+        existing.color = use_color;
+    } else {
+        if (highlight_slots.size() >= highlight_capacity) {
+            reserveHighlights(highlight_capacity * 2);
+        }
+        HighlightSlot added;
+        added.cell = cell;
+        added.color = use_color;
+        highlight_slots.append(added);
+        slot = highlight_slots.size() - 1;
+        highlight_slot_of_cell[cell] = slot;
     }
+
+    writeHighlightSlot(slot);
+    return true;
 }
 
 void GridRenderer::highlightCells(const Vector<GridPosition>& cells, vec4 color) {
-    for (int i = 0; i < cells.size(); i++) {
-        highlightCell(cells[i], color);
+    highlightCells(cells.get(), cells.size(), color);
+}
+
+void GridRenderer::highlightCells(const GridPosition* cells, int count, vec4 color) {
+    // Write every slot, then upload the mesh once
+    bool changed = false;
+    for (int i = 0; i < count; i++) {
+        changed |= setHighlightSlot(cells[i], color);
     }
+    if (changed) highlight_mesh->flushVertex();
 }
 
-void GridRenderer::clearHighlights() {
-    for (int i = 0; i < highlight_nodes.size(); i++) {
-        if (highlight_nodes[i]) {
-            highlight_nodes[i].deleteLater();
+void GridRenderer::unhighlightCell(GridPosition pos) {
+    if (!grid->isValidPosition(pos) || !highlight_mesh) return;
+
+    const int slot = highlight_slot_of_cell[pos.y * grid->getWidth() + pos.x];
+    if (slot < 0) return;
+
+    removeHighlightSlot(slot);
+    highlight_mesh->flushVertex();
+}
+
+void GridRenderer::setHighlights(const Vector<GridPosition>& cells, vec4 color) {
+    setHighlights(cells.get(), cells.size(), color);
+}
+
+void GridRenderer::setHighlights(const GridPosition* cells, int count, vec4 color) {
+    if (!highlight_mesh) return;
+
+    // Stamp the new set, then drop every lit cell that is not stamped
+    highlight_generation++;
+    bool changed = false;
+    for (int i = 0; i < count; i++) {
+        if (!grid->isValidPosition(cells[i])) continue;
+        highlight_stamp[cells[i].y * grid->getWidth() + cells[i].x] = highlight_generation;
+        changed |= setHighlightSlot(cells[i], color);
+    }
+
+    for (int slot = highlight_slots.size() - 1; slot >= 0; slot--) {
+        if (highlight_stamp[highlight_slots[slot].cell] != highlight_generation) {
+            removeHighlightSlot(slot);
+            changed = true;
         }
     }
-    highlight_nodes.clear();
+
+    // One upload for the whole set (added, recoloured and removed quads)
+    if (changed) highlight_mesh->flushVertex();
+}
+
+void GridRenderer::clearHighlights() {
+    if (!highlight_mesh || highlight_slots.size() == 0) return;
+
+    for (int slot = 0; slot < highlight_slots.size(); slot++) {
+        highlight_slot_of_cell[highlight_slots[slot].cell] = -1;
+        collapseHighlightSlot(slot);
+    }
+    highlight_slots.clear();
+    highlight_mesh->flushVertex();
 }
 
 void GridRenderer::show() {
@@ -147,6 +340,233 @@ dvec3 GridRenderer::gridToWorld(GridPosition pos) const {
     return gridToWorld(pos.x, pos.y, pos.z);
 }
 
+GridPosition GridRenderer::worldToGrid(const dvec3& world_pos) const {
+    // Inverse of gridToWorld: cells are centred on multiples of cell_size
+    int x = (int)floor(world_pos.x / config->cell_size + 0.5);
+    int y = (int)floor(world_pos.y / config->cell_size + 0.5);
+
+    GridCell* cell = grid->getCell(x, y);
+    return GridPosition(x, y, cell ? cell->elevation : 0);
+}
+
+void GridRenderer::createChunkMeshes() {
+    // Palette and layout from config
+    mesh_params.cell_size = config->cell_size;
+    mesh_params.elevation_height = config->elevation_height;
+    mesh_params.tile_size = config->cell_size * config->tile_coverage;
+    mesh_params.height_offset = config->tile_height_offset;
+    mesh_params.fog_brightness = config->fog_brightness;
+
+    const vec4 palette[(int)GridPaletteEntry::COUNT] = {
+        config->grid_color, config->blocked_color, config->occupied_color, config->unexplored_color
+    };
+    for (int i = 0; i < (int)GridPaletteEntry::COUNT; i++) {
+        mesh_params.palette[i][0] = palette[i].x;
+        mesh_params.palette[i][1] = palette[i].y;
+        mesh_params.palette[i][2] = palette[i].z;
+        mesh_params.palette[i][3] = palette[i].w;
+    }
+
+    // One material for every chunk
+    tile_material = createVertexColorMaterial();
+
+    chunk_size = config->chunk_size > 0 ? config->chunk_size : 32;
+    chunks_x = GridMeshBuilder::getNumChunks(grid->getWidth(), chunk_size);
+    const int chunks_y = GridMeshBuilder::getNumChunks(grid->getHeight(), chunk_size);
+
+    // Chunk layout only - nothing is built until streaming assigns a slot
+    chunks.resize(chunks_x * chunks_y);
+    chunk_order.reserve(chunks.size());
+    for (int cy = 0; cy < chunks_y; cy++) {
+        for (int cx = 0; cx < chunks_x; cx++) {
+            GridChunk& chunk = chunks[cy * chunks_x + cx];
+            chunk.x0 = cx * chunk_size;
+            chunk.y0 = cy * chunk_size;
+            chunk.width = chunk.x0 + chunk_size <= grid->getWidth() ? chunk_size : grid->getWidth() - chunk.x0;
+            chunk.height = chunk.y0 + chunk_size <= grid->getHeight() ? chunk_size : grid->getHeight() - chunk.y0;
+            chunk.slot = -1;
+            chunk.wanted = GridChunkLod::NONE;
+            chunk.distance = 0.0;
+            chunk.selected = 0;
+        }
+    }
+
+    // Fixed pool of render meshes: the node budget
+    const int budget = config->chunk_budget > 0 ? config->chunk_budget : 16;
+    const int num_slots = budget < chunks.size() ? budget : chunks.size();
+    chunk_slots.resize(num_slots);
+    dirty_slots.reserve(num_slots);
+    for (int i = 0; i < num_slots; i++) {
+        ChunkSlot& slot = chunk_slots[i];
+        slot.mesh = ObjectMeshDynamic::create(ObjectMeshDynamic::USAGE_DYNAMIC_VERTEX);
+        PerfMonitor::get()->count(PerfCounter::NODES_CREATED);
+        slot.mesh->setName(String::format("GridChunkSlot_%d", i));
+        slot.mesh->setEnabled(0);
+        if (grid_root) {
+            slot.mesh->setParent(grid_root);
+        }
+        slot.chunk = -1;
+        slot.lod = GridChunkLod::NONE;
+        slot.dirty = false;
+        slot.bounds_dirty = false;
+    }
+
+    render_stats = GridRenderStats();
+    render_stats.chunks_total = chunks.size();
+    render_stats.mesh_slots = num_slots;
+
+    Log::message("GridRenderer::createChunkMeshes() - %d cells in %d chunks (%dx%d cells), %d mesh slots\n",
+        grid->getWidth() * grid->getHeight(), chunks.size(), chunk_size, chunk_size, num_slots);
+}
+
+void GridRenderer::updateChunkStreaming(const dvec3& camera_position, const WorldBoundFrustum* frustum) {
+    if (chunks.size() == 0 || !visible) return;
+
+    streaming_frame++;
+    const double full_distance = config->chunk_full_distance;
+    const double far_distance = config->chunk_far_distance;
+    const double max_height = CHUNK_BOX_LEVELS * config->elevation_height;
+
+    // Decide detail per chunk: distance to the chunk's box, then the frustum
+    chunk_order.clear();
+    for (int i = 0; i < chunks.size(); i++) {
+        GridChunk& chunk = chunks[i];
+        const dvec3 min = gridToWorld(chunk.x0, chunk.y0, 0) - dvec3(config->cell_size * 0.5, config->cell_size * 0.5, 0.0);
+        const dvec3 max = gridToWorld(chunk.x0 + chunk.width, chunk.y0 + chunk.height, 0)
+            - dvec3(config->cell_size * 0.5, config->cell_size * 0.5, -max_height);
+
+        const double dx = camera_position.x < min.x ? min.x - camera_position.x : camera_position.x > max.x ? camera_position.x - max.x : 0.0;
+        const double dy = camera_position.y < min.y ? min.y - camera_position.y : camera_position.y > max.y ? camera_position.y - max.y : 0.0;
+        const double dz = camera_position.z < min.z ? min.z - camera_position.z : camera_position.z > max.z ? camera_position.z - max.z : 0.0;
+        chunk.distance = sqrt(dx * dx + dy * dy + dz * dz);
+
+        chunk.wanted = chunk.distance <= full_distance ? GridChunkLod::FULL
+            : chunk.distance <= far_distance ? GridChunkLod::COARSE : GridChunkLod::NONE;
+        if (chunk.wanted != GridChunkLod::NONE && frustum && !frustum->inside(WorldBoundBox(min, max))) {
+            chunk.wanted = GridChunkLod::NONE;
+        }
+        if (chunk.wanted != GridChunkLod::NONE) chunk_order.append(i);
+    }
+
+    // Nearest chunks win when more are wanted than there are slots
+    std::sort(chunk_order.begin(), chunk_order.end(), [this](int a, int b) {
+        return chunks[a].distance < chunks[b].distance;
+    });
+    if (chunk_order.size() > chunk_slots.size()) chunk_order.resize(chunk_slots.size());
+    for (int i = 0; i < chunk_order.size(); i++) {
+        chunks[chunk_order[i]].selected = streaming_frame;
+    }
+
+    // Keep slots that are still wanted, then hand out the rest
+    for (int i = 0; i < chunk_order.size(); i++) {
+        const int index = chunk_order[i];
+        GridChunk& chunk = chunks[index];
+
+        if (chunk.slot < 0) {
+            chunk.slot = acquireChunkSlot();
+            if (chunk.slot < 0) continue;
+            buildChunkSlot(chunk.slot, index, chunk.wanted);
+        } else if (chunk_slots[chunk.slot].lod != chunk.wanted) {
+            buildChunkSlot(chunk.slot, index, chunk.wanted);
+        }
+        if (!chunk_slots[chunk.slot].mesh->isEnabled()) chunk_slots[chunk.slot].mesh->setEnabled(1);
+    }
+
+    // Hide slots whose chunk was not selected - they stay built until another chunk needs them
+    render_stats.chunks_full = 0;
+    render_stats.chunks_coarse = 0;
+    render_stats.chunks_cached = 0;
+    render_stats.resident_vertices = 0;
+    for (int i = 0; i < chunk_slots.size(); i++) {
+        ChunkSlot& slot = chunk_slots[i];
+        if (slot.chunk < 0) continue;
+
+        render_stats.resident_vertices += slot.data.getNumVertex();
+        if (chunks[slot.chunk].selected != streaming_frame) {
+            if (slot.mesh->isEnabled()) slot.mesh->setEnabled(0);
+            render_stats.chunks_cached++;
+        } else if (slot.lod == GridChunkLod::FULL) {
+            render_stats.chunks_full++;
+        } else {
+            render_stats.chunks_coarse++;
+        }
+    }
+}
+
+int GridRenderer::acquireChunkSlot() {
+    // Free slot first, then the farthest slot whose chunk was not selected this frame
+    int best = -1;
+    double best_distance = -1.0;
+    for (int i = 0; i < chunk_slots.size(); i++) {
+        const int chunk = chunk_slots[i].chunk;
+        if (chunk < 0) return i;
+        if (chunks[chunk].selected == streaming_frame) continue;
+        if (chunks[chunk].distance > best_distance) {
+            best = i;
+            best_distance = chunks[chunk].distance;
+        }
+    }
+
+    if (best >= 0) {
+        chunks[chunk_slots[best].chunk].slot = -1;
+        chunk_slots[best].chunk = -1;
+    }
+    return best;
+}
+
+void GridRenderer::buildChunkSlot(int slot_index, int chunk_index, GridChunkLod lod) {
+    ChunkSlot& slot = chunk_slots[slot_index];
+    const GridChunk& chunk = chunks[chunk_index];
+
+    const int block = lod == GridChunkLod::FULL ? 1 : (config->coarse_block > 1 ? config->coarse_block : 4);
+    GridMeshBuilder::buildChunk(*grid, chunk.x0, chunk.y0, chunk.width, chunk.height, block, mesh_params, slot.data);
+
+    slot.chunk = chunk_index;
+    slot.lod = lod;
+    slot.mesh->setWorldPosition(gridToWorld(chunk.x0, chunk.y0, 0));
+    uploadChunkSlot(slot_index);
+}
+
+void GridRenderer::uploadChunkSlot(int slot_index) {
+    ChunkSlot& slot = chunk_slots[slot_index];
+    const GridChunkMesh& data = slot.data;
+    ObjectMeshDynamicPtr mesh = slot.mesh;
+    const float* position = data.positions.get();
+    const float* color = data.colors.get();
+
+    mesh->clearVertex();
+    mesh->clearIndices();
+    mesh->allocateVertex(data.getNumVertex());
+    mesh->allocateIndices(data.indices.size());
+    mesh->addSurface("grid");
+
+    // Per-quad texture coordinates give updateTangents() an upward normal to work with
+    const vec4 texcoords[4] = { vec4(0, 0, 0, 0), vec4(1, 0, 0, 0), vec4(1, 1, 0, 0), vec4(0, 1, 0, 0) };
+    for (int i = 0; i < data.getNumVertex(); i++) {
+        mesh->addVertex(vec3(position[0], position[1], position[2]));
+        mesh->addTexCoord(texcoords[i & 3]);
+        mesh->addColor(vec4(color[0], color[1], color[2], color[3]));
+        position += 3;
+        color += 4;
+    }
+    for (int i = 0; i < data.indices.size(); i++) {
+        mesh->addIndex(data.indices[i]);
+    }
+
+    mesh->updateBounds();
+    mesh->updateTangents();
+    mesh->flushVertex();
+    mesh->flushIndices();
+
+    if (tile_material) {
+        mesh->setMaterial(tile_material, 0);
+    }
+
+    // A rebuild already contains any pending cell edits
+    slot.dirty = false;
+    slot.bounds_dirty = false;
+}
+
 NodePtr GridRenderer::createCellMesh(int x, int y, int elevation) {
     // Use Unigine's built-in box primitive instead of manual mesh creation
     dvec3 world_pos = gridToWorld(x, y, elevation);
@@ -154,6 +574,7 @@ NodePtr GridRenderer::createCellMesh(int x, int y, int elevation) {
     // Create a flat box (size based on config tile_coverage to leave gaps)
     float tile_size = config->cell_size * config->tile_coverage;
     ObjectMeshDynamicPtr mesh = Primitives::createBox(vec3(tile_size, tile_size, config->tile_thickness));
+    PerfMonitor::get()->count(PerfCounter::NODES_CREATED);
     mesh->setName(String::format("GridCell_%d_%d", x, y));
 
     // Position it at the grid cell location (height based on config)
@@ -181,30 +602,131 @@ NodePtr GridRenderer::createCellMesh(int x, int y, int elevation) {
     return NodePtr(mesh);
 }
 
-NodePtr GridRenderer::createHighlightMesh(GridPosition pos, vec4 color) {
-    // Similar to createCellMesh but slightly elevated with custom color
-    dvec3 world_pos = gridToWorld(pos);
+void GridRenderer::createHighlightMesh() {
+    highlight_mesh = ObjectMeshDynamic::create(ObjectMeshDynamic::USAGE_DYNAMIC_VERTEX);
+    PerfMonitor::get()->count(PerfCounter::NODES_CREATED);
+    highlight_mesh->setName("GridHighlights");
+    highlight_mesh->setWorldPosition(dvec3(0, 0, 0));
+    if (grid_root) {
+        highlight_mesh->setParent(grid_root);
+    }
+    highlight_material = createVertexColorMaterial();
+
+    const int num_cells = grid->getWidth() * grid->getHeight();
+    highlight_slot_of_cell.resize(num_cells);
+    highlight_stamp.resize(num_cells);
+    for (int i = 0; i < num_cells; i++) {
+        highlight_slot_of_cell[i] = -1;
+        highlight_stamp[i] = 0;
+    }
 
-    // Create a flat box (same size as grid cell for highlighting)
-    float tile_size = config->cell_size * config->tile_coverage;
-    ObjectMeshDynamicPtr mesh = Primitives::createBox(vec3(tile_size, tile_size, config->tile_thickness));
-    mesh->setName(String::format("Highlight_%d_%d_%d", pos.x, pos.y, pos.z));
+    // Enough for a typical movement range; grows by doubling (rare, rebuilds the buffers once)
+    reserveHighlights(256);
+}
 
-    // Position slightly above the grid tiles
-    mesh->setWorldPosition(world_pos + dvec3(0, 0, config->tile_height_offset + 0.02));
+void GridRenderer::reserveHighlights(int capacity) {
+    if (capacity < 1) capacity = 1;
+    highlight_capacity = capacity;
+
+    highlight_mesh->clearVertex();
+    highlight_mesh->clearIndices();
+    highlight_mesh->allocateVertex(capacity * 4);
+    highlight_mesh->allocateIndices(capacity * 6);
+    highlight_mesh->addSurface("highlights");
+
+    // Every quad exists up front; unused ones are collapsed to a point
+    const vec4 texcoords[4] = { vec4(0, 0, 0, 0), vec4(1, 0, 0, 0), vec4(1, 1, 0, 0), vec4(0, 1, 0, 0) };
+    for (int i = 0; i < capacity * 4; i++) {
+        highlight_mesh->addVertex(vec3_zero);
+        highlight_mesh->addTexCoord(texcoords[i & 3]);
+        highlight_mesh->addColor(vec4_zero);
+    }
+    for (int quad = 0; quad < capacity; quad++) {
+        const int vertex = quad * 4;
+        highlight_mesh->addIndex(vertex);
+        highlight_mesh->addIndex(vertex + 1);
+        highlight_mesh->addIndex(vertex + 2);
+        highlight_mesh->addIndex(vertex);
+        highlight_mesh->addIndex(vertex + 2);
+        highlight_mesh->addIndex(vertex + 3);
+    }
 
-    // Get and modify the material with highlight color
-    MaterialPtr material = mesh->getMaterial(0);
-    if (material) {
-        material = material->inherit();
-        material->setParameterFloat4("albedo_color", color);
-        mesh->setMaterial(material, 0);
+    for (int slot = 0; slot < highlight_slots.size(); slot++) {
+        writeHighlightSlot(slot);
     }
 
-    // Parent to grid root
-    if (grid_root) {
-        mesh->setParent(grid_root);
+    // Quads move every update: bound the whole grid once instead of recomputing bounds per change
+    const float margin = config->cell_size;
+    const dvec3 grid_max = gridToWorld(grid->getWidth(), grid->getHeight(), 255);
+    highlight_mesh->setBoundBox(BoundBox(vec3(-margin, -margin, -margin),
+        vec3((float)grid_max.x, (float)grid_max.y, (float)grid_max.z + margin)));
+
+    highlight_mesh->updateTangents();
+    highlight_mesh->flushVertex();
+    highlight_mesh->flushIndices();
+
+    if (highlight_material) {
+        highlight_mesh->setMaterial(highlight_material, 0);
     }
+}
 
-    return NodePtr(mesh);
+void GridRenderer::writeHighlightSlot(int slot) {
+    const HighlightSlot& highlight = highlight_slots[slot];
+    const int x = highlight.cell % grid->getWidth();
+    const int y = highlight.cell / grid->getWidth();
+
+    // Slightly above the grid tiles, same footprint
+    const GridCell* cell = grid->getCell(x, y);
+    const dvec3 centre = gridToWorld(x, y, cell->elevation) + dvec3(0, 0, config->tile_height_offset + 0.02);
+    const float half = config->cell_size * config->tile_coverage * 0.5f;
+    const float corner_x[4] = { -half, half, half, -half };
+    const float corner_y[4] = { -half, -half, half, half };
+
+    const int vertex = slot * 4;
+    for (int c = 0; c < 4; c++) {
+        highlight_mesh->setVertex(vertex + c, vec3((float)centre.x + corner_x[c], (float)centre.y + corner_y[c], (float)centre.z));
+        highlight_mesh->setColor(vertex + c, highlight.color);
+    }
+}
+
+void GridRenderer::collapseHighlightSlot(int slot) {
+    const int vertex = slot * 4;
+    for (int c = 0; c < 4; c++) {
+        highlight_mesh->setVertex(vertex + c, vec3_zero);
+        highlight_mesh->setColor(vertex + c, vec4_zero);
+    }
+}
+
+void GridRenderer::removeHighlightSlot(int slot) {
+    // Swap-remove: the last lit quad moves into the hole, so lit quads stay contiguous
+    highlight_slot_of_cell[highlight_slots[slot].cell] = -1;
+
+    const int last = highlight_slots.size() - 1;
+    if (slot != last) {
+        highlight_slots[slot] = highlight_slots[last];
+        highlight_slot_of_cell[highlight_slots[slot].cell] = slot;
+        writeHighlightSlot(slot);
+    }
+    collapseHighlightSlot(last);
+    highlight_slots.resize(last);
+}
+
+vec4 GridRenderer::resolveHighlightColor(const vec4& color) const {
+    // Use config highlight color if no color specified (vec4(0,0,0,0))
+    return (color.x == 0 && color.y == 0 && color.z == 0 && color.w == 0)
+        ? config->highlight_color
+        : color;
+}
+
+MaterialPtr GridRenderer::createVertexColorMaterial() const {
+    // White albedo tinted by vertex colour: one material serves every colour
+    MaterialPtr base = Materials::findManualMaterial("Unigine::mesh_base");
+    if (!base) return MaterialPtr();
+
+    MaterialPtr material = base->inherit();
+    material->setParameterFloat4("albedo_color", vec4_one);
+    if (material->findState("vertex_color") != -1) {
+        material->setState("vertex_color", 1);
+    }
+    return material;
 }
@@ -5,14 +5,33 @@
 
 #include "../Grid/GridSystem.h"
 #include "../Components/GridConfigComponent.h"
+#include "GridMeshBuilder.h"
 #include <UnigineVector.h>
 #include <UniginePtr.h>
 #include <UnigineNode.h>
 #include <UnigineMathLib.h>
+#include <UnigineObjects.h>
+#include <UnigineMaterials.h>
 
-namespace Unigine {
-    class ObjectMeshDynamic;
-}
+// Detail a batched-grid chunk is drawn with
+enum class GridChunkLod {
+    NONE,       // Culled or beyond chunk_far_distance (no slot or slot hidden)
+    COARSE,     // One quad per coarse_block x coarse_block cells
+    FULL        // One quad per cell
+};
+
+struct GridRenderStats {
+    int chunks_total;       // Chunks covering the map
+    int chunks_full;        // Drawn at full detail
+    int chunks_coarse;      // Drawn merged
+    int chunks_cached;      // Built but hidden (off-screen, slot not reclaimed yet)
+    int mesh_slots;         // Render meshes in the pool (= node budget)
+    int resident_vertices;  // Vertices across all slots
+
+    GridRenderStats()
+        : chunks_total(0), chunks_full(0), chunks_coarse(0)
+        , chunks_cached(0), mesh_slots(0), resident_vertices(0) {}
+};
 
 class GridRenderer {
 public:
@@ -20,15 +39,40 @@ public:
     ~GridRenderer();
 
     // Grid visualization
-    void createGridVisuals();
+    void createGridVisuals();   // All at once (beginGridVisuals + every step)
+
+    // Time-sliced creation for loading: begin once, then step until it returns true.
+    // Batched grids finish in beginGridVisuals; per-cell grids create max_cells nodes per step.
+    void beginGridVisuals();
+    bool createGridVisualsStep(int max_cells);
+    float getVisualsProgress() const;
+
     void destroyGridVisuals();
-    void updateGridVisuals();
+    void updateGridVisuals();   // Apply GridSystem's dirty cells (call once per frame, before clearDirtyCells)
+
+    // Batched grid streaming: pick which chunks get one of the chunk_budget meshes and at what
+    // detail, from camera distance and (optionally) the view frustum. Call once per frame.
+    void updateChunkStreaming(const Unigine::Math::dvec3& camera_position,
+                              const Unigine::Math::WorldBoundFrustum* frustum);
+    const GridRenderStats& getRenderStats() const { return render_stats; }
+
+    // Shade the batched grid with the fog's displayed faction (nullptr = no fog). Redraws every
+    // cell once; after that the fog reports the cells whose visibility changed as dirty.
+    void setFogOfWar(const FogOfWar* fog);
 
     // Cell highlighting (for movement range, targeting, etc.)
+    // All highlights live in one persistent overlay mesh: changing them rewrites vertices in place
     void highlightCell(GridPosition pos, Unigine::Math::vec4 color);
     void highlightCells(const Unigine::Vector<GridPosition>& cells, Unigine::Math::vec4 color);
+    void highlightCells(const GridPosition* cells, int count, Unigine::Math::vec4 color);   // Arena/scratch lists
+    void unhighlightCell(GridPosition pos);
     void clearHighlights();
 
+    // Replace the highlighted set: cells already lit keep their vertices, only the difference is written
+    void setHighlights(const Unigine::Vector<GridPosition>& cells, Unigine::Math::vec4 color);
+    void setHighlights(const GridPosition* cells, int count, Unigine::Math::vec4 color);
+    int getNumHighlights() const { return highlight_slots.size(); }
+
     // Visibility
     void show();
     void hide();
@@ -37,6 +81,7 @@ public:
     // Grid-to-world coordinate conversion
     Unigine::Math::dvec3 gridToWorld(int x, int y, int elevation = 0) const;
     Unigine::Math::dvec3 gridToWorld(GridPosition pos) const;
+    GridPosition worldToGrid(const Unigine::Math::dvec3& world_pos) const; // Nearest cell, z = cell elevation
 
 private:
     GridSystem* grid;
@@ -45,12 +90,66 @@ private:
 
     // Visual nodes
     Unigine::NodePtr grid_root;                     // Parent node for all grid visuals
-    Unigine::Vector<Unigine::NodePtr> cell_nodes;   // One node per grid cell
-    Unigine::Vector<Unigine::NodePtr> highlight_nodes; // Highlight overlays
+    Unigine::Vector<Unigine::NodePtr> cell_nodes;   // One node per grid cell (batched_grid off)
+    int visuals_next_cell;                          // Next cell createGridVisualsStep creates
+
+    // Batched grid: the map is split into chunks, but only a fixed pool of mesh slots exists.
+    // Near chunks borrow a slot and are built at full or coarse detail; far or culled chunks
+    // give theirs up. Node and vertex counts depend on chunk_budget, not on map size.
+    struct GridChunk {
+        int x0, y0;                 // First cell
+        int width, height;          // Cells
+        int slot;                   // Index into chunk_slots, -1 = not built
+        GridChunkLod wanted;        // This frame's decision
+        double distance;            // Camera distance this frame
+        unsigned int selected;      // streaming_frame in which the chunk was given a slot
+    };
+    struct ChunkSlot {
+        Unigine::ObjectMeshDynamicPtr mesh;
+        GridChunkMesh data;         // CPU copy of the slot's vertex data
+        int chunk;                  // -1 = free
+        GridChunkLod lod;           // Detail 'data' was built with
+        bool dirty;                 // Vertices written this frame, needs flush
+        bool bounds_dirty;          // Elevation changed, needs updateBounds
+    };
+    Unigine::Vector<GridChunk> chunks;
+    Unigine::Vector<ChunkSlot> chunk_slots;
+    Unigine::Vector<int> chunk_order;               // Scratch: chunks wanted this frame, nearest first
+    Unigine::Vector<int> dirty_slots;
+    GridMeshParams mesh_params;
+    Unigine::MaterialPtr tile_material;
+    int chunk_size;                                 // Cells per chunk edge
+    int chunks_x;                                   // Chunks per row
+    unsigned int streaming_frame;
+    GridRenderStats render_stats;
+
+    void createChunkMeshes();
+    void buildChunkSlot(int slot, int chunk, GridChunkLod lod);
+    void uploadChunkSlot(int slot);
+    int acquireChunkSlot();
+
+    // Highlight overlay: quad slots [0, highlight_slots.size()) are lit, the rest are collapsed
+    struct HighlightSlot {
+        int cell;                   // y * width + x
+        Unigine::Math::vec4 color;
+    };
+    Unigine::ObjectMeshDynamicPtr highlight_mesh;
+    Unigine::MaterialPtr highlight_material;
+    Unigine::Vector<HighlightSlot> highlight_slots;
+    Unigine::Vector<int> highlight_slot_of_cell;        // -1 = not highlighted
+    Unigine::Vector<unsigned int> highlight_stamp;      // setHighlights() membership per cell
+    unsigned int highlight_generation;
+    int highlight_capacity;                             // Quads allocated in highlight_mesh
+
+    void createHighlightMesh();
+    void reserveHighlights(int capacity);
+    bool setHighlightSlot(GridPosition pos, const Unigine::Math::vec4& color);   // No flush; false = unchanged
+    void writeHighlightSlot(int slot);
+    void collapseHighlightSlot(int slot);
+    void removeHighlightSlot(int slot);
+    Unigine::Math::vec4 resolveHighlightColor(const Unigine::Math::vec4& color) const;
+    Unigine::MaterialPtr createVertexColorMaterial() const;
 
     // Helper: Create a single grid cell mesh
     Unigine::NodePtr createCellMesh(int x, int y, int elevation);
-
-    // Helper: Create highlight overlay for a cell
-    Unigine::NodePtr createHighlightMesh(GridPosition pos, Unigine::Math::vec4 color);
 };
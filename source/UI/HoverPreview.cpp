@@ -0,0 +1,145 @@
+// HoverPreview.cpp
+#include "HoverPreview.h"
+#include "../Grid/GridSystem.h"
+#include "../Core/TurnManager.h"
+#include "../Core/CombatantTable.h"
+#include "../Components/UnitComponent.h"
+#include "../Core/PerfMonitor.h"
+#include "../Spells/SpellSystem.h"
+#include <UnigineComponentSystem.h>
+
+HoverPreviewCache::HoverPreviewCache(GridSystem* grid_system, TurnManager* turn_mgr, const SpellSystem* spell_system)
+    : grid(grid_system)
+    , turn_manager(turn_mgr)
+    , spells(spell_system)
+    , unit_node_id(0)
+    , version(0)
+    , field_ready(false)
+    , hits(0)
+    , misses(0)
+{
+    entries.reserve(64);
+}
+
+void HoverPreviewCache::invalidate() {
+    unit_node_id = 0;
+    field_ready = false;
+    entry_of_cell.clear();
+    entries.clear();
+}
+
+const HoverPreview* HoverPreviewCache::get(UnitComponent* unit, GridPosition cell, unsigned int state_version) {
+    if (!unit || unit->table_row < 0 || !grid->isValidPosition(cell)) return nullptr;
+
+    // New unit or anything changed since: start over
+    const int node_id = unit->getNode()->getID();
+    if (node_id != unit_node_id || state_version != version) {
+        invalidate();
+        unit_node_id = node_id;
+        version = state_version;
+    }
+
+    const int cell_index = cell.y * grid->getWidth() + cell.x;
+    Unigine::HashMap<int, int>::Iterator it = entry_of_cell.find(cell_index);
+    if (it != entry_of_cell.end()) {
+        hits++;
+        PerfMonitor::get()->count(PerfCounter::HOVER_HITS);
+        return &entries[it->data];
+    }
+    misses++;
+    PerfMonitor::get()->count(PerfCounter::HOVER_MISSES);
+
+    const GridCell* grid_cell = grid->getCell(cell.x, cell.y);
+    HoverPreview preview;
+    preview.cell = GridPosition(cell.x, cell.y, grid_cell->elevation);
+
+    UnitComponent* target = grid_cell->occupant
+        ? Unigine::ComponentSystem::get()->getComponent<UnitComponent>(grid_cell->occupant) : nullptr;
+
+    if (target && target != unit && target->table_row >= 0) {
+        fillStrike(unit, target, preview);
+    } else {
+        fillMovement(unit, preview);
+    }
+
+    entries.append(preview);
+    entry_of_cell.append(cell_index, entries.size() - 1);
+    return &entries.last();
+}
+
+void HoverPreviewCache::buildField(UnitComponent* unit) {
+    const int width = grid->getWidth();
+    const int num_cells = width * grid->getHeight();
+    const Unigine::NodePtr self = unit->getNode();
+
+    stride_mask.resize(num_cells);
+    elevation.resize(num_cells);
+    reachable_slot.resize(num_cells);
+
+    for (int i = 0; i < num_cells; i++) {
+        const GridCell* cell = grid->getCell(i % width, i / width);
+        const bool other_unit = cell->occupant && cell->occupant != self;
+        stride_mask[i] = cell->blocked || other_unit ? 1 : 0;
+        elevation[i] = cell->elevation;
+        reachable_slot[i] = -1;
+    }
+
+    // Movement left this turn: remaining actions on the unit's own turn, a full turn otherwise
+    const int speed = unit->getStats().speed;
+    const int actions = turn_manager && turn_manager->getCurrentUnit() == unit ? turn_manager->getActionsRemaining() : 3;
+
+    GridView view;
+    view.width = width;
+    view.height = grid->getHeight();
+    view.blocked = stride_mask.get();
+    view.elevation = elevation.get();
+    Pathfinding::computeReachable(view, unit->getGridPosition(), speed * actions, reachable);
+
+    for (int i = 0; i < reachable.size(); i++) {
+        reachable_slot[reachable[i].index] = i;
+    }
+    field_ready = true;
+}
+
+void HoverPreviewCache::fillMovement(UnitComponent* unit, HoverPreview& preview) {
+    if (!field_ready) buildField(unit);
+
+    const int width = grid->getWidth();
+    const int cell_index = preview.cell.y * width + preview.cell.x;
+    const int slot = reachable_slot[cell_index];
+    if (slot < 0) return;
+
+    preview.reachable = true;
+    preview.move_feet = reachable[slot].cost;
+    preview.stride_actions = Pathfinding::getStrideCount(preview.move_feet, unit->getStats().speed);
+
+    // Walk parents back to the start, then reverse
+    for (int cell = cell_index; cell >= 0 && reachable_slot[cell] >= 0; cell = reachable[reachable_slot[cell]].parent) {
+        preview.path.append(GridPosition(cell % width, cell / width, elevation[cell]));
+    }
+    for (int i = 0, j = preview.path.size() - 1; i < j; i++, j--) {
+        GridPosition temp = preview.path[i];
+        preview.path[i] = preview.path[j];
+        preview.path[j] = temp;
+    }
+}
+
+void HoverPreviewCache::fillStrike(UnitComponent* unit, UnitComponent* target, HoverPreview& preview) {
+    preview.target_node_id = target->getNode()->getID();
+
+    const StatBlock& attacker_stats = unit->getStats();
+    const StatBlock& target_stats = target->getStats();
+
+    // Same situation the Strike itself will be resolved with (GameManager::executeCommand)
+    const StrikeSituation situation = CombatRules::getStrikeSituation(*grid, unit->getGridPosition(), target->getGridPosition());
+    preview.cover = situation.cover;
+    preview.height_bonus = situation.height_bonus;
+    preview.map = turn_manager && turn_manager->getCurrentUnit() == unit ? turn_manager->getCurrentMAP() : 0;
+    preview.effective_ac = target_stats.armor_class + situation.cover_bonus;
+    if (spells) {
+        preview.effect_bonus = spells->getEffects().getModifier(unit->getNode()->getID(), EffectKind::STATUS_ATTACK);
+        preview.effective_ac += spells->getEffects().getArmorClassModifier(preview.target_node_id);
+    }
+    preview.odds = CombatRules::getStrikeOdds(attacker_stats.attack_bonus + preview.height_bonus + preview.effect_bonus,
+        preview.map, preview.effective_ac, attacker_stats.damage);
+}
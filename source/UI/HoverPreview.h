@@ -0,0 +1,89 @@
+// HoverPreview.h
+// Memoized hover feedback: path and action cost to the hovered cell, or cover and hit odds
+// against the unit standing on it
+// Entries are keyed by (selected unit, hovered cell, combat state version). A still or
+// revisiting mouse is a hash lookup; any GridSystem/TurnManager change bumps the state
+// version and drops the whole cache on the next query.
+
+#pragma once
+
+#include "../Grid/GridCell.h"
+#include "../Grid/Pathfinding.h"
+#include "../Core/CombatRules.h"
+#include <UnigineVector.h>
+#include <UnigineHashMap.h>
+
+class GridSystem;
+class TurnManager;
+class UnitComponent;
+class SpellSystem;
+
+struct HoverPreview {
+    GridPosition cell;
+
+    // Movement to an empty cell
+    bool reachable;
+    int move_feet;                          // Cheapest Stride cost
+    int stride_actions;                     // Stride actions needed
+    Unigine::Vector<GridPosition> path;     // Start..cell
+
+    // Strike against the unit on the cell (from where the selected unit stands)
+    int target_node_id;                     // 0 = no target on this cell
+    CoverType cover;
+    int height_bonus;                       // Attack bonus from elevation
+    int effect_bonus;                       // Attack bonus from spell effects (Bless)
+    int map;                                // Multiple Attack Penalty of the next Strike
+    int effective_ac;                       // Target AC including cover and spell effects (Prone)
+    StrikeOdds odds;
+
+    HoverPreview()
+        : reachable(false), move_feet(0), stride_actions(0)
+        , target_node_id(0), cover(CoverType::NONE), height_bonus(0), effect_bonus(0), map(0), effective_ac(0)
+    {
+        odds.hit = odds.critical = odds.expected_damage = 0.0f;
+    }
+};
+
+class HoverPreviewCache {
+public:
+    // spell_system may be nullptr (no effects in the odds)
+    HoverPreviewCache(GridSystem* grid_system, TurnManager* turn_mgr, const SpellSystem* spell_system);
+
+    // Preview for 'unit' hovering 'cell' at 'state_version' (GameManager::getStateVersion).
+    // Computed on first request, then served from the cache. nullptr if cell/unit is invalid.
+    // The pointer stays valid until the next get() or invalidate().
+    const HoverPreview* get(UnitComponent* unit, GridPosition cell, unsigned int state_version);
+
+    void invalidate();
+
+    // Cache effectiveness
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+
+private:
+    GridSystem* grid;
+    TurnManager* turn_manager;
+    const SpellSystem* spells;
+
+    // Current key (everything below is valid only for it)
+    int unit_node_id;
+    unsigned int version;
+
+    // Per-key movement field, computed once on the first movement query
+    bool field_ready;
+    Unigine::Vector<unsigned char> stride_mask;     // Terrain + occupants except the unit
+    Unigine::Vector<int> elevation;
+    Unigine::Vector<ReachableCell> reachable;
+    Unigine::Vector<int> reachable_slot;            // Cell index -> reachable[] (-1 = unreachable)
+
+    // Filled previews, by cell index
+    Unigine::HashMap<int, int> entry_of_cell;
+    Unigine::Vector<HoverPreview> entries;
+
+    int hits;
+    int misses;
+
+    void buildField(UnitComponent* unit);
+    void fillMovement(UnitComponent* unit, HoverPreview& preview);
+    void fillStrike(UnitComponent* unit, UnitComponent* target, HoverPreview& preview);
+};
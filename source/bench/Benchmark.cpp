@@ -0,0 +1,574 @@
+// Benchmark.cpp
+// Headless benchmark suite for the grid, fog of war, pathfinding, initiative and dice code.
+// Builds against the shim headers in bench/shim instead of the Unigine SDK (see bench/CMakeLists.txt).
+//
+// Usage:
+//   ProjectAnuBench [--sizes 32,64,128] [--units 8,32] [--iterations N] [--repeats N]
+//                   [--filter text] [--output results.json]
+//                   [--baseline baseline.json] [--tolerance 0.15]
+//
+// Results are written as JSON (one result object per line). With --baseline, each result is
+// compared against the stored ns_per_op and the run exits with 1 if any case is slower than
+// baseline * (1 + tolerance). Checksums are deterministic (seeded CombatRandom), so a checksum
+// mismatch means behaviour changed, not just speed.
+
+#include "../Grid/GridSystem.h"
+#include "../Grid/Pathfinding.h"
+#include "../Grid/FogOfWar.h"
+#include "../Core/TurnManager.h"
+#include "../Core/CombatRules.h"
+#include "../Core/CombatRandom.h"
+#include "../Core/Dice.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Arena.h"
+#include <UnigineLog.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+    const unsigned long long TERRAIN_SEED = 0x414e55ULL;
+    const int BLOCKED_PERCENT = 12;
+    const int UNIT_SPEED_FEET = 25;
+    const int FOG_SIGHT_CELLS = 12;
+    const int QUERIES_PER_ITERATION = 64;   // Cheap cases (cell queries, distance, dice) batch per iteration
+    const double DEFAULT_TOLERANCE = 0.15;
+
+    struct BenchConfig {
+        std::vector<int> sizes;
+        std::vector<int> units;
+        int iterations;
+        int repeats;
+        double tolerance;
+        std::string filter;
+        std::string output;
+        std::string baseline;
+
+        BenchConfig()
+            : sizes({32, 64, 128})
+            , units({8, 32})
+            , iterations(100)
+            , repeats(5)
+            , tolerance(DEFAULT_TOLERANCE)
+        {}
+    };
+
+    struct BenchResult {
+        std::string name;
+        int map;                    // Map edge in cells (0 = map independent)
+        int units;                  // Unit count (0 = unit independent)
+        long long ops;              // Operations per repeat
+        double ns_per_op;           // Median over repeats
+        unsigned long long checksum;
+
+        // Filled in by the baseline comparison
+        bool has_baseline;
+        double baseline_ns;
+        unsigned long long baseline_checksum;
+
+        BenchResult()
+            : map(0), units(0), ops(0), ns_per_op(0.0), checksum(0)
+            , has_baseline(false), baseline_ns(0.0), baseline_checksum(0)
+        {}
+    };
+
+    // One repeat: runs 'ops' operations, returns a checksum of the results
+    typedef std::function<unsigned long long(long long ops)> BenchBody;
+
+    // Seeded test map: scattered blocked cells, a few raised plateaus, units on free cells
+    struct BenchMap {
+        int size;
+        GridSystem* grid;
+        std::vector<unsigned char> blocked;
+        std::vector<int> elevation;
+        std::vector<GridPosition> unit_cells;
+        GridView view;
+
+        BenchMap(int _size, int num_units) : size(_size), grid(new GridSystem(_size, _size)) {
+            CombatRandom rng(TERRAIN_SEED + (unsigned long long)_size);
+
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    if (rng.rollDie(100) <= BLOCKED_PERCENT) grid->setBlocked(x, y, true);
+                }
+            }
+
+            const int plateaus = size / 8;
+            for (int i = 0; i < plateaus; i++) {
+                const int px = rng.rollDie(size) - 1;
+                const int py = rng.rollDie(size) - 1;
+                const int radius = rng.rollDie(4);
+                const int height = rng.rollDie(3);
+                for (int y = std::max(0, py - radius); y <= std::min(size - 1, py + radius); y++) {
+                    for (int x = std::max(0, px - radius); x <= std::min(size - 1, px + radius); x++) {
+                        grid->setElevation(x, y, height);
+                    }
+                }
+            }
+
+            int next_id = 1;
+            while ((int)unit_cells.size() < num_units) {
+                GridPosition pos(rng.rollDie(size) - 1, rng.rollDie(size) - 1);
+                if (grid->isBlocked(pos)) continue;
+                grid->setOccupant(pos, Unigine::NodePtr(new Unigine::Node(next_id++)));
+                unit_cells.push_back(pos);
+            }
+
+            // Flat arrays as GameManager builds them for the AI snapshot
+            blocked.resize(size * size);
+            elevation.resize(size * size);
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    const GridCell* cell = grid->getCell(x, y);
+                    blocked[y * size + x] = cell->blocked ? 1 : 0;
+                    elevation[y * size + x] = cell->elevation;
+                }
+            }
+
+            view.width = size;
+            view.height = size;
+            view.blocked = blocked.data();
+            view.elevation = elevation.data();
+        }
+
+        ~BenchMap() { delete grid; }
+
+        BenchMap(const BenchMap&) = delete;
+        BenchMap& operator=(const BenchMap&) = delete;
+    };
+
+    double runTimed(const BenchBody& body, long long ops, int repeats, unsigned long long& checksum) {
+        std::vector<double> samples;
+        for (int i = 0; i < repeats; i++) {
+            const auto start = std::chrono::steady_clock::now();
+            checksum = body(ops);
+            const auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / (double)ops);
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    class BenchRunner {
+    public:
+        explicit BenchRunner(const BenchConfig& _config) : config(_config) {}
+
+        void add(const char* name, int map, int units, long long ops, const BenchBody& body) {
+            if (!config.filter.empty() && strstr(name, config.filter.c_str()) == nullptr) return;
+
+            BenchResult result;
+            result.name = name;
+            result.map = map;
+            result.units = units;
+            result.ops = ops > 0 ? ops : 1;
+            result.ns_per_op = runTimed(body, result.ops, config.repeats, result.checksum);
+            results.push_back(result);
+
+            fprintf(stderr, "%-24s map %4d  units %4d  %12.1f ns/op\n", name, map, units, result.ns_per_op);
+        }
+
+        std::vector<BenchResult>& getResults() { return results; }
+
+    private:
+        const BenchConfig& config;
+        std::vector<BenchResult> results;
+    };
+
+    //==========================================================================
+    // Cases
+    //==========================================================================
+
+    void benchGrid(BenchRunner& runner, const BenchConfig& config, int size, int num_units) {
+        const int iterations = config.iterations;
+
+        if (num_units == config.units.front()) {
+            runner.add("grid_construct", size, 0, iterations, [size](long long ops) {
+                unsigned long long sum = 0;
+                for (long long i = 0; i < ops; i++) {
+                    GridSystem grid(size, size);
+                    sum += (unsigned long long)grid.getWidth() * grid.getHeight();
+                }
+                return sum;
+            });
+        }
+
+        BenchMap map(size, num_units);
+
+        // Query positions include out-of-range cells, as picking and AI probes do
+        std::vector<GridPosition> probes;
+        CombatRandom rng(TERRAIN_SEED ^ (unsigned long long)(size * 31 + num_units));
+        for (int i = 0; i < QUERIES_PER_ITERATION; i++) {
+            probes.push_back(GridPosition(rng.rollDie(size + 2) - 2, rng.rollDie(size + 2) - 2));
+        }
+
+        runner.add("grid_cell_queries", size, num_units, (long long)iterations * QUERIES_PER_ITERATION,
+            [&map, &probes](long long ops) {
+                unsigned long long sum = 0;
+                for (long long i = 0; i < ops; i++) {
+                    const GridPosition& pos = probes[i % probes.size()];
+                    if (!map.grid->isValidPosition(pos)) continue;
+                    const GridCell* cell = map.grid->getCell(pos);
+                    sum += cell->elevation + (map.grid->isBlocked(pos) ? 3 : 0) + (cell->isOccupied() ? 7 : 0);
+                }
+                return sum;
+            });
+
+        runner.add("grid_distance", size, num_units, (long long)iterations * QUERIES_PER_ITERATION,
+            [&map, &probes](long long ops) {
+                unsigned long long sum = 0;
+                const int count = (int)probes.size();
+                for (long long i = 0; i < ops; i++) {
+                    sum += map.grid->getDistance(probes[i % count], probes[(i * 7 + 3) % count]);
+                }
+                return sum;
+            });
+
+        // Stride reachability from every unit (AI lookahead, move previews)
+        runner.add("path_reachable", size, num_units, (long long)iterations,
+            [&map](long long ops) {
+                unsigned long long sum = 0;
+                Unigine::Vector<ReachableCell> cells;
+                for (long long i = 0; i < ops; i++) {
+                    const GridPosition& start = map.unit_cells[i % map.unit_cells.size()];
+                    Pathfinding::computeReachable(map.view, start, UNIT_SPEED_FEET * 2, cells);
+                    sum += cells.size();
+                }
+                return sum;
+            });
+
+        // Paths between unit pairs across the map
+        runner.add("path_find", size, num_units, (long long)iterations,
+            [&map](long long ops) {
+                unsigned long long sum = 0;
+                Unigine::Vector<GridPosition> path;
+                const int count = (int)map.unit_cells.size();
+                for (long long i = 0; i < ops; i++) {
+                    const GridPosition& start = map.unit_cells[i % count];
+                    const GridPosition& goal = map.unit_cells[(i + count / 2 + 1) % count];
+                    int cost = 0;
+                    if (Pathfinding::findPath(map.view, start, goal, path, &cost)) sum += cost + path.size();
+                }
+                return sum;
+            });
+
+        // One batch = a reachability search from every unit, spread over the job workers
+        JobSystem jobs;
+        Unigine::Vector<GridPosition> starts;
+        for (const GridPosition& pos : map.unit_cells) starts.append(pos);
+
+        runner.add("path_reachable_batch", size, num_units, (long long)iterations,
+            [&map, &jobs, &starts](long long ops) {
+                unsigned long long sum = 0;
+                Unigine::Vector<Unigine::Vector<ReachableCell>> results;
+                for (long long i = 0; i < ops; i++) {
+                    Pathfinding::computeReachableBatch(&jobs, map.view, starts, UNIT_SPEED_FEET * 2, results);
+                    for (int j = 0; j < results.size(); j++) sum += results[j].size();
+                }
+                return sum;
+            });
+
+        // Fog of war: every unit steps back and forth and its view is recounted (half the units per side)
+        runner.add("fog_moves", size, num_units, (long long)iterations * num_units,
+            [&map](long long ops) {
+                FogOfWar fog(map.grid, FOG_SIGHT_CELLS);
+                std::vector<GridPosition> cells = map.unit_cells;
+                const int count = (int)cells.size();
+                for (int i = 0; i < count; i++) fog.setViewer(i + 1, 1 + i % 2, cells[i]);
+
+                for (long long i = 0; i < ops; i++) {
+                    GridPosition& from = cells[i % count];
+                    GridPosition to(from.x + ((i / count) % 2 == 0 ? 1 : -1), from.y);
+                    if (!map.grid->isValidPosition(to)) continue;
+                    fog.onUnitMoved((int)(i % count) + 1, to);
+                    from = to;
+                }
+                map.grid->clearDirtyCells();
+                return (unsigned long long)fog.getCellUpdates();
+            });
+
+        // Units step back and forth between their cell and a free neighbour (occupancy + dirty tracking).
+        // Last, since it moves map.unit_cells.
+        runner.add("grid_occupancy", size, num_units, (long long)iterations * num_units,
+            [&map](long long ops) {
+                const int count = (int)map.unit_cells.size();
+                for (long long i = 0; i < ops; i++) {
+                    GridPosition& from = map.unit_cells[i % count];
+                    GridPosition to(from.x + ((i / count) % 2 == 0 ? 1 : -1), from.y);
+                    if (!map.grid->isValidPosition(to) || map.grid->isBlocked(to)) continue;
+                    Unigine::NodePtr unit = map.grid->getCell(from)->occupant;
+                    map.grid->clearOccupant(from);
+                    map.grid->setOccupant(to, unit);
+                    from = to;
+                }
+                map.grid->clearDirtyCells();
+                return (unsigned long long)map.grid->getVersion();
+            });
+    }
+
+    // TurnManager::rollInitiative + sortInitiativeOrder: roll per unit, then sort the encounter-arena order
+    void benchInitiative(BenchRunner& runner, const BenchConfig& config, int num_units) {
+        runner.add("turn_initiative", 0, num_units, (long long)config.iterations,
+            [num_units](long long ops) {
+                unsigned long long sum = 0;
+                CombatRandom rng(TERRAIN_SEED);
+                Arena encounter_arena("Encounter", 4096);
+                for (long long i = 0; i < ops; i++) {
+                    encounter_arena.reset();
+                    ArenaVector<InitiativeEntry> order{ArenaAllocator<InitiativeEntry>(&encounter_arena, MemorySystem::TURN)};
+                    order.reserve(num_units);
+                    for (int u = 0; u < num_units; u++) {
+                        InitiativeEntry entry;
+                        entry.is_player_unit = u % 2 == 0;
+                        entry.initiative_value = CombatRules::rollInitiative(rng, u % 7);
+                        order.push_back(entry);
+                    }
+                    CombatRules::sortInitiative(order);
+                    sum += order.front().initiative_value * 31 + order.back().initiative_value;
+                }
+                return sum;
+            });
+    }
+
+    void benchDice(BenchRunner& runner, const BenchConfig& config) {
+        static const char* const expressions[] = { "1d20", "2d6+3", "1d8+4", "3d6", "4d10-2", "12" };
+        const int num_expressions = (int)(sizeof(expressions) / sizeof(expressions[0]));
+        const long long ops = (long long)config.iterations * QUERIES_PER_ITERATION;
+
+        runner.add("dice_parse", 0, 0, ops, [num_expressions](long long count) {
+            unsigned long long sum = 0;
+            DiceExpr expr;
+            for (long long i = 0; i < count; i++) {
+                if (DiceExpr::parse(expressions[i % num_expressions], expr)) sum += expr.count * 100 + expr.sides + expr.bonus;
+            }
+            return sum;
+        });
+
+        runner.add("dice_roll", 0, 0, ops, [num_expressions](long long count) {
+            std::vector<DiceExpr> parsed(num_expressions);
+            for (int i = 0; i < num_expressions; i++) DiceExpr::parse(expressions[i], parsed[i]);
+
+            unsigned long long sum = 0;
+            CombatRandom rng(TERRAIN_SEED);
+            for (long long i = 0; i < count; i++) {
+                sum += parsed[i % num_expressions].roll(rng);
+            }
+            return sum;
+        });
+    }
+
+    //==========================================================================
+    // JSON output and baseline comparison
+    //==========================================================================
+
+    bool writeJson(const std::string& path, const BenchConfig& config, const std::vector<BenchResult>& results) {
+        FILE* file = path.empty() ? stdout : fopen(path.c_str(), "w");
+        if (!file) {
+            Unigine::Log::error("Benchmark::writeJson() - Cannot open '%s'\n", path.c_str());
+            return false;
+        }
+
+        fprintf(file, "{\n  \"suite\": \"ProjectAnuBench\",\n  \"iterations\": %d,\n  \"repeats\": %d,\n",
+                config.iterations, config.repeats);
+        fprintf(file, "  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            fprintf(file, "    {\"name\": \"%s\", \"map\": %d, \"units\": %d, \"ops\": %lld, \"ns_per_op\": %.3f, \"checksum\": %llu",
+                    r.name.c_str(), r.map, r.units, r.ops, r.ns_per_op, r.checksum);
+            if (r.has_baseline) {
+                fprintf(file, ", \"baseline_ns_per_op\": %.3f, \"ratio\": %.3f", r.baseline_ns, r.ns_per_op / r.baseline_ns);
+            }
+            fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+
+        if (file != stdout) fclose(file);
+        return true;
+    }
+
+    // Value following "key": on a line of our own output
+    bool findField(const char* line, const char* key, std::string& out) {
+        const std::string pattern = std::string("\"") + key + "\": ";
+        const char* p = strstr(line, pattern.c_str());
+        if (!p) return false;
+        p += pattern.size();
+
+        if (*p == '"') {
+            const char* end = strchr(p + 1, '"');
+            if (!end) return false;
+            out.assign(p + 1, end);
+        } else {
+            const char* end = p;
+            while (*end && *end != ',' && *end != '}') end++;
+            out.assign(p, end);
+        }
+        return true;
+    }
+
+    // Reads a file written by writeJson() (one result per line)
+    bool readBaseline(const std::string& path, std::vector<BenchResult>& out) {
+        FILE* file = fopen(path.c_str(), "r");
+        if (!file) {
+            Unigine::Log::error("Benchmark::readBaseline() - Cannot open '%s'\n", path.c_str());
+            return false;
+        }
+
+        char line[1024];
+        while (fgets(line, sizeof(line), file)) {
+            std::string name, map, units, ns, checksum;
+            if (!findField(line, "name", name) || !findField(line, "map", map) || !findField(line, "units", units) ||
+                !findField(line, "ns_per_op", ns)) {
+                continue;
+            }
+
+            BenchResult result;
+            result.name = name;
+            result.map = atoi(map.c_str());
+            result.units = atoi(units.c_str());
+            result.ns_per_op = atof(ns.c_str());
+            if (findField(line, "checksum", checksum)) result.checksum = strtoull(checksum.c_str(), nullptr, 10);
+            out.push_back(result);
+        }
+
+        fclose(file);
+        return true;
+    }
+
+    // Returns the number of regressions
+    int compareBaseline(std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline, double tolerance) {
+        int regressions = 0;
+        int changed = 0;
+
+        fprintf(stderr, "\n%-24s %5s %5s %12s %12s %8s\n", "case", "map", "units", "baseline", "current", "ratio");
+        for (BenchResult& r : results) {
+            const BenchResult* base = nullptr;
+            for (const BenchResult& b : baseline) {
+                if (b.name == r.name && b.map == r.map && b.units == r.units) {
+                    base = &b;
+                    break;
+                }
+            }
+            if (!base || base->ns_per_op <= 0.0) {
+                fprintf(stderr, "%-24s %5d %5d %12s %12.1f %8s\n", r.name.c_str(), r.map, r.units, "-", r.ns_per_op, "new");
+                continue;
+            }
+
+            r.has_baseline = true;
+            r.baseline_ns = base->ns_per_op;
+            r.baseline_checksum = base->checksum;
+
+            const double ratio = r.ns_per_op / base->ns_per_op;
+            const bool regressed = ratio > 1.0 + tolerance;
+            const bool checksum_changed = base->checksum != 0 && base->checksum != r.checksum;
+            if (regressed) regressions++;
+            if (checksum_changed) changed++;
+
+            fprintf(stderr, "%-24s %5d %5d %12.1f %12.1f %7.2fx%s%s\n", r.name.c_str(), r.map, r.units,
+                    base->ns_per_op, r.ns_per_op, ratio, regressed ? "  REGRESSION" : "",
+                    checksum_changed ? "  CHECKSUM CHANGED" : "");
+        }
+
+        fprintf(stderr, "\n%d regression(s) over %.0f%% tolerance, %d checksum change(s)\n",
+                regressions, tolerance * 100.0, changed);
+        return regressions;
+    }
+
+    //==========================================================================
+    // Command line
+    //==========================================================================
+
+    bool parseList(const char* text, std::vector<int>& out) {
+        out.clear();
+        const char* p = text;
+        while (*p) {
+            char* end = nullptr;
+            const long value = strtol(p, &end, 10);
+            if (end == p || value <= 0) return false;
+            out.push_back((int)value);
+            p = *end == ',' ? end + 1 : end;
+            if (*end && *end != ',') return false;
+        }
+        return !out.empty();
+    }
+
+    void printUsage() {
+        fprintf(stderr,
+            "Usage: ProjectAnuBench [--sizes 32,64,128] [--units 8,32] [--iterations N] [--repeats N]\n"
+            "                       [--filter text] [--output file.json]\n"
+            "                       [--baseline file.json] [--tolerance 0.15]\n");
+    }
+
+    bool parseArgs(int argc, char** argv, BenchConfig& config) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (!strcmp(arg, "--help") || !strcmp(arg, "-h")) return false;
+            if (!value) {
+                Unigine::Log::error("Benchmark::parseArgs() - Missing value for %s\n", arg);
+                return false;
+            }
+
+            bool ok = true;
+            if (!strcmp(arg, "--sizes")) ok = parseList(value, config.sizes);
+            else if (!strcmp(arg, "--units")) ok = parseList(value, config.units);
+            else if (!strcmp(arg, "--iterations")) ok = (config.iterations = atoi(value)) > 0;
+            else if (!strcmp(arg, "--repeats")) ok = (config.repeats = atoi(value)) > 0;
+            else if (!strcmp(arg, "--tolerance")) ok = (config.tolerance = atof(value)) >= 0.0;
+            else if (!strcmp(arg, "--filter")) config.filter = value;
+            else if (!strcmp(arg, "--output")) config.output = value;
+            else if (!strcmp(arg, "--baseline")) config.baseline = value;
+            else {
+                Unigine::Log::error("Benchmark::parseArgs() - Unknown option %s\n", arg);
+                return false;
+            }
+
+            if (!ok) {
+                Unigine::Log::error("Benchmark::parseArgs() - Invalid value '%s' for %s\n", value, arg);
+                return false;
+            }
+            i++;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        printUsage();
+        return 2;
+    }
+
+    // Grid construction logs per instance; keep timing output clean
+    Unigine::Log::quiet() = true;
+
+    BenchRunner runner(config);
+    for (int size : config.sizes) {
+        for (int units : config.units) {
+            // Units need free cells; skip combinations that cannot fit
+            if (units > size * size / 2) continue;
+            benchGrid(runner, config, size, units);
+        }
+    }
+    for (int units : config.units) {
+        benchInitiative(runner, config, units);
+    }
+    benchDice(runner, config);
+
+    std::vector<BenchResult>& results = runner.getResults();
+
+    int regressions = 0;
+    if (!config.baseline.empty()) {
+        std::vector<BenchResult> baseline;
+        if (!readBaseline(config.baseline, baseline)) return 2;
+        regressions = compareBaseline(results, baseline, config.tolerance);
+    }
+
+    if (!writeJson(config.output, config, results)) return 2;
+    return regressions > 0 ? 1 : 0;
+}
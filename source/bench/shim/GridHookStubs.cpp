@@ -0,0 +1,13 @@
+// GridHookStubs.cpp (benchmark shim)
+// GridSystem calls into a CombatHistory and an AuraTracker only when one is attached. Benchmarks
+// never attach either, so the real ones (which need units and the world) are replaced by these
+// empty definitions.
+
+#include "../../Core/CombatHistory.h"
+#include "../../Spells/AuraTracker.h"
+
+void CombatHistory::record(DeltaType, int, int, int) {
+}
+
+void AuraTracker::onUnitMoved(int, GridPosition) {
+}
@@ -0,0 +1,19 @@
+// UnigineConsole.h (benchmark shim)
+// No console headlessly: commands are accepted and ignored
+
+#pragma once
+
+namespace Unigine {
+
+struct CallbackBase {};
+
+template <class Class, class Method>
+CallbackBase* MakeCallback(Class*, Method) { return nullptr; }
+
+class Console {
+public:
+    static void addCommand(const char*, const char*, CallbackBase*) {}
+    static void removeCommand(const char*) {}
+};
+
+}
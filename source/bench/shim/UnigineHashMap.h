@@ -0,0 +1,53 @@
+// UnigineHashMap.h (benchmark shim)
+// Headless stand-in for Unigine::HashMap backed by std::unordered_map. Iterators expose
+// 'key' and 'data' like the engine's; only the members the benchmarked sources use are provided.
+
+#pragma once
+
+#include <unordered_map>
+
+namespace Unigine {
+
+template <class Key, class Data>
+class HashMap {
+    typedef std::unordered_map<Key, Data> Map;
+
+public:
+    template <class MapIterator>
+    class IteratorBase {
+    public:
+        struct Entry {
+            const Key& key;
+            Data& data;
+            const Entry* operator->() const { return this; }
+        };
+
+        IteratorBase(MapIterator it) : it(it) {}
+        Entry operator->() const { return Entry{ it->first, const_cast<Data&>(it->second) }; }
+        IteratorBase& operator++() { ++it; return *this; }
+        bool operator==(const IteratorBase& other) const { return it == other.it; }
+        bool operator!=(const IteratorBase& other) const { return it != other.it; }
+
+    private:
+        MapIterator it;
+    };
+
+    typedef IteratorBase<typename Map::iterator> Iterator;
+    typedef IteratorBase<typename Map::const_iterator> ConstIterator;
+
+    Data& operator[](const Key& key) { return map[key]; }
+    void append(const Key& key, const Data& data) { map[key] = data; }
+    void remove(const Key& key) { map.erase(key); }
+    void clear() { map.clear(); }
+    int size() const { return (int)map.size(); }
+
+    Iterator find(const Key& key) { return Iterator(map.find(key)); }
+    ConstIterator find(const Key& key) const { return ConstIterator(map.find(key)); }
+    Iterator end() { return Iterator(map.end()); }
+    ConstIterator end() const { return ConstIterator(map.end()); }
+
+private:
+    Map map;
+};
+
+}
@@ -0,0 +1,13 @@
+// UnigineJson.h (benchmark shim)
+// Declaration only: spell headers pulled in by the grid hooks name JsonPtr but nothing here parses
+
+#pragma once
+
+#include "UniginePtr.h"
+
+namespace Unigine {
+
+class Json;
+using JsonPtr = Ptr<Json>;
+
+}
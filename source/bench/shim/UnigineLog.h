@@ -0,0 +1,40 @@
+// UnigineLog.h (benchmark shim)
+// Engine log to stderr; benchmarks silence messages while timing
+
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace Unigine {
+
+class Log {
+public:
+    static bool& quiet() { static bool value = false; return value; }
+
+    static void message(const char* format, ...) {
+        if (quiet()) return;
+        va_list args;
+        va_start(args, format);
+        vfprintf(stderr, format, args);
+        va_end(args);
+    }
+
+    static void warning(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        fputs("warning: ", stderr);
+        vfprintf(stderr, format, args);
+        va_end(args);
+    }
+
+    static void error(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        fputs("error: ", stderr);
+        vfprintf(stderr, format, args);
+        va_end(args);
+    }
+};
+
+}
@@ -0,0 +1,21 @@
+// UnigineNode.h (benchmark shim)
+// Nodes only carry an ID headlessly (grid occupancy compares pointers and reads IDs)
+
+#pragma once
+
+#include "UniginePtr.h"
+
+namespace Unigine {
+
+class Node {
+public:
+    explicit Node(int _id) : id(_id) {}
+    int getID() const { return id; }
+
+private:
+    int id;
+};
+
+typedef Ptr<Node> NodePtr;
+
+}
@@ -0,0 +1,33 @@
+// UniginePtr.h (benchmark shim)
+// Reference-counted pointer with the Unigine::Ptr surface used by the grid code
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace Unigine {
+
+template <class Type>
+class Ptr {
+public:
+    Ptr() {}
+    Ptr(std::nullptr_t) {}
+    explicit Ptr(Type* object) : pointer(object) {}
+
+    Type* operator->() const { return pointer.get(); }
+    Type* get() const { return pointer.get(); }
+    explicit operator bool() const { return pointer != nullptr; }
+
+    bool operator==(const Ptr& other) const { return pointer == other.pointer; }
+    bool operator!=(const Ptr& other) const { return pointer != other.pointer; }
+    bool operator==(std::nullptr_t) const { return pointer == nullptr; }
+    bool operator!=(std::nullptr_t) const { return pointer != nullptr; }
+
+    void clear() { pointer.reset(); }
+
+private:
+    std::shared_ptr<Type> pointer;
+};
+
+}
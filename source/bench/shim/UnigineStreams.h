@@ -0,0 +1,40 @@
+// UnigineStreams.h (benchmark shim)
+// File over stdio (PerfMonitor CSV export)
+
+#pragma once
+
+#include "UniginePtr.h"
+#include <cstdio>
+
+namespace Unigine {
+
+class File {
+public:
+    File() : handle(nullptr) {}
+    ~File() { close(); }
+
+    static Ptr<File> create() { return Ptr<File>(new File()); }
+
+    int open(const char* path, const char* mode) {
+        close();
+        handle = fopen(path, mode);
+        return handle != nullptr;
+    }
+
+    int close() {
+        if (!handle) return 0;
+        fclose(handle);
+        handle = nullptr;
+        return 1;
+    }
+
+    int puts(const char* text) { return handle && fputs(text, handle) >= 0; }
+    int flush() { return handle && fflush(handle) == 0; }
+
+private:
+    FILE* handle;
+};
+
+typedef Ptr<File> FilePtr;
+
+}
@@ -0,0 +1,35 @@
+// UnigineString.h (benchmark shim)
+
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+namespace Unigine {
+
+class String {
+public:
+    String() {}
+    String(const char* text) : value(text ? text : "") {}
+
+    const char* get() const { return value.c_str(); }
+    int size() const { return (int)value.size(); }
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+
+    static String format(const char* format, ...) {
+        char buffer[1024];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        return String(buffer);
+    }
+
+private:
+    std::string value;
+};
+
+}
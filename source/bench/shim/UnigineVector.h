@@ -0,0 +1,45 @@
+// UnigineVector.h (benchmark shim)
+// Headless stand-in for Unigine::Vector backed by std::vector. Only the members the
+// benchmarked sources use are provided.
+
+#pragma once
+
+#include <vector>
+
+namespace Unigine {
+
+template <class Type>
+class Vector {
+public:
+    Vector() {}
+
+    int size() const { return (int)data.size(); }
+    bool empty() const { return data.empty(); }
+
+    Type& operator[](int index) { return data[index]; }
+    const Type& operator[](int index) const { return data[index]; }
+    Type* get() { return data.data(); }
+    const Type* get() const { return data.data(); }
+    Type& last() { return data.back(); }
+    const Type& last() const { return data.back(); }
+
+    void append(const Type& value) { data.push_back(value); }
+    void append(const Vector& other) { data.insert(data.end(), other.data.begin(), other.data.end()); }
+    void insert(int index, const Type& value) { data.insert(data.begin() + index, value); }
+    void remove(int index) { data.erase(data.begin() + index); }
+    void removeFast(int index) { data[index] = data.back(); data.pop_back(); }
+
+    void resize(int new_size) { data.resize(new_size); }
+    void reserve(int capacity) { data.reserve(capacity); }
+    void clear() { data.clear(); }      // Keeps capacity, like Unigine::Vector
+
+    typename std::vector<Type>::iterator begin() { return data.begin(); }
+    typename std::vector<Type>::iterator end() { return data.end(); }
+    typename std::vector<Type>::const_iterator begin() const { return data.begin(); }
+    typename std::vector<Type>::const_iterator end() const { return data.end(); }
+
+private:
+    std::vector<Type> data;
+};
+
+}